@@ -123,6 +123,211 @@ macro(LibTarget TARGET_NAME)
     )
 endmacro()
 
+# Generates a minimal perfect hash of the channels of a manifest for the
+# loggingf_wrapper library.
+#
+# ChannelManifest(_name
+#   MANIFEST    <manifest_file>     # one channel name per line, '#' starts a
+#                                   # comment
+# )
+#
+# MANIFEST - the file relative to the current source directory. Channel names
+#   consist of the characters [A-Za-z0-9_.:/-].
+#
+# Writes '<_name>.h' with the constant ids of the channels and '<_name>.c' with
+# the tables of the hash into the current binary directory, and sets
+# '<_name>_SOURCES' and '<_name>_INCLUDE_DIR' in the calling scope. The hash
+# is computed by 'lw_manifest_slot' of 'loggingf_wrapper/manifest.h': the
+# FNV-1a hash of a name selects one of n/2 buckets, and the displacement of
+# the bucket is searched so that the names of the bucket fall into free slots.
+function(ChannelManifest NAME)
+    set(_flags_kw   )
+    set(_values_kw  MANIFEST)
+    set(_lists_kw   )
+    _parse_target_args(${NAME}
+        _flags_kw _values_kw _lists_kw ${ARGN}
+    )
+
+    get_filename_component(_manifest "${${NAME}_MANIFEST}" ABSOLUTE)
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${_manifest}")
+    file(STRINGS "${_manifest}" _lines)
+
+    string(TOUPPER "${NAME}" _prefix)
+    string(MAKE_C_IDENTIFIER "${_prefix}" _prefix)
+    set(_names "")
+    set(_hashes "")
+    foreach (_line IN LISTS _lines)
+        string(REGEX REPLACE "#.*$" "" _line "${_line}")
+        string(STRIP "${_line}" _line)
+        if (_line STREQUAL "")
+            continue()
+        endif()
+        if (NOT _line MATCHES "^[A-Za-z0-9_.:/-]+$")
+            message(FATAL_ERROR "[ERROR] ${_manifest}: invalid channel name '${_line}'")
+        endif()
+        if (_line IN_LIST _names)
+            message(FATAL_ERROR "[ERROR] ${_manifest}: duplicate channel name '${_line}'")
+        endif()
+        string(TOUPPER "${_line}" _id)
+        string(MAKE_C_IDENTIFIER "${_prefix}_${_id}" _id)
+        if (DEFINED _name_of_${_id})
+            message(FATAL_ERROR "[ERROR] ${_manifest}: channels '${_name_of_${_id}}' and '${_line}' have the same id")
+        endif()
+        set(_name_of_${_id} "${_line}")
+
+        # 32-bit FNV-1a (see lw_manifest_hash).
+        string(HEX "${_line}" _hex)
+        string(LENGTH "${_hex}" _hex_len)
+        set(_hash 2166136261)
+        foreach (_pos RANGE 0 ${_hex_len} 2)
+            if (_pos LESS _hex_len)
+                string(SUBSTRING "${_hex}" ${_pos} 2 _byte)
+                math(EXPR _hash "((${_hash} ^ 0x${_byte}) * 16777619) & 0xFFFFFFFF")
+            endif()
+        endforeach()
+        if (_hash IN_LIST _hashes)
+            message(FATAL_ERROR "[ERROR] ${_manifest}: hash collision of the channel '${_line}', rename it")
+        endif()
+        list(APPEND _names "${_line}")
+        list(APPEND _hashes ${_hash})
+    endforeach()
+
+    list(LENGTH _names _count)
+    if (_count EQUAL 0)
+        message(FATAL_ERROR "[ERROR] ${_manifest}: no channels")
+    endif()
+    math(EXPR _bucket_count "(${_count} + 1) / 2")
+    math(EXPR _last "${_count} - 1")
+    math(EXPR _last_bucket "${_bucket_count} - 1")
+
+    set(_max_size 0)
+    foreach (_key RANGE ${_last})
+        list(GET _hashes ${_key} _hash)
+        math(EXPR _bucket "${_hash} % ${_bucket_count}")
+        list(APPEND _bucket_${_bucket} ${_key})
+        list(LENGTH _bucket_${_bucket} _size)
+        if (_size GREATER _max_size)
+            set(_max_size ${_size})
+        endif()
+    endforeach()
+
+    # Larger buckets are placed first, while most of the slots are free.
+    foreach (_size RANGE ${_max_size} 1 -1)
+        foreach (_bucket RANGE ${_last_bucket})
+            list(LENGTH _bucket_${_bucket} _bucket_size)
+            if (NOT _bucket_size EQUAL _size)
+                continue()
+            endif()
+            set(_disp 0)
+            while (TRUE)
+                set(_is_free TRUE)
+                set(_slots "")
+                foreach (_key IN LISTS _bucket_${_bucket})
+                    list(GET _hashes ${_key} _hash)
+                    math(EXPR _x "${_hash} ^ ((${_disp} * 0x9E3779B1) & 0xFFFFFFFF)")
+                    math(EXPR _x "((${_x} ^ (${_x} >> 16)) * 0x045D9F3B) & 0xFFFFFFFF")
+                    math(EXPR _x "((${_x} ^ (${_x} >> 16)) * 0x045D9F3B) & 0xFFFFFFFF")
+                    math(EXPR _slot "(${_x} ^ (${_x} >> 16)) % ${_count}")
+                    if (DEFINED _key_of_${_slot} OR _slot IN_LIST _slots)
+                        set(_is_free FALSE)
+                        break()
+                    endif()
+                    list(APPEND _slots ${_slot})
+                endforeach()
+                if (_is_free)
+                    break()
+                endif()
+                math(EXPR _disp "${_disp} + 1")
+                if (_disp GREATER 1048576)
+                    message(FATAL_ERROR "[ERROR] ${_manifest}: no perfect hash is found")
+                endif()
+            endwhile()
+            set(_disp_${_bucket} ${_disp})
+            foreach (_key _slot IN ZIP_LISTS _bucket_${_bucket} _slots)
+                set(_key_of_${_slot} ${_key})
+                set(_slot_of_${_key} ${_slot})
+            endforeach()
+        endforeach()
+    endforeach()
+
+    set(_ids "")
+    foreach (_key RANGE ${_last})
+        list(GET _names ${_key} _name)
+        string(TOUPPER "${_name}" _id)
+        string(MAKE_C_IDENTIFIER "${_prefix}_${_id}" _id)
+        string(APPEND _ids "    ${_id} = ${_slot_of_${_key}}, /**< \"${_name}\" */\n")
+    endforeach()
+    set(_table_names "")
+    foreach (_slot RANGE ${_last})
+        list(GET _names ${_key_of_${_slot}} _name)
+        string(APPEND _table_names "    \"${_name}\",\n")
+    endforeach()
+    set(_displacements "")
+    foreach (_bucket RANGE ${_last_bucket})
+        if (NOT DEFINED _disp_${_bucket})
+            set(_disp_${_bucket} 0)
+        endif()
+        string(APPEND _displacements "    ${_disp_${_bucket}}u,\n")
+    endforeach()
+
+    file(RELATIVE_PATH _manifest_rel "${PROJECT_SOURCE_DIR}" "${_manifest}")
+    file(CONFIGURE OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/${NAME}.h" CONTENT
+"/**
+ *  \\file
+ *  \\brief  Channel ids of the manifest '${_manifest_rel}'.
+ *
+ *  \\details    Generated by the ChannelManifest CMake helper, do not edit.
+ */
+
+#ifndef _${_prefix}_H_
+#define _${_prefix}_H_
+
+#include \"loggingf_wrapper/manifest.h\"
+
+#if defined(__cplusplus)
+extern \"C\" {
+#endif
+
+/** Ids of the channels (see lw_get_manifest_logger). */
+enum ${NAME}_id
+{
+${_ids}    ${_prefix}_COUNT = ${_count} /**< Number of channels. */
+};
+
+/** Tables of the manifest (see lw_register_channel_manifest). */
+extern const lw_channel_manifest_t ${NAME};
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _${_prefix}_H_ */
+" @ONLY)
+    file(CONFIGURE OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/${NAME}.c" CONTENT
+"/*
+ * Tables of the manifest '${_manifest_rel}'.
+ * Generated by the ChannelManifest CMake helper, do not edit.
+ */
+
+#include \"${NAME}.h\"
+
+static const uint32_t g_displacements[] = {
+${_displacements}};
+
+static const char* const g_names[] = {
+${_table_names}};
+
+const lw_channel_manifest_t ${NAME} = {${_count}, ${_bucket_count}, g_displacements, g_names};
+" @ONLY)
+
+    set(${NAME}_SOURCES
+        "${CMAKE_CURRENT_BINARY_DIR}/${NAME}.h"
+        "${CMAKE_CURRENT_BINARY_DIR}/${NAME}.c"
+        PARENT_SCOPE
+    )
+    set(${NAME}_INCLUDE_DIR "${CMAKE_CURRENT_BINARY_DIR}" PARENT_SCOPE)
+endfunction()
+
 # Defines a target for building execution with all dependencies.
 #
 # ExecTarget(_target_name
@@ -0,0 +1,310 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \ingroup logging_wrapper_module
+ */
+
+#include "logging_wrapper/details/escape.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <immintrin.h>
+    #define LW_ESCAPE_X86       1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define LW_ESCAPE_NEON      1
+#endif
+
+namespace wstux {
+namespace logging {
+namespace details {
+namespace {
+
+/// \brief  Returns true if the character must be escaped in a JSON string.
+inline bool is_json_special(unsigned char c)
+{
+    return (c < 0x20) || (c == '"') || (c == '\\');
+}
+
+/// \brief  Returns true if the character requires a quoted logfmt value.
+inline bool is_logfmt_special(unsigned char c)
+{
+    return (c <= ' ') || (c == '=') || (c == '"') || (c == '\\') || (c == 0x7F);
+}
+
+/// \brief  Returns the offset of the first character of the predicate.
+template<bool (*TPredicate)(unsigned char)>
+size_t find_scalar(const char* p_str, size_t size, size_t pos)
+{
+    for (; pos < size; ++pos) {
+        if (TPredicate((unsigned char)p_str[pos])) {
+            return pos;
+        }
+    }
+    return size;
+}
+
+using find_fn_t = size_t (*)(const char*, size_t);
+
+#if defined(LW_ESCAPE_X86)
+
+#if defined(__SSE2__) || defined(__x86_64__)
+    #define LW_ESCAPE_SSE2      1
+#endif
+
+#if defined(LW_ESCAPE_SSE2)
+
+/// \brief  Returns the mask of the bytes of a block, which must be escaped in JSON.
+inline unsigned json_mask_sse2(__m128i v)
+{
+    // Unsigned v <= 0x1F if max(v, 0x1F) == 0x1F.
+    const __m128i ctrl = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F));
+    const __m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+    const __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    return (unsigned)_mm_movemask_epi8(_mm_or_si128(ctrl, _mm_or_si128(quote, slash)));
+}
+
+/// \brief  Returns the mask of the bytes of a block, which require logfmt quotes.
+inline unsigned logfmt_mask_sse2(__m128i v)
+{
+    const __m128i ctrl = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(' ')), _mm_set1_epi8(' '));
+    const __m128i eq = _mm_cmpeq_epi8(v, _mm_set1_epi8('='));
+    const __m128i quote = _mm_cmpeq_epi8(v, _mm_set1_epi8('"'));
+    const __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    const __m128i del = _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7F));
+    return (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(ctrl, eq), _mm_or_si128(_mm_or_si128(quote, slash), del)));
+}
+
+size_t find_json_sse2(const char* p_str, size_t size)
+{
+    size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        const unsigned mask = json_mask_sse2(_mm_loadu_si128((const __m128i*)(p_str + pos)));
+        if (mask != 0) {
+            return pos + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return find_scalar<is_json_special>(p_str, size, pos);
+}
+
+size_t find_logfmt_sse2(const char* p_str, size_t size)
+{
+    size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        const unsigned mask = logfmt_mask_sse2(_mm_loadu_si128((const __m128i*)(p_str + pos)));
+        if (mask != 0) {
+            return pos + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return find_scalar<is_logfmt_special>(p_str, size, pos);
+}
+
+#endif // LW_ESCAPE_SSE2
+
+__attribute__((target("avx2"))) size_t find_json_avx2(const char* p_str, size_t size)
+{
+    size_t pos = 0;
+    const __m256i lim = _mm256_set1_epi8(0x1F);
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i slash = _mm256_set1_epi8('\\');
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(p_str + pos));
+        const __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(v, lim), lim),
+                                                _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                                                                _mm256_cmpeq_epi8(v, slash)));
+        const unsigned mask = (unsigned)_mm256_movemask_epi8(special);
+        if (mask != 0) {
+            return pos + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return find_scalar<is_json_special>(p_str, size, pos);
+}
+
+__attribute__((target("avx2"))) size_t find_logfmt_avx2(const char* p_str, size_t size)
+{
+    size_t pos = 0;
+    const __m256i lim = _mm256_set1_epi8(' ');
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i*)(p_str + pos));
+        const __m256i ctrl = _mm256_cmpeq_epi8(_mm256_max_epu8(v, lim), lim);
+        const __m256i eq = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('='));
+        const __m256i quote = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'));
+        const __m256i slash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+        const __m256i del = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7F));
+        const __m256i special = _mm256_or_si256(_mm256_or_si256(ctrl, eq),
+                                                _mm256_or_si256(_mm256_or_si256(quote, slash), del));
+        const unsigned mask = (unsigned)_mm256_movemask_epi8(special);
+        if (mask != 0) {
+            return pos + (size_t)__builtin_ctz(mask);
+        }
+    }
+    return find_scalar<is_logfmt_special>(p_str, size, pos);
+}
+
+#elif defined(LW_ESCAPE_NEON)
+
+/// \brief  Returns the offset of the first set byte of a comparison result.
+inline size_t first_set_neon(uint8x16_t special)
+{
+    // Narrow every byte to 4 bits of a 64-bit mask.
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(special), 4);
+    const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+    return (size_t)__builtin_ctzll(mask) / 4;
+}
+
+size_t find_json_neon(const char* p_str, size_t size)
+{
+    size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        const uint8x16_t v = vld1q_u8((const uint8_t*)(p_str + pos));
+        const uint8x16_t special = vorrq_u8(vcleq_u8(v, vdupq_n_u8(0x1F)),
+                                            vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')), vceqq_u8(v, vdupq_n_u8('\\'))));
+        if (vmaxvq_u8(special) != 0) {
+            return pos + first_set_neon(special);
+        }
+    }
+    return find_scalar<is_json_special>(p_str, size, pos);
+}
+
+size_t find_logfmt_neon(const char* p_str, size_t size)
+{
+    size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        const uint8x16_t v = vld1q_u8((const uint8_t*)(p_str + pos));
+        const uint8x16_t special =
+            vorrq_u8(vorrq_u8(vcleq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8('='))),
+                     vorrq_u8(vorrq_u8(vceqq_u8(v, vdupq_n_u8('"')), vceqq_u8(v, vdupq_n_u8('\\'))),
+                              vceqq_u8(v, vdupq_n_u8(0x7F))));
+        if (vmaxvq_u8(special) != 0) {
+            return pos + first_set_neon(special);
+        }
+    }
+    return find_scalar<is_logfmt_special>(p_str, size, pos);
+}
+
+#endif
+
+/// \brief  Implementation of the scans.
+struct escape_impl final
+{
+    const char* p_name;     ///< Name of the implementation.
+    find_fn_t find_json;    ///< Scan of the JSON special characters.
+    find_fn_t find_logfmt;  ///< Scan of the logfmt special characters.
+};
+
+size_t find_json_scalar(const char* p_str, size_t size) { return find_scalar<is_json_special>(p_str, size, 0); }
+size_t find_logfmt_scalar(const char* p_str, size_t size) { return find_scalar<is_logfmt_special>(p_str, size, 0); }
+
+/// \brief  Selects the best implementation supported by the CPU.
+escape_impl select_impl()
+{
+#if defined(LW_ESCAPE_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return escape_impl{"avx2", find_json_avx2, find_logfmt_avx2};
+    }
+#if defined(LW_ESCAPE_SSE2)
+    return escape_impl{"sse2", find_json_sse2, find_logfmt_sse2};
+#endif
+#elif defined(LW_ESCAPE_NEON)
+    return escape_impl{"neon", find_json_neon, find_logfmt_neon};
+#endif
+    return escape_impl{"scalar", find_json_scalar, find_logfmt_scalar};
+}
+
+/// \brief  Returns the selected implementation.
+const escape_impl& impl()
+{
+    static const escape_impl s_impl = select_impl();
+    return s_impl;
+}
+
+/// \brief  Writes the escape sequence of a JSON special character.
+inline void put_escape(text_buffer& out, unsigned char c)
+{
+    switch (c) {
+    case '"':   out.append("\\\"", 2); return;
+    case '\\':  out.append("\\\\", 2); return;
+    case '\n':  out.append("\\n", 2); return;
+    case '\r':  out.append("\\r", 2); return;
+    case '\t':  out.append("\\t", 2); return;
+    case '\b':  out.append("\\b", 2); return;
+    case '\f':  out.append("\\f", 2); return;
+    default:    break;
+    }
+    const char u[6] = {'\\', 'u', '0', '0', "0123456789abcdef"[c >> 4], "0123456789abcdef"[c & 0xF]};
+    out.append(u, sizeof(u));
+}
+
+/// \brief  Writes a string escaped by the scan of the JSON special characters.
+inline void escape_with(text_buffer& out, std::string_view str, find_fn_t find)
+{
+    const char* p_cur = str.data();
+    size_t left = str.size();
+    while (left != 0) {
+        const size_t clean = find(p_cur, left);
+        out.append(p_cur, clean);
+        if (clean == left) {
+            return;
+        }
+        put_escape(out, (unsigned char)p_cur[clean]);
+        p_cur += clean + 1;
+        left -= clean + 1;
+    }
+}
+
+} // <anonymous> namespace
+
+size_t find_json_special(const char* p_str, size_t size) noexcept
+{
+    return impl().find_json(p_str, size);
+}
+
+size_t find_json_special_scalar(const char* p_str, size_t size) noexcept
+{
+    return find_json_scalar(p_str, size);
+}
+
+bool needs_logfmt_quotes(std::string_view str) noexcept
+{
+    return str.empty() || (impl().find_logfmt(str.data(), str.size()) != str.size());
+}
+
+bool needs_logfmt_quotes_scalar(std::string_view str) noexcept
+{
+    return str.empty() || (find_logfmt_scalar(str.data(), str.size()) != str.size());
+}
+
+const char* escape_impl_name() noexcept
+{
+    return impl().p_name;
+}
+
+void put_escaped(text_buffer& out, std::string_view str) noexcept
+{
+    escape_with(out, str, impl().find_json);
+}
+
+void put_escaped_scalar(text_buffer& out, std::string_view str) noexcept
+{
+    escape_with(out, str, find_json_scalar);
+}
+
+} // namespace details
+} // namespace logging
+} // namespace wstux
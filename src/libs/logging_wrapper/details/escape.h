@@ -0,0 +1,86 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Internal escaping of strings of the JSON and logfmt renderers.
+ *  \ingroup logging_wrapper_module
+ *
+ *  \details    The scans look for the characters, which need an escape or
+ *      quotes, 32 bytes at a time with AVX2 (if the CPU supports it), 16 bytes
+ *      at a time with SSE2 or NEON, and byte by byte otherwise. The clean
+ *      spans between such characters are copied at once. The implementation
+ *      is selected once, on the first call.
+ */
+
+#ifndef _LIBS_LOGGING_WRAPPER_DETAILS_ESCAPE_H_
+#define _LIBS_LOGGING_WRAPPER_DETAILS_ESCAPE_H_
+
+#include <cstddef>
+#include <string_view>
+
+#include "logging_wrapper/format.h"
+
+namespace wstux {
+namespace logging {
+namespace details {
+
+/**
+ *  \brief  Returns the offset of the first character, which must be escaped
+ *      in a JSON string (`"`, `\` or a control character below `0x20`), or
+ *      `size` if there is none.
+ */
+size_t find_json_special(const char* p_str, size_t size) noexcept;
+
+/**
+ *  \brief  Byte-by-byte reference of \ref find_json_special.
+ */
+size_t find_json_special_scalar(const char* p_str, size_t size) noexcept;
+
+/**
+ *  \brief  Returns true if a logfmt value must be quoted: it is empty or
+ *      contains a space, a control character, `=`, `"`, `\` or `DEL`.
+ */
+bool needs_logfmt_quotes(std::string_view str) noexcept;
+
+/**
+ *  \brief  Byte-by-byte reference of \ref needs_logfmt_quotes.
+ */
+bool needs_logfmt_quotes_scalar(std::string_view str) noexcept;
+
+/**
+ *  \brief  Returns the name of the selected implementation of the scans:
+ *      `"avx2"`, `"sse2"`, `"neon"` or `"scalar"`.
+ */
+const char* escape_impl_name() noexcept;
+
+/**
+ *  \brief  Writes the contents of a JSON string (without the quotes), which
+ *      is also the contents of a quoted logfmt value.
+ */
+void put_escaped(text_buffer& out, std::string_view str) noexcept;
+
+/**
+ *  \brief  Byte-by-byte reference of \ref put_escaped.
+ */
+void put_escaped_scalar(text_buffer& out, std::string_view str) noexcept;
+
+} // namespace details
+} // namespace logging
+} // namespace wstux
+
+#endif /* _LIBS_LOGGING_WRAPPER_DETAILS_ESCAPE_H_ */
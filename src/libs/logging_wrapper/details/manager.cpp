@@ -20,9 +20,11 @@
  *  \ingroup logging_wrapper_module
  */
 
+#include <sys/syscall.h>
 #include <sys/time.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "logging_wrapper/manager.h"
 
@@ -31,53 +33,508 @@
 
 namespace wstux {
 namespace logging {
+namespace {
+
+/// \brief  Level tags of the `%l` field by severity level.
+const char* const g_level_tags[] = {
+    LOG_LEVEL(0), LOG_LEVEL(1), LOG_LEVEL(2), LOG_LEVEL(3), LOG_LEVEL(4),
+    LOG_LEVEL(5), LOG_LEVEL(6), LOG_LEVEL(7), LOG_LEVEL(8)
+};
+
+/// \brief  Level names of the `%L` field by severity level.
+const char* const g_level_names[] = {
+    "EMERG", "FATAL", "CRIT", "ERROR", "WARN", "NOTICE", "INFO", "DEBUG", "TRACE"
+};
+
+/// \brief  Maximum width of the channel field.
+constexpr unsigned max_channel_width = 256;
+
+/// \brief  Date and time of the last second formatted by the thread.
+struct ts_cache final
+{
+    time_t sec = -1;    ///< Second of the cached text.
+    char text[19];      ///< Text in the `YYYY-MM-DD HH:MM:SS` format.
+};
+
+thread_local ts_cache tl_ts_cache;
+
+/// \brief  Decimal thread id of the thread.
+struct tid_cache final
+{
+    size_t size = 0;    ///< Length of the text, 0 until formatted.
+    char text[24];      ///< Thread id.
+};
+
+thread_local tid_cache tl_tid_cache;
+
+/// \brief  Writes an unsigned number of exactly `width` digits.
+inline void put_digits(char* p_buf, unsigned long value, size_t width)
+{
+    for (size_t i = width; i > 0; --i) {
+        p_buf[i - 1] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/// \brief  Writes an unsigned number and returns the number of digits.
+inline size_t put_number(char* p_buf, unsigned long value)
+{
+    char digits[24];
+    size_t size = 0;
+    do {
+        digits[sizeof(digits) - ++size] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    memcpy(p_buf, digits + sizeof(digits) - size, size);
+    return size;
+}
+
+/**
+ *  \brief  Writes the timestamp of the `%T` field.
+ *  \param  p_buf - buffer of at least 29 characters.
+ *  \param  precision - number of fractional digits.
+ *  \return Length of the timestamp, which depends only on the precision.
+ */
+size_t put_timestamp(char* p_buf, unsigned precision)
+{
+    struct timespec cur_ts;
+    if (clock_gettime(CLOCK_REALTIME, &cur_ts) != 0) {
+        cur_ts.tv_sec = 0;
+        cur_ts.tv_nsec = 0;
+    }
+
+    ts_cache& cache = tl_ts_cache;
+    if (cache.sec != cur_ts.tv_sec) {
+        struct tm cur_tm;
+        if (localtime_r(&cur_ts.tv_sec, &cur_tm) == NULL) {
+            memcpy(cache.text, "yyyy-MM-dd hh:mm:ss", sizeof(cache.text));
+        } else {
+            put_digits(cache.text, (unsigned long)cur_tm.tm_year + 1900, 4);
+            cache.text[4] = '-';
+            put_digits(cache.text + 5, (unsigned long)cur_tm.tm_mon + 1, 2);
+            cache.text[7] = '-';
+            put_digits(cache.text + 8, (unsigned long)cur_tm.tm_mday, 2);
+            cache.text[10] = ' ';
+            put_digits(cache.text + 11, (unsigned long)cur_tm.tm_hour, 2);
+            cache.text[13] = ':';
+            put_digits(cache.text + 14, (unsigned long)cur_tm.tm_min, 2);
+            cache.text[16] = ':';
+            put_digits(cache.text + 17, (unsigned long)cur_tm.tm_sec, 2);
+        }
+        cache.sec = cur_ts.tv_sec;
+    }
+
+    memcpy(p_buf, cache.text, sizeof(cache.text));
+    if (precision == 0) {
+        return sizeof(cache.text);
+    }
+    char frac[9];
+    put_digits(frac, (unsigned long)cur_ts.tv_nsec, sizeof(frac));
+    p_buf[sizeof(cache.text)] = '.';
+    memcpy(p_buf + sizeof(cache.text) + 1, frac, precision);
+    return sizeof(cache.text) + 1 + precision;
+}
+
+/// \brief  Returns the thread id of the `%t` field, formatted once per thread.
+const tid_cache& thread_id()
+{
+    tid_cache& cache = tl_tid_cache;
+    if (cache.size == 0) {
+        cache.size = put_number(cache.text, (unsigned long)syscall(SYS_gettid));
+    }
+    return cache;
+}
+
+/// \brief  Appends at most the remaining space of the buffer.
+inline void put(char*& p_cur, const char* p_end, const char* p_data, size_t size)
+{
+    if (size > (size_t)(p_end - p_cur)) {
+        size = (size_t)(p_end - p_cur);
+    }
+    memcpy(p_cur, p_data, size);
+    p_cur += size;
+}
+
+/**
+ *  \brief  Reads the optional `{N}` argument of a field.
+ *  \param  pattern - layout pattern.
+ *  \param  pos - position after the field, moved past the argument.
+ *  \param  arg - argument, left unchanged if it is absent.
+ *  \param  max_arg - maximum value of the argument.
+ *  \return false if the argument is malformed or too large.
+ */
+bool parse_arg(const std::string& pattern, size_t& pos, unsigned& arg, unsigned max_arg)
+{
+    if ((pos >= pattern.size()) || (pattern[pos] != '{')) {
+        return true;
+    }
+    unsigned value = 0;
+    size_t i = pos + 1;
+    for (; (i < pattern.size()) && (pattern[i] >= '0') && (pattern[i] <= '9'); ++i) {
+        value = value * 10 + (unsigned)(pattern[i] - '0');
+        if (value > max_arg) {
+            return false;
+        }
+    }
+    if ((i == pos + 1) || (i >= pattern.size()) || (pattern[i] != '}')) {
+        return false;
+    }
+    arg = value;
+    pos = i + 1;
+    return true;
+}
+
+/**
+ *  \brief  Compiles a layout pattern.
+ *  \return The compiled layout, or null if the pattern is invalid.
+ */
+std::unique_ptr<details::layout> compile_layout(const std::string& pattern)
+{
+    using layout_t = details::layout;
+
+    std::unique_ptr<layout_t> p_layout(new layout_t());
+    p_layout->pattern = pattern;
+    // Index of the segment being filled, or 0 if the last operation is not a segment
+    size_t segment = 0;
+
+    const auto add_field = [&p_layout, &segment](layout_t::field::kind_t kind, unsigned width, const char* p_text, size_t size) -> void {
+        if (segment == 0) {
+            p_layout->ops.push_back({layout_t::op::segment, (uint16_t)p_layout->segments.size()});
+            p_layout->segments.emplace_back();
+            segment = p_layout->segments.size();
+        }
+        std::vector<layout_t::field>& fields = p_layout->segments[segment - 1];
+        if ((kind == layout_t::field::literal) && ! fields.empty() && (fields.back().kind == layout_t::field::literal)) {
+            fields.back().text.append(p_text, size);
+        } else {
+            fields.push_back({kind, (uint16_t)width, std::string(p_text, size)});
+        }
+    };
+    const auto add_op = [&p_layout, &segment](layout_t::op::kind_t kind, unsigned arg) -> void {
+        p_layout->ops.push_back({kind, (uint16_t)arg});
+        segment = 0;
+    };
+
+    for (size_t pos = 0; pos < pattern.size();) {
+        const size_t next = pattern.find('%', pos);
+        if (next != pos) {
+            const size_t end = (next == std::string::npos) ? pattern.size() : next;
+            add_field(layout_t::field::literal, 0, pattern.data() + pos, end - pos);
+            pos = end;
+            continue;
+        }
+        if (pos + 1 >= pattern.size()) {
+            return nullptr;
+        }
+
+        const char conv = pattern[pos + 1];
+        unsigned arg = 0;
+        pos += 2;
+        switch (conv) {
+        case '%':
+            add_field(layout_t::field::literal, 0, "%", 1);
+            break;
+        case 'T':
+            arg = 3;
+            if (! parse_arg(pattern, pos, arg, 9)) {
+                return nullptr;
+            }
+            add_op(layout_t::op::timestamp, arg);
+            break;
+        case 't':
+            add_op(layout_t::op::thread_id, 0);
+            break;
+        case 'l':
+            add_field(layout_t::field::level_tag, 0, "", 0);
+            break;
+        case 'L':
+            add_field(layout_t::field::level_name, 0, "", 0);
+            break;
+        case 'c':
+            if (! parse_arg(pattern, pos, arg, max_channel_width)) {
+                return nullptr;
+            }
+            add_field(layout_t::field::channel, arg, "", 0);
+            break;
+        case 's':
+            add_op(layout_t::op::source, 0);
+            break;
+        case 'f':
+            add_op(layout_t::op::function, 0);
+            break;
+        default:
+            return nullptr;
+        }
+    }
+    return p_layout;
+}
+
+/**
+ *  \brief  Returns the registry of the compiled layouts.
+ *  \details    Layouts are never destroyed, as records may be formatted by a
+ *      layout while it is being replaced. A pattern is compiled only once.
+ */
+std::vector<std::unique_ptr<details::layout>>& layouts()
+{
+    static std::vector<std::unique_ptr<details::layout>> registry;
+    return registry;
+}
+
+} // <anonymous> namespace
 
 manager::severity_level_t manager::m_global_level = {severity_level::info};
 std::atomic_bool manager::m_is_immutable = {false};
+std::atomic<const details::layout*> manager::m_p_layout = {nullptr};
+std::atomic_int manager::m_burst_level = {-1};
 std::recursive_mutex manager::m_loggers_mutex = {};
 manager::logger_holder::map manager::m_loggers_map = {};
+details::static_table* manager::m_p_static_tables = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+// class details::prefix_cache definition
+
+const details::record_prefix* details::prefix_cache::rebuild()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const layout* p_layout = &manager::layout();
+    const record_prefix* p_prefix = m_p_prefix.load(std::memory_order_relaxed);
+    if ((p_prefix != nullptr) && (p_prefix->p_layout == p_layout)) {
+        // Rebuilt by another thread
+        return p_prefix;
+    }
+    for (const std::unique_ptr<record_prefix>& p_table : m_tables) {
+        if (p_table->p_layout == p_layout) {
+            // Built for this layout before
+            m_p_prefix.store(p_table.get(), std::memory_order_release);
+            return p_table.get();
+        }
+    }
+
+    std::unique_ptr<record_prefix> p_table(new record_prefix());
+    p_table->p_layout = p_layout;
+    for (size_t lvl = 0; lvl <= LVL_TRACE; ++lvl) {
+        for (const std::vector<layout::field>& fields : p_layout->segments) {
+            std::string text;
+            for (const layout::field& f : fields) {
+                switch (f.kind) {
+                case layout::field::literal:
+                    text.append(f.text);
+                    break;
+                case layout::field::level_tag:
+                    text.append(g_level_tags[lvl]);
+                    break;
+                case layout::field::level_name:
+                    text.append(g_level_names[lvl]);
+                    break;
+                case layout::field::channel:
+                    text.append(m_channel);
+                    if (m_channel.size() < f.width) {
+                        text.append(f.width - m_channel.size(), ' ');
+                    }
+                    break;
+                }
+            }
+            p_table->segments[lvl].emplace_back(std::move(text));
+        }
+    }
+    m_tables.emplace_back(std::move(p_table));
+    m_p_prefix.store(m_tables.back().get(), std::memory_order_release);
+    return m_tables.back().get();
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 // class manager::logger_holder definition
 
 void manager::logger_holder::set_level(severity_level lvl)
 {
-    level = lvl;
-    if (p_base_logger) {
-        p_base_logger->level = level;
-    }
+    p_state->level = lvl;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // class manager definition
 
+const details::layout& manager::default_layout()
+{
+    static const std::unique_ptr<details::layout> p_layout = compile_layout(LOG_DEFAULT_LAYOUT);
+    return *p_layout;
+}
+
+lw_burst_engine_t* manager::burst_engine()
+{
+    // The engine reads and sets the levels under the mutex of the registry,
+    // so it is stopped before the mutex is taken. A channel bursts if it
+    // writes less than the burst level, limited by the global level.
+    static lw_burst_engine_t* const p_burst = lw_burst_engine_create(
+        [](const char* channel) -> int {
+            std::lock_guard<std::recursive_mutex> lock(m_loggers_mutex);
+            int lvl = -1;
+            logger_holder::map::const_iterator it = m_loggers_map.find(channel);
+            if (it != m_loggers_map.end()) {
+                lvl = (int)it->second->p_state->level.load(std::memory_order_relaxed);
+            } else {
+                for (details::static_table* p_table = m_p_static_tables; p_table && (lvl < 0); p_table = p_table->p_next) {
+                    for (size_t i = 0; i < p_table->size; ++i) {
+                        if (p_table->p_names[i] == channel) {
+                            lvl = (int)p_table->p_levels[i].load(std::memory_order_relaxed);
+                            break;
+                        }
+                    }
+                }
+            }
+            const int global_lvl = (int)m_global_level.load(std::memory_order_relaxed);
+            return (global_lvl < lvl) ? global_lvl : lvl;
+        },
+        set_burst_level);
+    return p_burst;
+}
+
 void manager::deinit()
 {
+    m_burst_level = -1;
+    if (lw_burst_engine_t* p_burst = burst_engine(); p_burst != nullptr) {
+        lw_burst_engine_stop(p_burst, false);
+    }
+
     std::lock_guard<std::recursive_mutex> lock(m_loggers_mutex);
+    for (const logger_holder::map::value_type& item : m_loggers_map) {
+        // The handles may outlive the registry.
+        item.second->p_state->burst_level = -1;
+    }
     m_loggers_map.erase(m_loggers_map.begin(), m_loggers_map.end());
+    for (details::static_table* p_table = m_p_static_tables; p_table; p_table = p_table->p_next) {
+        for (size_t i = 0; i < p_table->size; ++i) {
+            p_table->p_levels[i] = severity_level::debug;
+            p_table->p_bursts[i] = -1;
+        }
+    }
     m_global_level = severity_level::warning;
     m_is_immutable = false;
+    m_p_layout.store(nullptr, std::memory_order_release);
+}
+
+void manager::disable_burst()
+{
+    m_burst_level = -1;
+    if (lw_burst_engine_t* p_burst = burst_engine(); p_burst != nullptr) {
+        lw_burst_engine_stop(p_burst, true);
+    }
+}
+
+bool manager::enable_burst(const burst_config& cfg)
+{
+    lw_burst_engine_t* p_burst = burst_engine();
+    if ((p_burst == nullptr) || (cfg.window.count() <= 0) || (cfg.cooldown.count() < 0)) {
+        return false;
+    }
+    if (! lw_burst_engine_start(p_burst, (int)cfg.level, (uint32_t)cfg.window.count(),
+                                (uint32_t)cfg.cooldown.count(), cfg.max_active)) {
+        return false;
+    }
+    m_burst_level = (int)cfg.level;
+    return true;
+}
+
+size_t manager::format_head(char* buf, size_t size, const details::record_prefix& prefix,
+                            severity_level lvl, const details::source_location& loc)
+{
+    using op_t = details::layout::op;
+
+    if (size == 0) {
+        return 0;
+    }
+    char* p_cur = buf;
+    const char* const p_end = buf + size - 1;
+    const std::vector<std::string>& segments = prefix.segments[lvl];
+    for (const op_t& op : prefix.p_layout->ops) {
+        switch (op.kind) {
+        case op_t::segment:
+            put(p_cur, p_end, segments[op.arg].data(), segments[op.arg].size());
+            break;
+        case op_t::timestamp:
+            if ((size_t)(p_end - p_cur) >= 29) {
+                p_cur += put_timestamp(p_cur, op.arg);
+            } else {
+                char ts[29];
+                put(p_cur, p_end, ts, put_timestamp(ts, op.arg));
+            }
+            break;
+        case op_t::thread_id: {
+            const tid_cache& tid = thread_id();
+            put(p_cur, p_end, tid.text, tid.size);
+            break;
+        }
+        case op_t::source: {
+            char line[24];
+            line[0] = ':';
+            const size_t line_size = put_number(line + 1, (unsigned long)loc.line) + 1;
+            put(p_cur, p_end, loc.file, strlen(loc.file));
+            put(p_cur, p_end, line, line_size);
+            break;
+        }
+        case op_t::function:
+            put(p_cur, p_end, loc.function, strlen(loc.function));
+            break;
+        }
+    }
+    *p_cur = '\0';
+    return (size_t)(p_cur - buf);
 }
 
-void manager::init(severity_level global_lvl, init_fn_t init_fn)
+void manager::init(severity_level global_lvl, init_fn_t init_fn, const std::string& pattern)
 {
     static std::once_flag flag;
     //set_global_level(global_lvl);
-    std::call_once(flag, [&global_lvl, init_fn]() -> void {
+    std::call_once(flag, [&global_lvl, init_fn, &pattern]() -> void {
                              set_global_level(global_lvl);
+                             set_layout(pattern);
                              init_fn();
                          });
 }
 
+size_t manager::logger_count()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_loggers_mutex);
+    return m_loggers_map.size();
+}
+
 manager::logger_holder::ptr manager::register_logger(const std::string& channel, severity_level lvl)
 {
     using return_type = std::pair<logger_holder::map::iterator, bool>;
 
     logger_holder::ptr ptr = std::make_shared<logger_holder>(channel, lvl);
-    const return_type rc = m_loggers_map.emplace(ptr->channel, ptr);
+    const return_type rc = m_loggers_map.emplace(ptr->p_state->channel, ptr);
     return rc.first->second;
 }
 
+void manager::register_static_table(details::static_table& table)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_loggers_mutex);
+    for (size_t i = 0; i < table.size; ++i) {
+        logger_holder::map::iterator it = m_loggers_map.find(std::string(table.p_names[i]));
+        if (it != m_loggers_map.end()) {
+            table.p_levels[i] = it->second->p_state->level.load();
+        }
+    }
+    table.p_next = m_p_static_tables;
+    m_p_static_tables = &table;
+}
+
+void manager::set_burst_level(const char* channel, int lvl)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_loggers_mutex);
+    logger_holder::map::iterator it = m_loggers_map.find(channel);
+    if (it != m_loggers_map.end()) {
+        it->second->p_state->burst_level = lvl;
+    }
+    for (details::static_table* p_table = m_p_static_tables; p_table; p_table = p_table->p_next) {
+        for (size_t i = 0; i < p_table->size; ++i) {
+            if (p_table->p_names[i] == channel) {
+                p_table->p_bursts[i] = lvl;
+            }
+        }
+    }
+}
+
 void manager::set_global_level(severity_level lvl)
 {
     if (m_is_immutable) {
@@ -97,6 +554,26 @@ void manager::set_immutable_global_level(severity_level lvl)
     }
 }
 
+bool manager::set_layout(const std::string& pattern)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_loggers_mutex);
+    std::vector<std::unique_ptr<details::layout>>& registry = layouts();
+    for (const std::unique_ptr<details::layout>& p_layout : registry) {
+        if (p_layout->pattern == pattern) {
+            m_p_layout.store(p_layout.get(), std::memory_order_release);
+            return true;
+        }
+    }
+
+    std::unique_ptr<details::layout> p_layout = compile_layout(pattern);
+    if (! p_layout) {
+        return false;
+    }
+    registry.emplace_back(std::move(p_layout));
+    m_p_layout.store(registry.back().get(), std::memory_order_release);
+    return true;
+}
+
 void manager::set_logger_level(const std::string& channel, severity_level lvl)
 {
     if ((lvl < severity_level::emerg) || (lvl > severity_level::trace)) {
@@ -110,6 +587,55 @@ void manager::set_logger_level(const std::string& channel, severity_level lvl)
     } else {
         it->second->set_level(lvl);
     }
+    for (details::static_table* p_table = m_p_static_tables; p_table; p_table = p_table->p_next) {
+        for (size_t i = 0; i < p_table->size; ++i) {
+            if (p_table->p_names[i] == channel) {
+                p_table->p_levels[i] = lvl;
+            }
+        }
+    }
+}
+
+void manager::set_static_levels(const details::static_table& table, size_t first, size_t count,
+                                severity_level lvl)
+{
+    // The key is reused between the calls under the mutex, so the lookups do
+    // not allocate once it has grown to the longest name.
+    static std::string key;
+
+    std::lock_guard<std::recursive_mutex> lock(m_loggers_mutex);
+    for (size_t i = first; i < first + count; ++i) {
+        table.p_levels[i].store(lvl, std::memory_order_relaxed);
+    }
+    if (m_loggers_map.empty()) {
+        return;
+    }
+    for (size_t i = first; i < first + count; ++i) {
+        key.assign(table.p_names[i].data(), table.p_names[i].size());
+        logger_holder::map::iterator it = m_loggers_map.find(key);
+        if (it != m_loggers_map.end()) {
+            it->second->set_level(lvl);
+        }
+    }
+}
+
+severity_level manager::static_level(const std::string& channel)
+{
+    for (details::static_table* p_table = m_p_static_tables; p_table; p_table = p_table->p_next) {
+        for (size_t i = 0; i < p_table->size; ++i) {
+            if (p_table->p_names[i] == channel) {
+                return p_table->p_levels[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+    return severity_level::debug;
+}
+
+void manager::trigger_burst(const std::string& channel)
+{
+    if (lw_burst_engine_t* p_burst = burst_engine(); p_burst != nullptr) {
+        lw_burst_engine_trigger(p_burst, channel.c_str());
+    }
 }
 
 int manager::timestamp(char* buf, size_t size)
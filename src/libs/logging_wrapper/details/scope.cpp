@@ -0,0 +1,430 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \ingroup logging_wrapper_module
+ */
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <streambuf>
+#include <string>
+
+#include "logging_wrapper/scope.h"
+
+namespace wstux {
+namespace logging {
+namespace details {
+
+/**
+ *  \brief  Block of the arena of a scope.
+ *
+ *  \details    The records follow the block header one after another: the
+ *      record header, the record and its null terminator, aligned to 8 bytes.
+ */
+struct scope_block
+{
+    scope_block* p_next;    ///< Next block of the scope or of the cache.
+    size_t capacity;        ///< Size of the space for records.
+    size_t used;            ///< Size of the records in the block.
+
+    char* data() noexcept { return reinterpret_cast<char*>(this + 1); }
+};
+
+namespace {
+
+/// \brief  Size of the space for records of a regular block.
+constexpr size_t g_block_capacity = 4096 - sizeof(scope_block);
+/// \brief  Number of regular blocks cached by a thread.
+constexpr size_t g_block_cache_size = 16;
+/// \brief  Size of the stack buffer of \ref scope_printf.
+constexpr size_t g_printf_buf_size = 1024;
+
+/// \brief  Header of a record in a block.
+struct record_header
+{
+    scope_sink sink;    ///< Backend of the record.
+    size_t size;        ///< Length of the record.
+};
+
+inline size_t align8(size_t size) { return (size + 7) & ~size_t(7); }
+
+/// \brief  Returns the size of a record with its header in a block.
+inline size_t record_bytes(size_t size) { return sizeof(record_header) + align8(size + 1); }
+
+/**
+ *  \brief  Thread-local cache of the regular blocks of finished scopes.
+ */
+struct block_cache final
+{
+    ~block_cache()
+    {
+        while (p_head != nullptr) {
+            scope_block* p_block = p_head;
+            p_head = p_block->p_next;
+            std::free(p_block);
+        }
+    }
+
+    scope_block* p_head = nullptr;
+    size_t count = 0;
+};
+
+thread_local block_cache tl_block_cache;
+
+scope_block* alloc_block(size_t bytes) noexcept
+{
+    scope_block* p_block = nullptr;
+    if (bytes <= g_block_capacity) {
+        block_cache& cache = tl_block_cache;
+        if (cache.p_head != nullptr) {
+            p_block = cache.p_head;
+            cache.p_head = p_block->p_next;
+            --cache.count;
+        } else {
+            p_block = (scope_block*)std::malloc(sizeof(scope_block) + g_block_capacity);
+        }
+        bytes = g_block_capacity;
+    } else {
+        p_block = (scope_block*)std::malloc(sizeof(scope_block) + bytes);
+    }
+    if (p_block != nullptr) {
+        p_block->p_next = nullptr;
+        p_block->capacity = bytes;
+        p_block->used = 0;
+    }
+    return p_block;
+}
+
+void free_blocks(scope_block* p_block) noexcept
+{
+    block_cache& cache = tl_block_cache;
+    while (p_block != nullptr) {
+        scope_block* p_next = p_block->p_next;
+        if ((p_block->capacity == g_block_capacity) && (cache.count < g_block_cache_size)) {
+            p_block->p_next = cache.p_head;
+            cache.p_head = p_block;
+            ++cache.count;
+        } else {
+            std::free(p_block);
+        }
+        p_block = p_next;
+    }
+}
+
+/**
+ *  \brief  Stream buffer over a string, which keeps its capacity between
+ *      records.
+ */
+class record_streambuf final : public std::streambuf
+{
+public:
+    void reset(const char* p_head, size_t head_len) { m_record.assign(p_head, head_len); }
+
+    std::string& record() noexcept { return m_record; }
+
+protected:
+    virtual int_type overflow(int_type ch) override
+    {
+        if (! traits_type::eq_int_type(ch, traits_type::eof())) {
+            m_record.push_back(traits_type::to_char_type(ch));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    virtual std::streamsize xsputn(const char_type* p_str, std::streamsize count) override
+    {
+        m_record.append(p_str, (size_t)count);
+        return count;
+    }
+
+private:
+    std::string m_record;
+};
+
+/**
+ *  \brief  Thread-local stream of the records of `LOG_*` macros.
+ */
+struct record_stream final
+{
+    record_stream()
+        : os(&buf)
+        , dfl_flags(os.flags())
+        , dfl_precision(os.precision())
+        , dfl_fill(os.fill())
+    {}
+
+    record_streambuf buf;
+    std::ostream os;
+    std::ios_base::fmtflags dfl_flags;
+    std::streamsize dfl_precision;
+    char dfl_fill;
+};
+
+thread_local record_stream tl_record_stream;
+
+} // <anonymous> namespace
+
+/**
+ *  \brief  Internal access to the arena of scopes.
+ */
+struct scope_writer final
+{
+    /**
+     *  \brief  Reserves a record in the arena of a scope.
+     *  \return Space for `size + 1` characters, or `nullptr` if the record is
+     *      dropped by the size limit.
+     */
+    static char* reserve(log_scope& scope, const scope_sink& sink, size_t size) noexcept
+    {
+        const size_t bytes = record_bytes(size);
+        if (scope.m_size + bytes > scope.m_max_size) {
+            ++scope.m_dropped;
+            return nullptr;
+        }
+        scope_block* p_block = scope.m_p_tail;
+        if ((p_block == nullptr) || (p_block->capacity - p_block->used < bytes)) {
+            p_block = alloc_block(bytes);
+            if (p_block == nullptr) {
+                ++scope.m_dropped;
+                return nullptr;
+            }
+            if (scope.m_p_tail == nullptr) {
+                scope.m_p_head = p_block;
+            } else {
+                scope.m_p_tail->p_next = p_block;
+            }
+            scope.m_p_tail = p_block;
+        }
+        record_header* p_header = reinterpret_cast<record_header*>(p_block->data() + p_block->used);
+        p_header->sink = sink;
+        p_header->size = size;
+        p_block->used += bytes;
+        scope.m_size += bytes;
+        return reinterpret_cast<char*>(p_header + 1);
+    }
+
+    static void append(log_scope& scope, const scope_sink& sink, const char* p_data, size_t size) noexcept
+    {
+        char* p_record = reserve(scope, sink, size);
+        if (p_record != nullptr) {
+            std::memcpy(p_record, p_data, size);
+            p_record[size] = '\0';
+        }
+    }
+
+    /// \brief  Calls a functor for every record of a scope in the logged order.
+    template<typename TFn>
+    static void for_each(const log_scope& scope, TFn&& fn)
+    {
+        for (scope_block* p_block = scope.m_p_head; p_block != nullptr; p_block = p_block->p_next) {
+            for (size_t offset = 0; offset < p_block->used;) {
+                const record_header* p_header = reinterpret_cast<const record_header*>(p_block->data() + offset);
+                fn(*p_header, reinterpret_cast<const char*>(p_header + 1));
+                offset += record_bytes(p_header->size);
+            }
+        }
+    }
+
+    static void release(log_scope& scope) noexcept
+    {
+        free_blocks(scope.m_p_head);
+        scope.m_p_head = nullptr;
+        scope.m_p_tail = nullptr;
+        scope.m_size = 0;
+    }
+
+    /// \brief  Writes the records of a scope to their backends and releases them.
+    static void write(log_scope& scope)
+    {
+        struct release_guard
+        {
+            ~release_guard() { release(scope); }
+            log_scope& scope;
+        } guard{scope};
+
+        for_each(scope, [](const record_header& header, const char* p_data) -> void {
+                            header.sink.p_write(header.sink.p_backend, p_data, header.size);
+                        });
+    }
+
+    /**
+     *  \brief  Passes the records of a scope to the enclosing scope, within the
+     *      size limit of the latter.
+     */
+    static void pass_to_parent(log_scope& scope) noexcept
+    {
+        log_scope& parent = *scope.m_p_parent;
+        parent.m_dropped += scope.m_dropped;
+        if (scope.m_p_head == nullptr) {
+            return;
+        }
+        if (parent.m_size + scope.m_size <= parent.m_max_size) {
+            // All the records fit: the blocks are moved as they are.
+            if (parent.m_p_tail == nullptr) {
+                parent.m_p_head = scope.m_p_head;
+            } else {
+                parent.m_p_tail->p_next = scope.m_p_head;
+            }
+            parent.m_p_tail = scope.m_p_tail;
+            parent.m_size += scope.m_size;
+            scope.m_p_head = nullptr;
+            scope.m_p_tail = nullptr;
+            scope.m_size = 0;
+            return;
+        }
+        for_each(scope, [&parent](const record_header& header, const char* p_data) -> void {
+                            append(parent, header.sink, p_data, header.size);
+                        });
+        release(scope);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Capture functions definition
+
+void scope_capture(const scope_sink& sink, const char* p_data, size_t size) noexcept
+{
+    log_scope* p_scope = tl_p_scope;
+    if ((p_scope != nullptr) && (sink.p_write != nullptr)) {
+        scope_writer::append(*p_scope, sink, p_data, size);
+    }
+}
+
+void scope_printf(const scope_sink& sink, const char* p_head, size_t head_len, const char* p_fmt, ...) noexcept
+{
+    log_scope* p_scope = tl_p_scope;
+    if ((p_scope == nullptr) || (sink.p_write == nullptr)) {
+        return;
+    }
+
+    char buf[g_printf_buf_size];
+    head_len = (head_len < sizeof(buf)) ? head_len : sizeof(buf) - 1;
+    std::memcpy(buf, p_head, head_len);
+
+    va_list args;
+    va_start(args, p_fmt);
+    va_list args_copy;
+    va_copy(args_copy, args);
+    const int rc = std::vsnprintf(buf + head_len, sizeof(buf) - head_len, p_fmt, args);
+    va_end(args);
+    if (rc >= 0) {
+        const size_t size = head_len + (size_t)rc;
+        if (size < sizeof(buf)) {
+            scope_writer::append(*p_scope, sink, buf, size);
+        } else {
+            // The record is longer than the stack buffer: it is formatted again
+            // right into the arena.
+            char* p_record = scope_writer::reserve(*p_scope, sink, size);
+            if (p_record != nullptr) {
+                std::memcpy(p_record, buf, head_len);
+                std::vsnprintf(p_record + head_len, (size_t)rc + 1, p_fmt, args_copy);
+            }
+        }
+    }
+    va_end(args_copy);
+}
+
+std::ostream& scope_stream(const char* p_head, size_t head_len)
+{
+    record_stream& stream = tl_record_stream;
+    stream.buf.reset(p_head, head_len);
+    stream.os.clear();
+    stream.os.flags(stream.dfl_flags);
+    stream.os.precision(stream.dfl_precision);
+    stream.os.fill(stream.dfl_fill);
+    stream.os.width(0);
+    return stream.os;
+}
+
+void scope_stream_end(const scope_sink& sink) noexcept
+{
+    log_scope* p_scope = tl_p_scope;
+    if ((p_scope == nullptr) || (sink.p_write == nullptr)) {
+        return;
+    }
+
+    // The new line is added in the arena, so the string is not grown.
+    const std::string& record = tl_record_stream.buf.record();
+    char* p_record = scope_writer::reserve(*p_scope, sink, record.size() + 1);
+    if (p_record != nullptr) {
+        std::memcpy(p_record, record.data(), record.size());
+        p_record[record.size()] = '\n';
+        p_record[record.size() + 1] = '\0';
+    }
+}
+
+} // namespace details
+
+////////////////////////////////////////////////////////////////////////////////
+// log_scope definition
+
+log_scope::log_scope(severity_level lvl, size_t max_size) noexcept
+    : m_p_parent(details::tl_p_scope)
+    , m_level(lvl)
+    , m_max_size(max_size)
+    , m_size(0)
+    , m_dropped(0)
+    , m_exceptions(std::uncaught_exceptions())
+    , m_is_failed(false)
+    , m_p_head(nullptr)
+    , m_p_tail(nullptr)
+{
+    details::tl_p_scope = this;
+}
+
+log_scope::~log_scope()
+{
+    if (failed()) {
+        if (m_p_parent != nullptr) {
+            details::scope_writer::pass_to_parent(*this);
+        } else {
+            try {
+                details::scope_writer::write(*this);
+            } catch (...) {
+                // A destructor must not throw, and the records are lost.
+            }
+        }
+    }
+    details::scope_writer::release(*this);
+    details::tl_p_scope = m_p_parent;
+}
+
+bool log_scope::failed() const noexcept
+{
+    return m_is_failed || (std::uncaught_exceptions() > m_exceptions);
+}
+
+void log_scope::flush()
+{
+    if (m_p_parent != nullptr) {
+        m_p_parent->flush();
+    }
+    details::scope_writer::write(*this);
+}
+
+void log_scope::discard() noexcept
+{
+    details::scope_writer::release(*this);
+}
+
+} // namespace logging
+} // namespace wstux
@@ -0,0 +1,244 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \ingroup logging_wrapper_module
+ */
+
+#include <cmath>
+#include <time.h>
+
+#include "logging_wrapper/structured.h"
+#include "logging_wrapper/details/escape.h"
+
+namespace wstux {
+namespace logging {
+namespace {
+
+/// \brief  Level names of the `logfmt` and `json` formats by severity level.
+const std::string_view g_kv_level_names[] = {
+    "emerg", "fatal", "crit", "error", "warning", "notice", "info", "debug", "trace"
+};
+
+/// \brief  Format of the records passed to backends without `write_kv`.
+std::atomic<kv_format> g_kv_format(kv_format::text);
+
+/// \brief  Member which ends a truncated JSON record.
+constexpr std::string_view g_json_truncated_tail = ",\"truncated\":true}";
+
+/// \brief  Writes the two digits of a number from 0 to 99.
+inline void put_2digits(char* p_buf, int value)
+{
+    p_buf[0] = (char)('0' + value / 10);
+    p_buf[1] = (char)('0' + value % 10);
+}
+
+/// \brief  Writes a timestamp in the `YYYY-MM-DDTHH:MM:SS.uuuuuuZ` format.
+void put_iso_timestamp(text_buffer& out, uint64_t ts_ns)
+{
+    const time_t sec = (time_t)(ts_ns / 1000000000u);
+    struct tm cur_tm;
+    if (gmtime_r(&sec, &cur_tm) == NULL) {
+        out << "1970-01-01T00:00:00.000000Z";
+        return;
+    }
+    char buf[27];
+    const int year = cur_tm.tm_year + 1900;
+    put_2digits(buf, (year / 100) % 100);
+    put_2digits(buf + 2, year % 100);
+    buf[4] = '-';
+    put_2digits(buf + 5, cur_tm.tm_mon + 1);
+    buf[7] = '-';
+    put_2digits(buf + 8, cur_tm.tm_mday);
+    buf[10] = 'T';
+    put_2digits(buf + 11, cur_tm.tm_hour);
+    buf[13] = ':';
+    put_2digits(buf + 14, cur_tm.tm_min);
+    buf[16] = ':';
+    put_2digits(buf + 17, cur_tm.tm_sec);
+    buf[19] = '.';
+    uint64_t us = (ts_ns % 1000000000u) / 1000u;
+    for (size_t i = 26; i > 20; --i) {
+        buf[i - 1] = (char)('0' + us % 10);
+        us /= 10;
+    }
+    buf[26] = 'Z';
+    out.append(buf, sizeof(buf));
+}
+
+/// \brief  Writes a JSON string.
+void put_json_string(text_buffer& out, std::string_view str)
+{
+    out.put('"');
+    details::put_escaped(out, str);
+    out.put('"');
+}
+
+/// \brief  Writes a logfmt value, quoted if it is empty or contains spaces,
+///     `=`, quotes or control characters.
+void put_logfmt_string(text_buffer& out, std::string_view str)
+{
+    if (! details::needs_logfmt_quotes(str)) {
+        out << str;
+        return;
+    }
+    out.put('"');
+    details::put_escaped(out, str);
+    out.put('"');
+}
+
+/// \brief  Writes a key of the `text` and `logfmt` formats, which cannot be
+///     quoted: the bytes which would break the pair are replaced by `_`.
+void put_logfmt_key(text_buffer& out, std::string_view key)
+{
+    if (key.empty()) {
+        out.put('_');
+        return;
+    }
+    if (! details::needs_logfmt_quotes(key)) {
+        out << key;
+        return;
+    }
+    for (const char c : key) {
+        const unsigned char byte = (unsigned char)c;
+        out.put(((byte <= ' ') || (byte == 0x7F) || (c == '=') || (c == '"') || (c == '\\')) ? '_' : c);
+    }
+}
+
+/// \brief  Writes the value of a field.
+void put_value(text_buffer& out, kv_format fmt, const kv_value& value)
+{
+    switch (value.type) {
+    case kv_type::i64:
+        out << value.i;
+        break;
+    case kv_type::u64:
+        out << value.u;
+        break;
+    case kv_type::f64:
+        if ((fmt == kv_format::json) && ! std::isfinite(value.f)) {
+            // JSON has no infinities and NaNs.
+            out << "null";
+        } else {
+            out << value.f;
+        }
+        break;
+    case kv_type::boolean:
+        out << value.b;
+        break;
+    case kv_type::str:
+        if (fmt == kv_format::json) {
+            put_json_string(out, value.s);
+        } else {
+            put_logfmt_string(out, value.s);
+        }
+        break;
+    }
+}
+
+} // <anonymous> namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// Structured records definition
+
+void render_kv(text_buffer& out, kv_format fmt, const kv_record& record) noexcept
+{
+    const size_t level = (size_t)record.level();
+    const std::string_view level_name = (level < sizeof(g_kv_level_names) / sizeof(g_kv_level_names[0]))
+                                      ? g_kv_level_names[level] : "unknown";
+    switch (fmt) {
+    case kv_format::text:
+        out << record.message();
+        record.for_each_field([&out](std::string_view key, const kv_value& value) -> void {
+                                  out.put(' ');
+                                  put_logfmt_key(out, key);
+                                  out.put('=');
+                                  put_value(out, kv_format::text, value);
+                              });
+        break;
+    case kv_format::logfmt:
+        out << "ts=";
+        put_iso_timestamp(out, record.timestamp_ns());
+        out << " level=" << level_name << " channel=";
+        put_logfmt_string(out, record.channel());
+        out << " msg=";
+        put_logfmt_string(out, record.message());
+        record.for_each_field([&out](std::string_view key, const kv_value& value) -> void {
+                                  out.put(' ');
+                                  put_logfmt_key(out, key);
+                                  out.put('=');
+                                  put_value(out, kv_format::logfmt, value);
+                              });
+        break;
+    case kv_format::json: {
+        // Length of the record up to its last complete member, after which
+        // the truncation tail still fits.
+        const size_t start = out.size();
+        size_t complete = start;
+        const auto mark_complete = [&out, &complete]() -> void {
+            if (! out.truncated() && (out.size() + g_json_truncated_tail.size() <= out.capacity())) {
+                complete = out.size();
+            }
+        };
+        out << "{\"ts\":\"";
+        put_iso_timestamp(out, record.timestamp_ns());
+        out << "\",\"level\":\"" << level_name << "\",\"channel\":";
+        put_json_string(out, record.channel());
+        out << ",\"msg\":";
+        put_json_string(out, record.message());
+        mark_complete();
+        record.for_each_field([&out, &mark_complete](std::string_view key, const kv_value& value) -> void {
+                                  if (out.truncated()) {
+                                      return;
+                                  }
+                                  out.put(',');
+                                  put_json_string(out, key);
+                                  out.put(':');
+                                  put_value(out, kv_format::json, value);
+                                  mark_complete();
+                              });
+        if (! out.truncated() && ! record.truncated()) {
+            out.put('}');
+            if (! out.truncated()) {
+                break;
+            }
+        }
+        if (complete != start) {
+            out.rewind(complete);
+            out << g_json_truncated_tail;
+        } else {
+            out.rewind(start);
+            out << "{\"truncated\":true}";
+        }
+        break;
+    }
+    }
+}
+
+void set_kv_format(kv_format fmt) noexcept
+{
+    g_kv_format.store(fmt, std::memory_order_relaxed);
+}
+
+kv_format get_kv_format() noexcept
+{
+    return g_kv_format.load(std::memory_order_relaxed);
+}
+
+} // namespace logging
+} // namespace wstux
@@ -0,0 +1,591 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Text buffer with fast conversion of values.
+ *  \ingroup logging_wrapper_module
+ *
+ *  \details    The buffer writes values into a caller-provided array without
+ *      allocations. Numbers are converted by the functions of
+ *      `loggingf_wrapper/format.h`: integers by a table of digit pairs and
+ *      floating point numbers to their shortest round-trip text. The C library
+ *      implements them for both wrappers, so `logging_wrapper` links
+ *      `loggingf_wrapper`.
+ *
+ *  \code
+ *  char line[128];
+ *  wstux::logging::text_buffer buf(line);
+ *  buf << "elapsed " << 0.25 << " s, " << 42u << " items";
+ *  fputs(buf.c_str(), stdout);
+ *  \endcode
+ *
+ *      Format strings with `{}` fields are parsed and checked against the
+ *      types of the arguments at compile time. A field is `{}` or `{:x}` /
+ *      `{:X}` (hexadecimal integer), and `{{` / `}}` are literal braces. The
+ *      string is wrapped into a type by \ref LW_FORMAT_STRING, so that a field
+ *      without an argument, an argument without a field, an unsupported
+ *      argument type or an invalid field do not compile.
+ *
+ *  \code
+ *  wstux::logging::format_to(buf, LW_FORMAT_STRING("{} of {} ({:x})"), 1, "two", 255u);
+ *  \endcode
+ */
+
+#ifndef _LIBS_LOGGING_WRAPPER_FORMAT_H_
+#define _LIBS_LOGGING_WRAPPER_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "loggingf_wrapper/format.h"
+
+namespace wstux {
+namespace logging {
+
+/**
+ *  \brief  Writer of text into a fixed-size buffer.
+ *
+ *  \details    The text is always null-terminated. Text which does not fit is
+ *      truncated, and \ref text_buffer::truncated reports it.
+ */
+class text_buffer
+{
+public:
+    /**
+     *  \brief  Constructs a writer into the buffer.
+     *  \param  p_buf - buffer.
+     *  \param  size - size of the buffer, at least `1`.
+     */
+    text_buffer(char* p_buf, size_t size) noexcept
+        : m_p_buf(p_buf)
+        , m_capacity(size - 1)
+        , m_len(0)
+        , m_truncated(false)
+    {
+        m_p_buf[0] = '\0';
+    }
+
+    template<size_t TSize>
+    explicit text_buffer(char (&buf)[TSize]) noexcept
+        : text_buffer(buf, TSize)
+    {}
+
+    text_buffer(const text_buffer&) = delete;
+    text_buffer& operator=(const text_buffer&) = delete;
+
+    /// \brief  Returns the null-terminated text.
+    const char* c_str() const noexcept { return m_p_buf; }
+
+    /// \brief  Returns the text.
+    const char* data() const noexcept { return m_p_buf; }
+
+    /// \brief  Returns the length of the text.
+    size_t size() const noexcept { return m_len; }
+
+    /// \brief  Returns the maximum length of the text.
+    size_t capacity() const noexcept { return m_capacity; }
+
+    /// \brief  Returns true if a part of the text is dropped.
+    bool truncated() const noexcept { return m_truncated; }
+
+    /// \brief  Returns the text as a view.
+    std::string_view view() const noexcept { return std::string_view(m_p_buf, m_len); }
+
+    /// \brief  Shortens the text to `len` characters and clears the
+    ///     truncation flag.
+    void rewind(size_t len) noexcept
+    {
+        if (len < m_len) {
+            m_len = len;
+            m_p_buf[m_len] = '\0';
+        }
+        m_truncated = false;
+    }
+
+    /// \brief  Removes the text.
+    void clear() noexcept
+    {
+        m_len = 0;
+        m_truncated = false;
+        m_p_buf[0] = '\0';
+    }
+
+    /**
+     *  \brief  Appends characters.
+     */
+    text_buffer& append(const char* p_data, size_t size) noexcept
+    {
+        const size_t room = m_capacity - m_len;
+        if (size > room) {
+            size = room;
+            m_truncated = true;
+        }
+        std::memcpy(m_p_buf + m_len, p_data, size);
+        m_len += size;
+        m_p_buf[m_len] = '\0';
+        return *this;
+    }
+
+    /**
+     *  \brief  Appends a character.
+     */
+    text_buffer& put(char c) noexcept
+    {
+        if (m_len == m_capacity) {
+            m_truncated = true;
+            return *this;
+        }
+        m_p_buf[m_len++] = c;
+        m_p_buf[m_len] = '\0';
+        return *this;
+    }
+
+    /**
+     *  \brief  Appends the text of an integer.
+     */
+    template<typename TInt>
+    std::enable_if_t<std::is_integral_v<TInt>, text_buffer&> put_int(TInt value) noexcept
+    {
+        if constexpr (std::is_signed_v<TInt>) {
+            return put_number<LW_FORMAT_INT_LEN>(lw_format_i64, (int64_t)value);
+        } else {
+            return put_number<LW_FORMAT_INT_LEN>(lw_format_u64, (uint64_t)value);
+        }
+    }
+
+    /**
+     *  \brief  Appends the hexadecimal text of an integer without a prefix.
+     *  \param  value - number.
+     *  \param  upper - true to write the digits `A`-`F` in uppercase.
+     */
+    template<typename TInt>
+    std::enable_if_t<std::is_integral_v<TInt>, text_buffer&> put_hex(TInt value, bool upper = false) noexcept
+    {
+        const char* p_digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        char tmp[1 + 2 * sizeof(uint64_t)];
+        uint64_t abs_value = (uint64_t)value;
+        if constexpr (std::is_signed_v<TInt>) {
+            abs_value = (value < 0) ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+        }
+        size_t pos = sizeof(tmp);
+        do {
+            tmp[--pos] = p_digits[abs_value & 0xF];
+            abs_value >>= 4;
+        } while (abs_value != 0);
+        if constexpr (std::is_signed_v<TInt>) {
+            if (value < 0) {
+                tmp[--pos] = '-';
+            }
+        }
+        return append(tmp + pos, sizeof(tmp) - pos);
+    }
+
+    /**
+     *  \brief  Appends the shortest round-trip text of a floating point number.
+     */
+    text_buffer& put_double(double value) noexcept
+    {
+        return put_number<LW_FORMAT_DOUBLE_LEN>(lw_format_double, value);
+    }
+
+    text_buffer& operator<<(std::string_view str) noexcept { return append(str.data(), str.size()); }
+    text_buffer& operator<<(const std::string& str) noexcept { return append(str.data(), str.size()); }
+    text_buffer& operator<<(const char* p_str) noexcept
+    {
+        return (p_str != nullptr) ? append(p_str, std::strlen(p_str)) : append("(null)", 6);
+    }
+    text_buffer& operator<<(char c) noexcept { return put(c); }
+    text_buffer& operator<<(bool value) noexcept { return value ? append("true", 4) : append("false", 5); }
+    /// \note   A `float` is written as the `double` of the same value.
+    text_buffer& operator<<(float value) noexcept { return put_double(value); }
+    text_buffer& operator<<(double value) noexcept { return put_double(value); }
+    text_buffer& operator<<(const void* p_value) noexcept
+    {
+        char tmp[2 + 2 * sizeof(uintptr_t)];
+        uintptr_t value = reinterpret_cast<uintptr_t>(p_value);
+        size_t pos = sizeof(tmp);
+        do {
+            tmp[--pos] = "0123456789abcdef"[value & 0xF];
+            value >>= 4;
+        } while (value != 0);
+        tmp[--pos] = 'x';
+        tmp[--pos] = '0';
+        return append(tmp + pos, sizeof(tmp) - pos);
+    }
+
+    template<typename TInt,
+             typename = std::enable_if_t<std::is_integral_v<TInt> && ! std::is_same_v<TInt, bool>
+                                         && ! std::is_same_v<TInt, char>>>
+    text_buffer& operator<<(TInt value) noexcept
+    {
+        return put_int(value);
+    }
+
+private:
+    template<size_t TLen, typename TFn, typename TValue>
+    text_buffer& put_number(TFn fn, TValue value) noexcept
+    {
+        if (m_capacity - m_len >= TLen) {
+            m_len += fn(m_p_buf + m_len, value);
+            m_p_buf[m_len] = '\0';
+            return *this;
+        }
+        char tmp[TLen];
+        return append(tmp, fn(tmp, value));
+    }
+
+private:
+    char* m_p_buf;
+    const size_t m_capacity;
+    size_t m_len;
+    bool m_truncated;
+};
+
+
+/**
+ *  \def    LW_FORMAT_STRING(fmt)
+ *  \brief  Wraps a string literal into a type, so that it can be parsed at
+ *      compile time.
+ *  \param  fmt - format string literal.
+ *
+ *  \details    The type provides the string by a static constexpr function
+ *      `value()`. Arguments other than constant expressions do not compile.
+ */
+#define LW_FORMAT_STRING(fmt)                                               \
+    [] {                                                                    \
+        struct _lw_format_string                                            \
+        {                                                                   \
+            static constexpr ::std::string_view value() { return fmt; }     \
+        };                                                                  \
+        return _lw_format_string{};                                         \
+    }()
+
+namespace details {
+
+/**
+ *  \brief  Error of the parsing of a format string.
+ */
+enum class format_error
+{
+    none,           ///< The string matches the arguments.
+    unmatched_brace,///< A `{` without `}` or a single `}`.
+    invalid_field,  ///< A field other than `{}`, `{:x}` or `{:X}`.
+    missing_arg,    ///< More fields than arguments.
+    unused_arg,     ///< More arguments than fields.
+    not_integer     ///< A hexadecimal field of an argument which is not an integer.
+};
+
+/**
+ *  \brief  Literal text before a field of a format string, and the field.
+ */
+struct format_field
+{
+    size_t begin = 0;       ///< Offset of the literal text.
+    size_t end = 0;         ///< End of the literal text.
+    bool escaped = false;   ///< True if the text contains `{{` or `}}`.
+    char conv = '\0';       ///< `x` or `X` for a hexadecimal field, or `0`.
+};
+
+/**
+ *  \brief  Parsed format string of `TCount` fields.
+ *
+ *  \details    The last element is the literal text after the last field.
+ */
+template<size_t TCount>
+struct format_fields
+{
+    format_field fields[TCount + 1] = {};
+    format_error error = format_error::none;
+};
+
+/**
+ *  \brief  True if the argument type can be written into a text buffer.
+ */
+template<typename T, typename = void>
+struct is_formattable : std::false_type
+{};
+
+template<typename T>
+struct is_formattable<T, std::void_t<decltype(std::declval<text_buffer&>() << std::declval<const T&>())>>
+    : std::true_type
+{};
+
+/**
+ *  \brief  True if the backend has a `write(p_data, size)` member.
+ */
+template<typename T, typename = void>
+struct has_write : std::false_type
+{};
+
+template<typename T>
+struct has_write<T, std::void_t<decltype(std::declval<T&>().write((const char*)nullptr, size_t(0)))>>
+    : std::true_type
+{};
+
+/**
+ *  \brief  True if the backend has a `flush()` member.
+ */
+template<typename T, typename = void>
+struct has_flush : std::false_type
+{};
+
+template<typename T>
+struct has_flush<T, std::void_t<decltype(std::declval<T&>().flush())>> : std::true_type
+{};
+
+/**
+ *  \brief  True if the argument type can be written by a hexadecimal field.
+ */
+template<typename T>
+constexpr bool is_hex_formattable_v =
+    std::is_integral_v<T> && ! std::is_same_v<T, bool> && ! std::is_same_v<T, char>;
+
+/**
+ *  \brief  Parses a format string.
+ *  \param  fmt - format string.
+ *  \param  is_integer - for each argument, true if it can be written by a
+ *      hexadecimal field, and one more element.
+ */
+template<size_t TCount>
+constexpr format_fields<TCount> parse_format(std::string_view fmt, const bool (&is_integer)[TCount + 1])
+{
+    format_fields<TCount> result{};
+    size_t count = 0;
+    format_field field{};
+    for (size_t i = 0; i < fmt.size(); ++i) {
+        const bool doubled = (i + 1 < fmt.size()) && (fmt[i + 1] == fmt[i]);
+        if (fmt[i] == '}') {
+            if (! doubled) {
+                result.error = format_error::unmatched_brace;
+                return result;
+            }
+            field.escaped = true;
+            ++i;
+            continue;
+        }
+        if (fmt[i] != '{') {
+            continue;
+        }
+        if (doubled) {
+            field.escaped = true;
+            ++i;
+            continue;
+        }
+
+        const size_t close = fmt.find('}', i);
+        if (close == std::string_view::npos) {
+            result.error = format_error::unmatched_brace;
+            return result;
+        }
+        const std::string_view spec = fmt.substr(i + 1, close - i - 1);
+        field.conv = '\0';
+        if (! spec.empty()) {
+            if ((spec.size() != 2) || (spec[0] != ':') || ((spec[1] != 'x') && (spec[1] != 'X'))) {
+                result.error = format_error::invalid_field;
+                return result;
+            }
+            field.conv = spec[1];
+        }
+        if (count == TCount) {
+            result.error = format_error::missing_arg;
+            return result;
+        }
+        if ((field.conv != '\0') && ! is_integer[count]) {
+            result.error = format_error::not_integer;
+            return result;
+        }
+        field.end = i;
+        result.fields[count++] = field;
+        field = format_field{};
+        field.begin = close + 1;
+        i = close;
+    }
+    if (count != TCount) {
+        result.error = format_error::unused_arg;
+        return result;
+    }
+    field.end = fmt.size();
+    result.fields[count] = field;
+    return result;
+}
+
+/**
+ *  \brief  Returns the error of a format string for the argument types.
+ */
+template<typename... TArgs>
+constexpr format_error check_format(std::string_view fmt)
+{
+    constexpr bool is_integer[] = {is_hex_formattable_v<std::decay_t<TArgs>>..., false};
+    return parse_format<sizeof...(TArgs)>(fmt, is_integer).error;
+}
+
+/**
+ *  \brief  Writes the literal text before a field.
+ */
+inline void put_literal(text_buffer& buf, std::string_view fmt, const format_field& field) noexcept
+{
+    if (! field.escaped) {
+        buf.append(fmt.data() + field.begin, field.end - field.begin);
+        return;
+    }
+    for (size_t i = field.begin; i < field.end; ++i) {
+        buf.put(fmt[i]);
+        i += (fmt[i] == '{') || (fmt[i] == '}');
+    }
+}
+
+/**
+ *  \brief  Writes an argument of a field.
+ */
+template<typename TArg>
+void put_arg(text_buffer& buf, char conv, const TArg& arg) noexcept
+{
+    if constexpr (is_hex_formattable_v<TArg>) {
+        if (conv != '\0') {
+            buf.put_hex(arg, conv == 'X');
+            return;
+        }
+    }
+    buf << arg;
+}
+
+/**
+ *  \brief  Returns the thread-local buffer of records of `TSize` characters.
+ */
+template<size_t TSize>
+char* record_buffer() noexcept
+{
+    static thread_local char buf[TSize];
+    return buf;
+}
+
+} // namespace details
+
+/**
+ *  \brief  Writes the arguments into the fields of a format string.
+ *  \param  buf - output buffer.
+ *  \param  fmt - format string wrapped by \ref LW_FORMAT_STRING.
+ *  \param  args - arguments of the fields.
+ *
+ *  \details    The string is parsed at compile time, and a mismatch of the
+ *      fields and the arguments does not compile.
+ */
+template<typename TFmt, typename... TArgs>
+void format_to(text_buffer& buf, TFmt /*fmt*/, const TArgs&... args) noexcept
+{
+    using details::format_error;
+
+    static_assert((details::is_formattable<TArgs>::value && ...),
+                  "An argument type cannot be written into a text_buffer");
+    constexpr std::string_view str = TFmt::value();
+    constexpr bool is_integer[] = {details::is_hex_formattable_v<TArgs>..., false};
+    constexpr details::format_fields<sizeof...(TArgs)> parsed =
+        details::parse_format<sizeof...(TArgs)>(str, is_integer);
+    static_assert(parsed.error != format_error::unmatched_brace, "Unmatched brace in the format string");
+    static_assert(parsed.error != format_error::invalid_field, "Invalid field in the format string");
+    static_assert(parsed.error != format_error::missing_arg, "Too few arguments for the format string");
+    static_assert(parsed.error != format_error::unused_arg, "Too many arguments for the format string");
+    static_assert(parsed.error != format_error::not_integer, "Hexadecimal field of an argument which is not an integer");
+
+    size_t i = 0;
+    ((details::put_literal(buf, str, parsed.fields[i]), details::put_arg(buf, parsed.fields[i].conv, args), ++i), ...);
+    details::put_literal(buf, str, parsed.fields[i]);
+}
+
+namespace details {
+
+/**
+ *  \brief  Renders a message into the thread-local buffer of records.
+ *  \return Null-terminated message, valid until the next record of the thread.
+ */
+template<size_t TSize, typename TFmt, typename... TArgs>
+std::string_view format_message(TFmt fmt, const TArgs&... args) noexcept
+{
+    text_buffer buf(record_buffer<TSize>(), TSize);
+    format_to(buf, fmt, args...);
+    return buf.view();
+}
+
+/**
+ *  \brief  Passes a record to a backend as a single pointer and length.
+ *
+ *  \details    A `printf`-like function receives it by `"%.*s"`, a backend
+ *      with a `write(p_data, size)` member (e.g. `std::ostream`) by `write`,
+ *      and other stream-like backends by `<<` of a `std::string_view`. The
+ *      backends are flushed if they have a `flush()` member.
+ */
+template<typename TBackend>
+void write_record(TBackend& backend, const char* p_data, size_t size)
+{
+    if constexpr (std::is_invocable_v<TBackend&, const char*, int, const char*>) {
+        backend("%.*s", (int)size, p_data);
+    } else {
+        if constexpr (has_write<TBackend>::value) {
+            backend.write(p_data, size);
+        } else {
+            backend << std::string_view(p_data, size);
+        }
+        if constexpr (has_flush<TBackend>::value) {
+            backend.flush();
+        }
+    }
+}
+
+/**
+ *  \brief  Renders a record with the head of the logger into the
+ *      thread-local buffer of records.
+ *  \return Length of the record.
+ *
+ *  \details    A message which does not fit is truncated, and the record
+ *      always ends with a new line.
+ */
+template<size_t TSize, typename TLogger, typename TLevel, typename TLocation, typename TFmt, typename... TArgs>
+size_t render_formatted(TLogger&& logger, TLevel lvl, const TLocation& loc, TFmt fmt, const TArgs&... args)
+{
+    static_assert(TSize >= 2, "The record buffer is too small");
+    char* p_buf = record_buffer<TSize>();
+    const size_t head_len = logger.format_head(p_buf, TSize - 1, lvl, loc);
+    text_buffer buf(p_buf + head_len, TSize - 1 - head_len);
+    format_to(buf, fmt, args...);
+    const size_t size = head_len + buf.size();
+    p_buf[size] = '\n';
+    p_buf[size + 1] = '\0';
+    return size + 1;
+}
+
+/**
+ *  \brief  Renders a record with the head of the logger into the
+ *      thread-local buffer of records and passes it to the backend.
+ */
+template<size_t TSize, typename TLogger, typename TLevel, typename TLocation, typename TFmt, typename... TArgs>
+void log_formatted(TLogger&& logger, TLevel lvl, const TLocation& loc, TFmt fmt, const TArgs&... args)
+{
+    const size_t size = render_formatted<TSize>(logger, lvl, loc, fmt, args...);
+    write_record(logger.get_logger(), record_buffer<TSize>(), size);
+}
+
+} // namespace details
+
+} // namespace logging
+} // namespace wstux
+
+#endif /* _LIBS_LOGGING_WRAPPER_FORMAT_H_ */
@@ -24,8 +24,151 @@
 #ifndef _LIBS_LOGGING_WRAPPER_LOGGING_H_
 #define _LIBS_LOGGING_WRAPPER_LOGGING_H_
 
+#include "logging_wrapper/format.h"
 #include "logging_wrapper/manager.h"
+#include "logging_wrapper/scope.h"
 #include "logging_wrapper/severity_level.h"
+#include "logging_wrapper/structured.h"
+
+/**
+ *  \def    LOG_HEAD_LEN
+ *  \brief  Size of the buffer of the record head of the default
+ *      implementations. A longer head is truncated.
+ */
+#if ! defined(LOG_HEAD_LEN)
+    #define LOG_HEAD_LEN        256
+#endif
+
+/**
+ *  \def    LOG_RECORD_LEN
+ *  \brief  Size of the thread-local buffer of the records of the
+ *      `{}`-style formatting macros. A longer record is truncated.
+ */
+#if ! defined(LOG_RECORD_LEN)
+    #define LOG_RECORD_LEN      4096
+#endif
+
+/**
+ *  \def    _LW_SOURCE_LOCATION
+ *  \brief  Location of the logging statement.
+ *  \note   Intended solely for internal use.
+ */
+#define _LW_SOURCE_LOCATION                                                 \
+    ::wstux::logging::details::source_location{__FILE__, __LINE__, __func__}
+
+/*******************************************************************************
+ *  Scope buffers
+ ******************************************************************************/
+
+#if defined(LOG_DISABLE_SCOPES)
+    #define _LOGF_SCOPE(logger, level, fmt, ...)
+    #define _LOG_SCOPE(logger, level, VARS)
+    #define _LOGFMT_SCOPE(logger, level, fmt, ...)
+    #define _LOG_KV_SCOPE(logger, level, msg, ...)
+#else
+    /**
+     *  \def    _LOGF_SCOPE(logger, level, fmt, ...)
+     *  \brief  Keeps a filtered out C-style record in the active scope of the
+     *      thread, if the level of the scope permits it.
+     *  \note   Intended solely for internal use.
+     *
+     *  \details    The kept records are rendered in the layout of the manager,
+     *      also when a custom implementation is set. Define `LOG_DISABLE_SCOPES`
+     *      to remove the check of the scope from filtered out records.
+     */
+    #define _LOGF_SCOPE(logger, level, fmt, ...)                            \
+        if (::wstux::logging::details::scope_captures(SEVERITY_LEVEL(level))) { \
+            char _lw_head[LOG_HEAD_LEN];                                    \
+            const size_t _lw_head_len = logger.format_head(                 \
+                _lw_head, LOG_HEAD_LEN, SEVERITY_LEVEL(level), _LW_SOURCE_LOCATION); \
+            ::wstux::logging::details::scope_printf(                        \
+                ::wstux::logging::details::make_scope_sink(logger.get_logger()), \
+                _lw_head, _lw_head_len, fmt "\n" __VA_OPT__(,) __VA_ARGS__); \
+        }
+
+    /**
+     *  \def    _LOG_SCOPE(logger, level, VARS)
+     *  \brief  Keeps a filtered out CPP-style record in the active scope of the
+     *      thread, if the level of the scope permits it.
+     *  \note   Intended solely for internal use.
+     */
+    #define _LOG_SCOPE(logger, level, VARS)                                 \
+        if (::wstux::logging::details::scope_captures(SEVERITY_LEVEL(level))) { \
+            char _lw_head[LOG_HEAD_LEN];                                    \
+            const size_t _lw_head_len = logger.format_head(                 \
+                _lw_head, LOG_HEAD_LEN, SEVERITY_LEVEL(level), _LW_SOURCE_LOCATION); \
+            ::wstux::logging::details::scope_stream(_lw_head, _lw_head_len) << VARS; \
+            ::wstux::logging::details::scope_stream_end(                    \
+                ::wstux::logging::details::make_scope_sink(logger.get_logger())); \
+        }
+
+    /**
+     *  \def    _LOGFMT_SCOPE(logger, level, fmt, ...)
+     *  \brief  Keeps a filtered out record of a `{}`-style format string in the
+     *      active scope of the thread, if the level of the scope permits it.
+     *  \note   Intended solely for internal use.
+     */
+    #define _LOGFMT_SCOPE(logger, level, fmt, ...)                          \
+        if (::wstux::logging::details::scope_captures(SEVERITY_LEVEL(level))) { \
+            ::wstux::logging::details::scope_formatted<LOG_RECORD_LEN>(     \
+                logger, SEVERITY_LEVEL(level), _LW_SOURCE_LOCATION,         \
+                LW_FORMAT_STRING(fmt) __VA_OPT__(,) __VA_ARGS__);           \
+        }
+
+    /**
+     *  \def    _LOG_KV_SCOPE(logger, level, msg, ...)
+     *  \brief  Keeps a filtered out structured record in the active scope of
+     *      the thread, if the level of the scope permits it.
+     *  \note   Intended solely for internal use.
+     */
+    #define _LOG_KV_SCOPE(logger, level, msg, ...)                          \
+        if (::wstux::logging::details::scope_captures(SEVERITY_LEVEL(level))) { \
+            ::wstux::logging::details::scope_kv<LOG_RECORD_LEN>(            \
+                logger, SEVERITY_LEVEL(level), _LW_SOURCE_LOCATION,         \
+                msg __VA_OPT__(,) __VA_ARGS__);                             \
+        }
+#endif
+
+/*******************************************************************************
+ *  Verbosity bursts
+ ******************************************************************************/
+
+#if defined(LOG_DISABLE_BURSTS)
+    #define _LOG_IS_ENABLED(logger, level)                                  \
+        (::wstux::logging::manager::cal_log(level) && logger.can_log(level))
+    #define _LOG_BURST(logger, level)
+#else
+    /**
+     *  \def    _LOG_IS_ENABLED(logger, level)
+     *  \brief  Level check of a statement: the global and the channel levels
+     *      permit the level, or the burst of the channel does.
+     *  \note   Intended solely for internal use.
+     *
+     *  \details    The burst of the channel is read only for a record, which
+     *      the levels filter out, and only while the bursts are enabled up to
+     *      its level.
+     */
+    #define _LOG_IS_ENABLED(logger, level)                                  \
+        ((::wstux::logging::manager::cal_log(level) && logger.can_log(level)) \
+         || (::wstux::logging::manager::can_burst(level) && logger.is_bursting(level)))
+
+    /**
+     *  \def    _LOG_BURST(logger, level)
+     *  \brief  Triggers the verbosity burst of the channel of an error record
+     *      (see \ref wstux::logging::manager::enable_burst).
+     *  \note   Intended solely for internal use.
+     *
+     *  \details    Follows a written record. While the bursts are disabled,
+     *      \ref wstux::logging::manager::on_error reads only the burst level of
+     *      the manager. The C
+     *      macros use `_LOGF_BURST` of `loggingf_wrapper/logging.h`, which
+     *      triggers the engine of the C manager instead.
+     */
+    #define _LOG_BURST(logger, level)                                       \
+        if (SEVERITY_LEVEL(level) <= ::wstux::logging::severity_level::error) { \
+            ::wstux::logging::manager::on_error(logger.channel());          \
+        }
+#endif
 
 /*******************************************************************************
  *  Logging for loggers in C-style
@@ -64,7 +207,8 @@
      *  \param  fmt - format string (printf-style).
      *  \param  ... - variadic arguments for the format string.
      *
-     *  \details    Generates a log string in the standard format:
+     *  \details    Generates a log string with the head in the layout of the
+     *      manager, by default in the standard format:
      *          `YYYY-MM-DD HH:MM:SS.mmm [S_LVL] Channel: message`
      *
      *  Where,
@@ -72,12 +216,14 @@
      *  S_LVL - severity level;
      *  Channel - channel name;
      *  message - user's message.
+     *
+     *  The static parts of the head are precomputed per channel and level.
      */
     #define _LOGGINGF_WRAPPER_IMPL(logger, level, fmt, ...)                 \
-        char cur_ts[24];                                                    \
-        ::wstux::logging::manager::timestamp(cur_ts, 24);                   \
-        logger.get_logger()("%s " LOGF_LEVEL(level) " %s: " fmt "\n",       \
-                            cur_ts, logger.channel().c_str() __VA_OPT__(,) __VA_ARGS__)
+        char _lw_head[LOG_HEAD_LEN];                                        \
+        logger.format_head(_lw_head, LOG_HEAD_LEN, SEVERITY_LEVEL(level),   \
+                           _LW_SOURCE_LOCATION);                            \
+        logger.get_logger()("%s" fmt "\n", _lw_head __VA_OPT__(,) __VA_ARGS__)
 #endif
 
 /**
@@ -93,16 +239,21 @@
  *      not evaluated (lazy evaluation).
  *
  *  \details    First checks the global logging level, then the level of the
- *      specific channel. If the checks pass, evaluates the arguments and forwards
- *      them to the logger implementation.
+ *      specific channel, and then the verbosity burst of the channel (see
+ *      \ref _LOG_IS_ENABLED). If the checks pass, evaluates the arguments and forwards
+ *      them to the logger implementation. Otherwise the record may be kept by
+ *      the active scope buffer of the thread (see `logging_wrapper/scope.h`),
+ *      and then its arguments are evaluated too. An error record triggers the
+ *      verbosity burst of its channel.
  */
 #define _LOGF(logger, level, fmt, ...)                                      \
     do {                                                                    \
-        if (! ::wstux::logging::manager::cal_log(SEVERITY_LEVEL(level)) ||  \
-            ! logger.can_log(SEVERITY_LEVEL(level))) {                      \
+        if (! _LOG_IS_ENABLED(logger, SEVERITY_LEVEL(level))) {             \
+            _LOGF_SCOPE(logger, level, fmt, __VA_ARGS__)                    \
             break;                                                          \
         }                                                                   \
         _LOGGINGF_WRAPPER_IMPL(logger, level, fmt, __VA_ARGS__);            \
+        _LOG_BURST(logger, level)                                           \
     }                                                                       \
     while (0)
 
@@ -139,18 +290,21 @@
      *  \param  level - severity level for the log entry.
      *
      *  \details    Formats and returns the beginning of the log string stream
-     *      in the format:
+     *      in the layout of the manager, by default in the format:
      *          `YYYY-MM-DD HH:MM:SS.mmm [S_LVL] Channel: `
      *
      *  Where,
      *  YYYY-MM-DD HH:MM:SS.mmm - time stamp in format yyyy-mm-dd HH:MM:SS.mmm;
      *  S_LVL - severity level;
      *  Channel - channel name.
+     *
+     *  The static parts of the head are precomputed per channel and level.
      */
     #define _LOGGING_WRAPPER_IMPL(logger, level)                            \
-        logger.get_logger() << ::wstux::logging::manager::timestamp() << " "\
-                            << LOG_LEVEL(level) << " " << logger.channel()  \
-                            << ": "
+        char _lw_head[LOG_HEAD_LEN];                                        \
+        logger.format_head(_lw_head, LOG_HEAD_LEN, SEVERITY_LEVEL(level),   \
+                           _LW_SOURCE_LOCATION);                            \
+        logger.get_logger() << (const char*)_lw_head
 #endif
 
 /**
@@ -164,16 +318,134 @@
  *      level permits recording (lazy evaluation).
  *
  *  \details    details First checks the global logging level, then the level of
- *      the specific channel. Upon success, outputs the VARS expression into the
- *      logger stream and terminates the line with std::endl.
+ *      the specific channel, and then the verbosity burst of the channel. Upon success, outputs the VARS expression into the
+ *      logger stream and terminates the line with std::endl. Otherwise the
+ *      record may be kept by the active scope buffer of the thread.
  */
 #define _LOG(logger, level, VARS)                                           \
     do {                                                                    \
-        if (! ::wstux::logging::manager::cal_log(SEVERITY_LEVEL(level)) ||  \
-            ! logger.can_log(SEVERITY_LEVEL(level))) {                      \
+        if (! _LOG_IS_ENABLED(logger, SEVERITY_LEVEL(level))) {             \
+            _LOG_SCOPE(logger, level, VARS)                                 \
             break;                                                          \
         }                                                                   \
         _LOGGING_WRAPPER_IMPL(logger, level) << VARS << std::endl;          \
+        _LOG_BURST(logger, level)                                           \
+    }                                                                       \
+    while (0)
+
+/*******************************************************************************
+ *  Logging with {}-style format strings
+ ******************************************************************************/
+
+#if defined(LOGGINGFMT_WRAPPER_IMPL)
+    /**
+     *  \def    _LOGGINGFMT_WRAPPER_IMPL(logger, level, fmt, ...)
+     *  \brief  Internal macro to pass a message rendered from a `{}`-style
+     *      format string to the custom logging implementation.
+     *  \param  logger - logger object providing the channel and write method.
+     *  \param  level - severity level for the log entry.
+     *  \param  fmt - format string literal (`{}`-style).
+     *  \param  ... - arguments of the fields of the format string.
+     *
+     *  \details    The message is rendered into the thread-local buffer of
+     *      records, and the custom implementation receives a pointer to the
+     *      null-terminated message and its length.
+     *
+     *  \code
+     *  #define LOGGINGFMT_WRAPPER_IMPL(logger, level, p_msg, size)            \
+     *      logger.get_logger().write(level, p_msg, size)
+     *
+     *  #include <logging_wrapper/logging.h>
+     *  \endcode
+     */
+    #define _LOGGINGFMT_WRAPPER_IMPL(logger, level, fmt, ...)               \
+        const ::std::string_view _lw_msg =                                  \
+            ::wstux::logging::details::format_message<LOG_RECORD_LEN>(      \
+                LW_FORMAT_STRING(fmt) __VA_OPT__(,) __VA_ARGS__);           \
+        LOGGINGFMT_WRAPPER_IMPL(logger, level, _lw_msg.data(), _lw_msg.size())
+#else
+    /**
+     *  \def    _LOGGINGFMT_WRAPPER_IMPL(logger, level, fmt, ...)
+     *  \brief  Default implementation of logging with `{}`-style format strings.
+     *  \param  logger - logger object providing the channel and write method.
+     *  \param  level - severity level for the log entry.
+     *  \param  fmt - format string literal (`{}`-style).
+     *  \param  ... - arguments of the fields of the format string.
+     *
+     *  \details    Renders the head in the layout of the manager, the message
+     *      and the new line into the thread-local buffer of records, and passes
+     *      the record to the logger as a single pointer and length: a
+     *      `printf`-like logger receives it by `"%.*s"`, a stream by `write()`.
+     *      No memory is allocated.
+     */
+    #define _LOGGINGFMT_WRAPPER_IMPL(logger, level, fmt, ...)               \
+        ::wstux::logging::details::log_formatted<LOG_RECORD_LEN>(           \
+            logger, SEVERITY_LEVEL(level), _LW_SOURCE_LOCATION,             \
+            LW_FORMAT_STRING(fmt) __VA_OPT__(,) __VA_ARGS__)
+#endif
+
+/**
+ *  \def    _LOGFMT(logger, level, fmt, ...)
+ *  \brief  Base filtering and recording macro for `{}`-style format strings.
+ *  \param  logger - logger object for recording.
+ *  \param  level - required logging level.
+ *  \param  fmt - format string literal.
+ *  \param  ... - arguments of the fields of the format string.
+ *
+ *  \attention  Log argument expressions are evaluated **only** if the current
+ *      logging level permits recording (lazy evaluation).
+ *
+ *  \details    The format string is checked against the argument types at
+ *      compile time. See `logging_wrapper/format.h` for the syntax. A filtered
+ *      out record may be kept by the active scope buffer of the thread.
+ */
+#define _LOGFMT(logger, level, fmt, ...)                                    \
+    do {                                                                    \
+        if (! _LOG_IS_ENABLED(logger, SEVERITY_LEVEL(level))) {             \
+            _LOGFMT_SCOPE(logger, level, fmt, __VA_ARGS__)                  \
+            break;                                                          \
+        }                                                                   \
+        _LOGGINGFMT_WRAPPER_IMPL(logger, level, fmt, __VA_ARGS__);          \
+        _LOG_BURST(logger, level)                                           \
+    }                                                                       \
+    while (0)
+
+/*******************************************************************************
+ *  Structured logging
+ ******************************************************************************/
+
+/**
+ *  \def    LOG_KV(logger, level, msg, ...)
+ *  \brief  Records a structured message with typed key-value fields.
+ *  \param  logger - logger object for recording.
+ *  \param  level - severity level name: `EMERG`, `FATAL`, `CRIT`, `ERROR`,
+ *      `WARN`, `NOTICE`, `INFO`, `DEBUG` or `TRACE`.
+ *  \param  msg - message.
+ *  \param  ... - fields created by `::wstux::logging::kv(key, value)`.
+ *
+ *  \attention  Field expressions are evaluated **only** if the current
+ *      logging level permits recording (lazy evaluation).
+ *
+ *  \details    The fields are encoded in binary into a thread-local buffer of
+ *      `LOG_RECORD_LEN` bytes: numbers are not converted to text in the
+ *      logging thread unless the backend has no `write_kv` member. See
+ *      `logging_wrapper/structured.h`.
+ *
+ *  \code
+ *  using ::wstux::logging::kv;
+ *  LOG_KV(logger, INFO, "request done", kv("ms", elapsed_ms), kv("code", 200));
+ *  \endcode
+ */
+#define LOG_KV(logger, level, msg, ...)                                     \
+    do {                                                                    \
+        if (! _LOG_IS_ENABLED(logger, SEVERITY_LEVEL(LVL_ ## level))) {     \
+            _LOG_KV_SCOPE(logger, LVL_ ## level, msg, __VA_ARGS__)          \
+            break;                                                          \
+        }                                                                   \
+        ::wstux::logging::details::log_kv<LOG_RECORD_LEN>(                  \
+            logger, SEVERITY_LEVEL(LVL_ ## level), _LW_SOURCE_LOCATION,     \
+            msg __VA_OPT__(,) __VA_ARGS__);                                 \
+        _LOG_BURST(logger, LVL_ ## level)                                   \
     }                                                                       \
     while (0)
 
@@ -452,4 +724,50 @@
 
 /** \}*/
 
+/**
+ *  \defgroup   FmtLogging Formatted Cpp Logging API ({}-style)
+ *  \brief  Macros for recording log messages of various severity levels. Macros
+ *      that accept a `{}`-style format string literal and its arguments, which
+ *      are checked at compile time.
+ *
+ * **List of logging macros:**
+ * - \ref LOGFMT_EMERG()    - critical system error (Emergency)
+ * - \ref LOGFMT_FATAL()    - fatal error (Fatal)
+ * - \ref LOGFMT_CRIT()     - critical condition (Critical)
+ * - \ref LOGFMT_ERROR()    - standard error (Error)
+ * - \ref LOGFMT_WARN()     - warning (Warning)
+ * - \ref LOGFMT_NOTICE()   - important notification (Notice)
+ * - \ref LOGFMT_INFO()     - informational message (Info)
+ * - \ref LOGFMT_DEBUG()    - debugging information (Debug)
+ * - \ref LOGFMT_TRACE()    - trace logging (Trace)
+ *
+ *  \code
+ *  LOGFMT_ERROR(logger, "Failed with code: {} and status: {}", 404, "Not Found");
+ *  LOGFMT_DEBUG(logger, "Flags {:x}, ratio {}", flags, 0.75);
+ *  \endcode
+ *
+ *  \{
+ */
+
+/// \brief  Logs a critical system error (Emergency).
+#define LOGFMT_EMERG(logger, fmt, ...)      _LOGFMT(logger, LVL_EMERG,  fmt, __VA_ARGS__)
+/// \brief  Logs a fatal error (Fatal).
+#define LOGFMT_FATAL(logger, fmt, ...)      _LOGFMT(logger, LVL_FATAL,  fmt, __VA_ARGS__)
+/// \brief  Logs a critical condition (Critical).
+#define LOGFMT_CRIT(logger, fmt, ...)       _LOGFMT(logger, LVL_CRIT,   fmt, __VA_ARGS__)
+/// \brief  Logs a standard error (Error).
+#define LOGFMT_ERROR(logger, fmt, ...)      _LOGFMT(logger, LVL_ERROR,  fmt, __VA_ARGS__)
+/// \brief  Logs a warning (Warning).
+#define LOGFMT_WARN(logger, fmt, ...)       _LOGFMT(logger, LVL_WARN,   fmt, __VA_ARGS__)
+/// \brief  Logs an important notification (Notice).
+#define LOGFMT_NOTICE(logger, fmt, ...)     _LOGFMT(logger, LVL_NOTICE, fmt, __VA_ARGS__)
+/// \brief  Logs an informational message (Info).
+#define LOGFMT_INFO(logger, fmt, ...)       _LOGFMT(logger, LVL_INFO,   fmt, __VA_ARGS__)
+/// \brief  Logs debugging information (Debug).
+#define LOGFMT_DEBUG(logger, fmt, ...)      _LOGFMT(logger, LVL_DEBUG,  fmt, __VA_ARGS__)
+/// \brief  Trace logging (Trace).
+#define LOGFMT_TRACE(logger, fmt, ...)      _LOGFMT(logger, LVL_TRACE,  fmt, __VA_ARGS__)
+
+/** \}*/
+
 #endif /* _LIBS_LOGGING_WRAPPER_LOGGING_H_ */
@@ -24,16 +24,28 @@
 #ifndef _LIBS_LOGGING_WRAPPER_MANAGER_H_
 #define _LIBS_LOGGING_WRAPPER_MANAGER_H_
 
-#include <cassert>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "logging_wrapper/severity_level.h"
+#include "loggingf_wrapper/burst.h"
+
+/**
+ *  \def    LOG_DEFAULT_LAYOUT
+ *  \brief  Default layout pattern of the record head:
+ *      `YYYY-MM-DD HH:MM:SS.mmm [S_LVL] Channel: `.
+ */
+#define LOG_DEFAULT_LAYOUT      "%T %l %c: "
 
 namespace wstux {
 namespace logging {
@@ -104,28 +116,153 @@ namespace logging {
 namespace details {
 
 ////////////////////////////////////////////////////////////////////////////////
-/// \struct base_logger
+/// \struct source_location
+
+/**
+ *  \brief  Location of a logging statement in the source code.
+ */
+struct source_location final
+{
+    const char* file;     ///< Source file name.
+    int line;             ///< Line number.
+    const char* function; ///< Function name.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \struct layout
 
 /**
- *  \brief  Abstract base class for managing the metadata of an individual
- *      logging channel.
+ *  \brief  Layout pattern of the head of records, compiled into a flat
+ *      sequence of operations.
+ *
+ *  \details    The fields which depend only on the channel and the level
+ *      (texts, level and channel) are merged into static segments, which are
+ *      rendered once per channel into its `record_prefix`. The remaining
+ *      operations format the per-record fields. A compiled layout is immutable
+ *      and lives until the end of the program.
+ */
+struct layout final
+{
+    /// \brief  Operation executed for every record.
+    struct op final
+    {
+        /// \brief  Kinds of operations.
+        enum kind_t : uint8_t
+        {
+            segment,   /**< Static segment with the index `arg` */
+            timestamp, /**< Timestamp with `arg` fractional digits */
+            thread_id, /**< Identifier of the calling thread */
+            source,    /**< Source location in the `file:line` format */
+            function   /**< Function name */
+        };
+
+        kind_t kind;  ///< Kind of the operation.
+        uint16_t arg; ///< Argument of the operation.
+    };
+
+    /// \brief  Field of a static segment.
+    struct field final
+    {
+        /// \brief  Kinds of fields.
+        enum kind_t : uint8_t
+        {
+            literal,    /**< Literal text */
+            level_tag,  /**< Level tag of fixed width, e.g. `[INFO ]` */
+            level_name, /**< Level name, e.g. `INFO` */
+            channel     /**< Channel name padded to `width` */
+        };
+
+        kind_t kind;      ///< Kind of the field.
+        uint16_t width;   ///< Minimum width of the channel name.
+        std::string text; ///< Literal text.
+    };
+
+    std::string pattern;                      ///< Source pattern.
+    std::vector<op> ops;                      ///< Operations in the order of output.
+    std::vector<std::vector<field>> segments; ///< Fields of the static segments.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \struct record_prefix
+
+/**
+ *  \brief  Ready-made static segments of the record head of a channel for
+ *      all severity levels.
+ *
+ *  \details    For the default layout the only segment is the part of a record
+ *      which follows the timestamp, e.g. `" [INFO ] Root: "`. The table is
+ *      immutable once published.
+ */
+struct record_prefix final
+{
+    const layout* p_layout;                              ///< Layout the segments are built for.
+    std::vector<std::string> segments[LVL_TRACE + 1];    ///< Static segments by severity level.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class prefix_cache
+
+/**
+ *  \brief  Precomputed record prefixes of a channel.
+ *
+ *  \details    The table is built on the first use and rebuilt on the first
+ *      use after the layout of records has changed. Superseded tables are kept
+ *      until the cache is destroyed, as other threads may still be reading
+ *      them, so a lookup is a single atomic load without locking.
+ */
+class prefix_cache final
+{
+public:
+    /// \brief  Constructor for the prefix cache.
+    /// \param  channel - name of the channel, which must outlive the cache.
+    explicit prefix_cache(const std::string& channel)
+        : m_channel(channel)
+        , m_p_prefix(nullptr)
+    {}
+
+    /// \brief  Returns the record prefix of the channel for the current layout.
+    inline const record_prefix& get();
+
+private:
+    /// \brief  Builds and publishes the table for the current layout.
+    const record_prefix* rebuild();
+
+    // Copy and assignment are deleted (Copy Semantics disabled)
+    prefix_cache(const prefix_cache&);
+    prefix_cache& operator=(const prefix_cache&);
+
+private:
+    const std::string& m_channel;                  ///< Channel name.
+    std::atomic<const record_prefix*> m_p_prefix;  ///< Current table.
+    std::mutex m_mutex;                            ///< Mutex serializing the rebuilds.
+    std::vector<std::unique_ptr<record_prefix>> m_tables; ///< All tables built by the cache.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \struct channel_state
+
+/**
+ *  \brief  Metadata of an individual logging channel.
  *
  *  \details Stores the channel name and its current log filtering level. The
  *      logging level is thread-safe (std::atomic), allowing it to be changed
- *      dynamically at runtime.
+ *      dynamically at runtime. The state is shared by the loggers of all types
+ *      bound to the channel.
  */
-struct base_logger
+struct channel_state final
 {
     using severity_level_t = std::atomic<severity_level>; ///< Data type for atomic storage of the logging level.
-    using ptr = std::shared_ptr<base_logger>;             ///< Smart pointer to the base logger.
-
-    /// \brief  Destructor.
-    virtual ~base_logger() {}
+    using ptr = std::shared_ptr<channel_state>;           ///< Smart pointer to the channel state.
 
-    /// \brief  Logging level check function.
-    /// \param  lvl - required severity level.
-    /// \return True, if the required severity level corresponds to the requested.
-    ///     Otherwise, false.
+    /// \brief  Constructor for the channel state.
+    /// \param  ch - name of the logging channel.
+    /// \param  lvl - initial severity level for the channel.
+    channel_state(const std::string& ch, const severity_level lvl)
+        : channel(ch)
+        , level(lvl)
+        , burst_level(-1)
+        , prefixes(channel)
+    {}
 
     /// \brief  Checks if the specified logging level is enabled for the current channel.
     /// \param  lvl - required severity level for recording.
@@ -134,22 +271,21 @@ struct base_logger
     ///     should be filtered out and ignored.
     inline bool can_log(severity_level lvl) const { return level >= lvl; }
 
+    /// \brief  Checks if the active burst of the channel permits the level.
+    inline bool is_bursting(severity_level lvl) const
+    {
+        return burst_level.load(std::memory_order_relaxed) >= (int)lvl;
+    }
+
     const std::string channel;  ///< Channel name.
     severity_level_t level;     ///< Severity level for this channel.
-
-protected:
-    /// \brief  Protected constructor for invocation by derived classes.
-    /// \param  ch - name of the logging channel.
-    /// /param  lvl - initial severity level for the channel.
-    base_logger(const std::string& ch, const severity_level lvl)
-        : channel(ch)
-        , level(lvl)
-    {}
+    std::atomic_int burst_level; ///< Level of the active burst of the channel, or -1.
+    prefix_cache prefixes;      ///< Record prefixes of the channel.
 
 private:
     // Copy and assignment are deleted (Copy Semantics disabled)
-    base_logger(const base_logger&);
-    base_logger& operator=(const base_logger&);
+    channel_state(const channel_state&);
+    channel_state& operator=(const channel_state&);
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -159,30 +295,100 @@ private:
  *  \brief  Wrapper around a specific custom logger implementation.
  *  \tparam TLogger - custom logger type.
  *
- *  \details    Implements the Concrete Strategy pattern, encapsulating any
- *      third-party logger object within the polymorphic base_logger interface.
+ *  \details    Binds an instance of the custom logger to the shared state of
+ *      its channel. A channel holds one implementation per logger type, so
+ *      the C-style and CPP-style loggers of one channel do not interfere.
  */
 template<typename TLogger>
-struct logger_impl final : public base_logger
+struct logger_impl final
 {
     using logger_type = TLogger;              ///< Type alias for the encapsulated custom logger.
     using ptr = std::shared_ptr<logger_impl>; ///< Smart pointer to the specific wrapper implementation.
 
     /// \brief  Constructor for the logger implementation.
-    /// \param  channel - name of the logging channel.
-    /// \param  lvl - initial severity level for the channel.
-    /// \details Initializes the base parameters and automatically creates the
-    ///     custom logger object using the specialized factory function
-    ///     `make_logger<TLogger>`.
-    logger_impl(const std::string& channel, severity_level lvl)
-        : base_logger(channel, lvl)
-        , logger(make_logger<logger_type>(channel))
+    /// \param  p_ch_state - shared state of the logging channel.
+    /// \details Automatically creates the custom logger object using the
+    ///     specialized factory function `make_logger<TLogger>`.
+    explicit logger_impl(const channel_state::ptr& p_ch_state)
+        : p_state(p_ch_state)
+        , logger(make_logger<logger_type>(p_ch_state->channel))
     {}
 
-    /// \brief  Destructor.
-    virtual ~logger_impl() {}
+    /// \brief  Checks if the specified logging level is enabled for the channel.
+    inline bool can_log(severity_level lvl) const { return p_state->can_log(lvl); }
 
-    logger_type logger; ///< Instance of the actual custom logger.
+    /// \brief  Checks if the active burst of the channel permits the level.
+    inline bool is_bursting(severity_level lvl) const { return p_state->is_bursting(lvl); }
+
+    const channel_state::ptr p_state; ///< Shared state of the channel.
+    logger_type logger;               ///< Instance of the actual custom logger.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \struct logger_slot
+
+/**
+ *  \brief  Dense index of the slot of a logger type within a channel.
+ *
+ *  \details    The indices are assigned once per logger type on its first use
+ *      and are the same for all channels, so the implementation of a type is
+ *      found by indexing without any type check.
+ */
+struct logger_slot final
+{
+    /// \brief  Returns the slot index of the logger type.
+    /// \tparam TLogger - custom logger type.
+    template<typename TLogger>
+    static size_t index()
+    {
+        static const size_t idx = next_index();
+        return idx;
+    }
+
+private:
+    /// \brief  Returns the next unused slot index.
+    static size_t next_index()
+    {
+        static std::atomic<size_t> next = {0};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \struct static_table
+
+/**
+ *  \brief  Descriptor of a channel list declared at compile time.
+ *
+ *  \details    Links the names and the levels of a `static_channels` list into
+ *      the registry of the manager, which applies level changes by channel name
+ *      to them. The descriptor is constant-initialized and linked on the first
+ *      use of the list, so the registration does not allocate.
+ */
+struct static_table final
+{
+    const std::string_view* p_names;       ///< Channel names by index.
+    std::atomic<severity_level>* p_levels; ///< Channel levels by index.
+    std::atomic_int* p_bursts;             ///< Burst levels by index, or -1.
+    size_t size;                           ///< Number of channels.
+    static_table* p_next;                  ///< Next registered list.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \struct level_array
+
+/**
+ *  \brief  Contiguous array of channel levels, constant-initialized to `debug`.
+ *  \tparam TSeq - index sequence of the channels.
+ */
+template<typename TSeq>
+struct level_array;
+
+template<size_t... I>
+struct level_array<std::index_sequence<I...>> final
+{
+    std::atomic<severity_level> levels[sizeof...(I)] = {((void)I, severity_level::debug)...}; ///< Levels by channel index.
+    std::atomic_int bursts[sizeof...(I)] = {((void)I, -1)...}; ///< Burst levels by channel index, or -1.
 };
 
 } // namespace details
@@ -195,9 +401,9 @@ struct logger_impl final : public base_logger
  *  \tparam TLogger - custom logger type wrapped by this interface.
  *
  *  \details    This class is designed as a cheap-to-copy descriptor. It conceals
- *      a polymorphic pointer to `logger_impl`, effectively erasing the underlying
- *      logger type differences. It allows uniform handling of both stream-based
- *      (CPP-style) and printf-like (C-style) loggers.
+ *      a typed pointer to `logger_impl`. It allows uniform handling of both
+ *      stream-based (CPP-style) and printf-like (C-style) loggers, and loggers
+ *      of both styles may be bound to the same channel.
  *
  *  \attention  For this class to operate correctly, an explicit specialization
  *      of the `make_logger<TLogger>` function must be declared for the `TLogger`
@@ -243,9 +449,27 @@ struct logger final
     /// \return true if recording is permitted, false otherwise.
     bool can_log(severity_level lvl) const { return p_logger_impl->can_log(lvl); }
 
+    /// \brief  Checks if the active burst of the channel permits the level,
+    ///     whatever the global and the channel levels are.
+    bool is_bursting(severity_level lvl) const { return p_logger_impl->is_bursting(lvl); }
+
     /// \brief  Retrieves the channel name of the current logger.
     /// \return Reference to a constant string containing the channel name.
-    const std::string& channel() const { return p_logger_impl->channel; }
+    const std::string& channel() const { return p_logger_impl->p_state->channel; }
+
+    /// \brief  Writes the head of a record in the layout of the manager.
+    /// \param  buf - output buffer.
+    /// \param  size - size of the buffer.
+    /// \param  lvl - severity level of the record.
+    /// \param  loc - location of the logging statement.
+    /// \return Length of the null-terminated head.
+    size_t format_head(char* buf, size_t size, severity_level lvl, const details::source_location& loc) const;
+
+    /// \brief  Retrieves the precomputed static segments of the record head
+    ///     of the channel for a severity level.
+    /// \param  lvl - severity level of the record.
+    /// \return For the default layout, a single segment, e.g. `" [INFO ] Root: "`.
+    const std::vector<std::string>& prefix(severity_level lvl) const { return p_logger_impl->p_state->prefixes.get().segments[lvl]; }
 
     /// \brief  Provides direct access to the custom logger object.
     /// \return Reference to the instance of the custom `TLogger` class.
@@ -263,6 +487,21 @@ struct logger final
     {}
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// \struct burst_config
+
+/**
+ *  \brief  Configuration of the error-triggered verbosity bursts (see
+ *      \ref manager::enable_burst).
+ */
+struct burst_config final
+{
+    severity_level level = severity_level::debug;                    ///< Level up to which a channel writes during a burst.
+    std::chrono::milliseconds window = std::chrono::seconds(30);     ///< Duration of a burst.
+    std::chrono::milliseconds cooldown = std::chrono::minutes(5);    ///< Time after a burst, during which the channel does not burst again.
+    uint32_t max_active = 8;                                         ///< Maximum number of channels bursting at once, or 0 for no limit.
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \class manager
 
@@ -300,18 +539,49 @@ public:
     ///     granular channel checks.
     static bool cal_log(severity_level lvl) { return m_global_level >= lvl; }
 
+    /// \brief  Checks if the bursts are enabled up to the level, so a channel
+    ///     may write a record of the level past the global level.
+    /// \param  lvl - required severity level.
+    static bool can_burst(severity_level lvl) { return m_burst_level.load(std::memory_order_relaxed) >= (int)lvl; }
+
     /// \brief  Deinitialization of the log manager.
     /// \details    Clears the internal map of registered loggers, resetting all
-    ///     held `shared_ptr` smart pointers.
+    ///     held `shared_ptr` smart pointers. Disables the verbosity bursts.
     static void deinit();
 
+    /// \brief  Disables the error-triggered verbosity bursts and ends the
+    ///     bursts of the channels.
+    static void disable_burst();
+
+    /// \brief  Enables the error-triggered verbosity bursts.
+    /// \param  cfg - configuration of the bursts.
+    /// \return true if the bursts are enabled, false if the configuration is
+    ///     invalid or the housekeeping thread cannot be started.
+    /// \details    When a channel logs a record of the level `error` or more
+    ///     severe, the channel writes the records up to `cfg.level` for
+    ///     `cfg.window`, whatever the global and the channel levels are. The
+    ///     burst level is kept in the channel state apart from its level, so
+    ///     \ref set_logger_level during a burst takes effect once it ends. A
+    ///     housekeeping thread ends the bursts on a timer wheel with the
+    ///     resolution of `LOG_BURST_TICK_MS` milliseconds.
+    ///
+    ///     Later errors do not extend a burst. A channel does not burst again
+    ///     for `cfg.cooldown` after its burst ends, and at most `cfg.max_active`
+    ///     channels burst at once, so an error storm cannot keep channels
+    ///     verbose.
+    ///
+    ///     The manager owns an engine of `loggingf_wrapper/burst.h`, apart from
+    ///     the one of the C manager.
+    static bool enable_burst(const burst_config& cfg = burst_config());
+
     /// \brief  Retrieves or creates a logger for the specified channel.
     /// \tparam TLogger - the external handle class of the logger (`wstux::logging::logger<T>`).
     /// \param  channel - unique name of the logging channel.
     /// \return A logger descriptor object ready for use.
     /// \details    If a channel with the given name already exists, the associated
     ///     logger is returned. If the channel does not exist, it is registered
-    ///     with the default level `severity_level::debug`.
+    ///     with the level of the channel of a list declared at compile time,
+    ///     or with the default level `severity_level::debug`.
     template<typename TLogger>
     static TLogger get_logger(const std::string& channel);
 
@@ -329,10 +599,48 @@ public:
     /// \return The current value of the `severity_level` enumeration.
     static severity_level global_level() { return m_global_level; }
 
+    /// \brief  Writes the head of a record in the current layout.
+    /// \param  buf - output buffer.
+    /// \param  size - size of the buffer. A longer head is truncated.
+    /// \param  prefix - precomputed record prefix of the channel.
+    /// \param  lvl - severity level of the record.
+    /// \param  loc - location of the logging statement.
+    /// \return Length of the null-terminated head.
+    /// \details    Executes the operations of the layout the prefix is built
+    ///     for: static segments are copied from the prefix, and the timestamp,
+    ///     the thread id and the source location are formatted in place.
+    static size_t format_head(char* buf, size_t size, const details::record_prefix& prefix,
+                              severity_level lvl, const details::source_location& loc);
+
+    /// \brief  Returns the number of the channels in the registry.
+    static size_t logger_count();
+
     /// \brief  Initializes the logging manager subsystem.
     /// \param  global_lvl - initial global filtering level (defaults to `warning`).
     /// \param  init_fn - optional custom callback functor for lazy logging configuration.
-    static void init(severity_level global_lvl = severity_level::warning, init_fn_t init_fn = []() -> void {});
+    /// \param  pattern - layout pattern of the record head (see \ref set_layout).
+    ///     An invalid pattern leaves the default layout.
+    static void init(severity_level global_lvl = severity_level::warning, init_fn_t init_fn = []() -> void {},
+                     const std::string& pattern = LOG_DEFAULT_LAYOUT);
+
+    /// \brief  Retrieves the compiled layout of the record head.
+    static const details::layout& layout()
+    {
+        const details::layout* p_layout = m_p_layout.load(std::memory_order_acquire);
+        return (p_layout != nullptr) ? *p_layout : default_layout();
+    }
+
+    /// \brief  Triggers the verbosity burst of a channel, which has logged an
+    ///     error, if the bursts are enabled.
+    /// \param  channel - name of the channel.
+    /// \details    Called by the logging macros for the levels `error` and more
+    ///     severe only.
+    static void on_error(const std::string& channel)
+    {
+        if (m_burst_level.load(std::memory_order_relaxed) >= 0) {
+            trigger_burst(channel);
+        }
+    }
 
     /// \brief  Changes the global logging level using an integer value (int).
     /// \param  lvl - integer representation of the level. Automatically cast to the `severity_level` type.
@@ -349,6 +657,25 @@ public:
     /// \details    Sets the immutable flag to `true`. Useful for production builds.
     static void set_immutable_global_level(severity_level lvl);
 
+    /// \brief  Compiles and sets the layout pattern of the record head.
+    /// \param  pattern - layout pattern.
+    /// \return true if the pattern is valid, false otherwise (the layout is
+    ///     not changed).
+    /// \details    The pattern is text with the following fields:
+    ///     - `%T` or `%T{N}` - timestamp `YYYY-MM-DD HH:MM:SS` with `N` (0-9,
+    ///         default 3) fractional digits of a second;
+    ///     - `%t` - thread id;
+    ///     - `%l` - level tag of fixed width, e.g. `[INFO ]`;
+    ///     - `%L` - level name, e.g. `INFO`;
+    ///     - `%c` or `%c{N}` - channel name, padded to at least `N` characters;
+    ///     - `%s` - source location `file:line`;
+    ///     - `%f` - function name;
+    ///     - `%%` - the `%` character.
+    ///
+    ///     The pattern is compiled once into a sequence of operations, and the
+    ///     record prefixes of the channels are rebuilt on their next use.
+    static bool set_layout(const std::string& pattern);
+
     /// \brief  Sets or dynamically modifies the logging level for a specific channel.
     /// \param  channel - name of the target channel.
     /// \param  lvl - new severity level for this channel.
@@ -365,15 +692,19 @@ public:
     static std::string timestamp();
 
 private:
-    using base_logger_t = details::base_logger;           ///< Type alias for the base polymorphic channel metadata class.
+    template<const auto& Channels>
+    friend class static_channels;
+
     using severity_level_t = std::atomic<severity_level>; ///< Atomic variable type for log levels.
 
     /**
      *  \brief  Internal manager container for storing a specific channel's
-     *      metadata and implementation.
+     *      metadata and implementations.
      *
-     *  \details    Allows holding a polymorphic pointer to the implementation
-     *      while the user code operates with generalized interfaces.
+     *  \details    Holds the shared state of the channel and one typed slot per
+     *      logger type, indexed by `details::logger_slot`. Every slot contains
+     *      only implementations of its own type, so no type check or cast
+     *      between logger types is needed.
      */
     struct logger_holder final
     {
@@ -384,24 +715,22 @@ private:
         /// \param  ch - name of the channel.
         /// \param  lvl - initial logging level of the channel.
         explicit logger_holder(const std::string& ch, severity_level lvl)
-            : channel(ch)
-            , level(lvl)
+            : p_state(std::make_shared<details::channel_state>(ch, lvl))
         {}
 
-        /// \brief  Lazy creation or retrieval of the underlying polymorphic
-        ///     logger implementation.
-        /// \tparam TLogger - internal target implementation class (`details::logger_impl<T>`).
+        /// \brief  Lazy creation or retrieval of the logger implementation of
+        ///     the specified type.
+        /// \tparam TLogger - custom logger type.
         /// \return Typed pointer to the implementation object.
         template<typename TLogger>
-        std::shared_ptr<TLogger> get_logger();
+        typename details::logger_impl<TLogger>::ptr get_logger();
 
         /// \brief  Modifies the logging level for the current channel holder.
         /// \param  lvl - new severity level.
         void set_level(severity_level lvl);
 
-        const std::string channel;        ///< Name of the logging channel.
-        severity_level level;             ///< Current severity level of the channel.
-        base_logger_t::ptr p_base_logger; ///< Polymorphic pointer to the base log channel metadata.
+        const details::channel_state::ptr p_state; ///< Shared state of the channel.
+        std::vector<std::shared_ptr<void>> slots;  ///< Implementations by logger slot index.
     };
 
 private:
@@ -411,41 +740,75 @@ private:
     /// \return The created and registered channel container.
     static logger_holder::ptr register_logger(const std::string& channel, severity_level lvl);
 
+    /// \brief  Links a channel list declared at compile time into the registry.
+    /// \param  table - descriptor of the list.
+    /// \details    The channels of the list take the levels already set for
+    ///     them by name.
+    static void register_static_table(details::static_table& table);
+
+    /// \brief  Sets the level of a range of the channels of a list declared at
+    ///     compile time, and of the registered channels of the same names.
+    /// \param  table - descriptor of the list.
+    /// \param  first - index of the first channel of the range.
+    /// \param  count - number of the channels of the range.
+    /// \param  lvl - new severity level.
+    /// \details    The range is written in one pass, and the channels, which
+    ///     are not in the registry, are not registered. Other lists declaring
+    ///     the same names keep their levels.
+    static void set_static_levels(const details::static_table& table, size_t first, size_t count,
+                                  severity_level lvl);
+
+    /// \brief  Returns the level of a channel in the lists declared at compile
+    ///     time, or `severity_level::debug` if no list declares it.
+    /// \param  channel - name of the channel.
+    static severity_level static_level(const std::string& channel);
+
+    /// \brief  Returns the compiled default layout \ref LOG_DEFAULT_LAYOUT.
+    static const details::layout& default_layout();
+
+    /// \brief  Returns the burst engine of the manager, or `nullptr` upon a
+    ///     memory allocation error.
+    static lw_burst_engine_t* burst_engine();
+
+    /// \brief  Sets the burst level of a channel in the registry and in the
+    ///     lists declared at compile time.
+    /// \param  channel - name of the channel.
+    /// \param  lvl - level of the burst, or -1 to end it.
+    static void set_burst_level(const char* channel, int lvl);
+
+    /// \brief  Starts a burst of a channel, if the limits permit it.
+    /// \param  channel - name of the channel.
+    static void trigger_burst(const std::string& channel);
+
 private:
     static severity_level_t m_global_level;      ///< Global atomic filtering level for the entire system.
     static std::atomic_bool m_is_immutable;      ///< Atomic flag locking the global level from modifications.
+    static std::atomic<const details::layout*> m_p_layout; ///< Compiled layout, or null for the default one.
+    static std::atomic_int m_burst_level;        ///< Level of the verbosity bursts, or -1 while they are disabled.
 
     static std::recursive_mutex m_loggers_mutex; ///< Recursive mutex protecting the thread safety of the `m_loggers_map` registry.
     static logger_holder::map m_loggers_map;     ///< Central hash registry of all registered log channels.
+    static details::static_table* m_p_static_tables; ///< Registered channel lists declared at compile time.
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 // class manager::logger_holder definition
 
 template<typename TLogger>
-std::shared_ptr<TLogger> manager::logger_holder::get_logger()
+typename details::logger_impl<TLogger>::ptr manager::logger_holder::get_logger()
 {
-    using logger_impl_t = TLogger;
+    using logger_impl_t = details::logger_impl<TLogger>;
 
-    // Static assertions to ensure compile-time type safety
-    static_assert(std::is_base_of<base_logger_t, logger_impl_t>::value, "manager::logger_holder::get_logger: invalid TLogger type");
-    static_assert(! std::is_same<base_logger_t, logger_impl_t>::value, "manager::logger_holder::get_logger: invalid TLogger type");
-
-    std::shared_ptr<logger_impl_t> p_logger;
-    if (! p_base_logger.get()) {
+    const size_t idx = details::logger_slot::index<TLogger>();
+    if (slots.size() <= idx) {
+        slots.resize(idx + 1);
+    }
+    if (! slots[idx]) {
         // Lazy memory allocation for the specific implementation upon first access
-        p_logger = std::make_shared<logger_impl_t>(channel, level);
-        p_base_logger = p_logger;
-    } else {
-        // \todo ARCHITECTURAL RISK: If the same string channel is requested with different logger types
-        // (e.g., C-style first, then CPP-style), `dynamic_pointer_cast` will return nullptr,
-        // and the `static_pointer_cast` below will result in runtime Undefined Behavior on non-debug builds.
-        // It is recommended to add a release-mode check and throw a `std::bad_cast` exception.
-        assert(std::dynamic_pointer_cast<logger_impl_t>(p_base_logger) && "manager::get_logger: invalid pointer cast");
-        p_logger = std::static_pointer_cast<logger_impl_t>(p_base_logger);
+        slots[idx] = std::make_shared<logger_impl_t>(p_state);
     }
-
-    return p_logger;
+    // The slot of the type only ever holds an implementation of this type
+    return std::static_pointer_cast<logger_impl_t>(slots[idx]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -454,9 +817,8 @@ std::shared_ptr<TLogger> manager::logger_holder::get_logger()
 template<typename TLogger>
 TLogger manager::get_logger(const std::string& channel)
 {
-    // Extract the underlying types from the logger wrapper's handle class
+    // Extract the underlying type from the logger wrapper's handle class
     using logger_type_t = typename TLogger::logger_type;
-    using logger_impl_t = details::logger_impl<logger_type_t>;
 
     // Protect multithreaded access to the loggers hash map
     std::lock_guard<std::recursive_mutex> lock(m_loggers_mutex);
@@ -465,13 +827,13 @@ TLogger manager::get_logger(const std::string& channel)
     logger_holder::ptr p_holder;
     if (it == m_loggers_map.end()) {
         // Channel not found - registering from scratch
-        p_holder = register_logger(channel, severity_level::debug);
+        p_holder = register_logger(channel, static_level(channel));
     } else {
         // Channel found - retrieving the pointer to its container
         p_holder = it->second;
     }
     // Construct and return a cheap logger handle object
-    return TLogger(p_holder->get_logger<logger_impl_t>());
+    return TLogger(p_holder->get_logger<logger_type_t>());
 }
 
 template<typename TLogger>
@@ -487,7 +849,261 @@ TLogger manager::get_logger_dfl(const std::string& channel, severity_level lvl)
     return get_logger<TLogger>(channel);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// struct logger definition
+
+template<typename TLogger>
+size_t logger<TLogger>::format_head(char* buf, size_t size, severity_level lvl, const details::source_location& loc) const
+{
+    return manager::format_head(buf, size, p_logger_impl->p_state->prefixes.get(), lvl, loc);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// class details::prefix_cache definition
+
+inline const details::record_prefix& details::prefix_cache::get()
+{
+    const record_prefix* p_prefix = m_p_prefix.load(std::memory_order_acquire);
+    if ((p_prefix == nullptr) || (p_prefix->p_layout != &manager::layout())) {
+        p_prefix = rebuild();
+    }
+    return *p_prefix;
+}
+
+template<typename TLogger, const auto& Channels, size_t Id>
+struct static_logger;
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class static_channels
+
+/**
+ *  \brief  Channels declared at compile time in a `constexpr` list.
+ *  \tparam Channels - array of `std::string_view` names with static storage
+ *      duration, e.g. declared by \ref LW_STATIC_CHANNELS.
+ *
+ *  \details    The index of a channel in the list is its dense compile-time id.
+ *      The levels of all channels of the list are stored in one contiguous
+ *      array of atomics indexed by the id, so a logger of a declared channel
+ *      checks its level without any lookup, and the array is constant-initialized
+ *      without allocation.
+ *
+ *      The list is linked into the registry of the manager on its first use,
+ *      after which `manager::set_logger_level` applies to its channels by name.
+ *      \ref set_level and \ref set_levels write the array in one pass and
+ *      update the channels of the same names, which the manager has already
+ *      registered, without registering new ones. `manager::get_logger`
+ *      registers a declared channel with its level, so the loggers of the same
+ *      name filter at the same level.
+ *      `manager::deinit` resets the levels of the registered lists to `debug`.
+ *
+ *  Usage example:
+ *  \code
+ *  LW_STATIC_CHANNELS(app_channels, "Root", "Network", "Storage");
+ *
+ *  using app_channels_t = ::wstux::logging::static_channels<app_channels>;
+ *
+ *  void do_work()
+ *  {
+ *      auto logger = LW_STATIC_LOGGER(clog_logger, app_channels, "Network");
+ *      LOG_INFO(logger, "Connected");
+ *
+ *      app_channels_t::set_levels(::wstux::logging::severity_level::error);
+ *  }
+ *  \endcode
+ */
+template<const auto& Channels>
+class static_channels final
+{
+    using names_t = std::remove_cv_t<std::remove_reference_t<decltype(Channels)>>;
+
+public:
+    static constexpr size_t size = std::extent<names_t>::value; ///< Number of channels.
+
+    static_assert(std::is_same<std::remove_cv_t<std::remove_extent_t<names_t>>, std::string_view>::value,
+                  "static_channels: channels must be declared as an array of std::string_view");
+
+    /// \brief  Returns the logger handle of a channel of the list.
+    /// \tparam TLogger - custom logger type.
+    /// \tparam Id - index of the channel.
+    template<typename TLogger, size_t Id>
+    static static_logger<TLogger, Channels, Id> get_logger()
+    {
+        attach();
+        return static_logger<TLogger, Channels, Id>();
+    }
+
+    /// \brief  Returns the index of a channel, or `size` if it is not declared.
+    static constexpr size_t index_of(std::string_view channel)
+    {
+        for (size_t i = 0; i < size; ++i) {
+            if (Channels[i] == channel) {
+                return i;
+            }
+        }
+        return size;
+    }
+
+    /// \brief  Checks if the specified logging level is enabled for a channel.
+    /// \param  id - index of the channel.
+    /// \param  lvl - required severity level.
+    static bool can_log(size_t id, severity_level lvl) { return m_levels.levels[id] >= lvl; }
+
+    /// \brief  Checks if the active burst of a channel permits the level.
+    /// \param  id - index of the channel.
+    /// \param  lvl - required severity level.
+    static bool is_bursting(size_t id, severity_level lvl)
+    {
+        return m_levels.bursts[id].load(std::memory_order_relaxed) >= (int)lvl;
+    }
+
+    /// \brief  Returns the current severity level of a channel.
+    static severity_level level(size_t id) { return m_levels.levels[id]; }
+
+    /// \brief  Returns the name of a channel.
+    static constexpr std::string_view name(size_t id) { return Channels[id]; }
+
+    /// \brief  Sets the severity level of a channel.
+    /// \param  id - index of the channel.
+    /// \param  lvl - new severity level.
+    static void set_level(size_t id, severity_level lvl)
+    {
+        if ((id >= size) || (lvl < severity_level::emerg) || (lvl > severity_level::trace)) {
+            return;
+        }
+        attach();
+        manager::set_static_levels(m_table, id, 1, lvl);
+    }
+
+    /// \brief  Sets the severity level of all channels of the list.
+    /// \param  lvl - new severity level.
+    static void set_levels(severity_level lvl)
+    {
+        if ((lvl < severity_level::emerg) || (lvl > severity_level::trace)) {
+            return;
+        }
+        attach();
+        manager::set_static_levels(m_table, 0, size, lvl);
+    }
+
+private:
+    /// \brief  Checks at compile time that the names of the list are unique.
+    static constexpr bool is_unique()
+    {
+        for (size_t i = 0; i < size; ++i) {
+            if (index_of(Channels[i]) != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(is_unique(), "static_channels: duplicate channel name");
+
+    /// \brief  Links the list into the registry of the manager once.
+    static void attach()
+    {
+        std::call_once(m_attach_flag, []() -> void { manager::register_static_table(m_table); });
+    }
+
+private:
+    static inline details::level_array<std::make_index_sequence<size>> m_levels = {}; ///< Levels by channel index.
+    static inline details::static_table m_table = {Channels, m_levels.levels, m_levels.bursts, size, nullptr}; ///< Registry descriptor.
+    static inline std::once_flag m_attach_flag; ///< Guard of the registration.
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// \struct static_logger
+
+/**
+ *  \brief  Logger handle of a channel declared at compile time.
+ *  \tparam TLogger - custom logger type.
+ *  \tparam Channels - list of the channels.
+ *  \tparam Id - index of the channel in the list.
+ *
+ *  \details    Has the interface of `logger<TLogger>` required by the logging
+ *      macros. The level is read from the level array of the list by the
+ *      constant index, and the custom logger object of the channel is a static
+ *      object of the handle type.
+ */
+template<typename TLogger, const auto& Channels, size_t Id>
+struct static_logger final
+{
+    using channels_t = static_channels<Channels>; ///< List of the channel.
+    using logger_type = TLogger;                  ///< Custom type of the underlying logger.
+
+    static_assert(Id < channels_t::size, "static_logger: channel is not declared in the list");
+
+    /// \brief  Checks if the specified logging level is enabled for this logger.
+    /// \param  lvl - required severity level.
+    /// \return true if recording is permitted, false otherwise.
+    bool can_log(severity_level lvl) const { return channels_t::can_log(Id, lvl); }
+
+    /// \brief  Checks if the active burst of the channel permits the level.
+    bool is_bursting(severity_level lvl) const { return channels_t::is_bursting(Id, lvl); }
+
+    /// \brief  Retrieves the channel name of the current logger.
+    const std::string& channel() const
+    {
+        static const std::string ch(channels_t::name(Id));
+        return ch;
+    }
+
+    /// \brief  Writes the head of a record in the layout of the manager.
+    size_t format_head(char* buf, size_t size, severity_level lvl, const details::source_location& loc) const
+    {
+        return manager::format_head(buf, size, prefixes().get(), lvl, loc);
+    }
+
+    /// \brief  Retrieves the precomputed static segments of the record head.
+    const std::vector<std::string>& prefix(severity_level lvl) const { return prefixes().get().segments[lvl]; }
+
+private:
+    /// \brief  Returns the prefix cache of the channel.
+    details::prefix_cache& prefixes() const
+    {
+        static details::prefix_cache cache(channel());
+        return cache;
+    }
+
+public:
+    /// \brief  Provides direct access to the custom logger object.
+    logger_type& get_logger()
+    {
+        static logger_type logger = make_logger<logger_type>(channel());
+        return logger;
+    }
+
+private:
+    friend channels_t;
+
+    /// \brief  Constructor for the logger handle.
+    /// \attention  The handle can only be created via `static_channels`.
+    static_logger() {}
+};
+
 } // namespace logging
 } // namespace wstux
 
+/**
+ *  \def    LW_STATIC_CHANNELS(name, ...)
+ *  \brief  Declares a `constexpr` list of channel names at namespace scope.
+ *  \param  name - name of the list.
+ *  \param  ... - string literals of the channel names.
+ */
+#define LW_STATIC_CHANNELS(name, ...)                                       \
+    inline constexpr ::std::string_view name[] = {__VA_ARGS__}
+
+/**
+ *  \def    LW_STATIC_LOGGER(TLogger, channels, channel)
+ *  \brief  Returns the logger handle of a channel of a list declared by
+ *      \ref LW_STATIC_CHANNELS.
+ *  \param  TLogger - custom logger type.
+ *  \param  channels - list of the channels.
+ *  \param  channel - string literal of the channel name. A name which is not
+ *      declared in the list does not compile.
+ */
+#define LW_STATIC_LOGGER(TLogger, channels, channel)                        \
+    ::wstux::logging::static_channels<channels>::template get_logger<TLogger,  \
+        ::wstux::logging::static_channels<channels>::index_of(channel)>()
+
 #endif /* _LIBS_LOGGING_WRAPPER_MANAGER_H_ */
@@ -0,0 +1,285 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Scope buffers, which keep the verbose records of a unit of work and
+ *      write them only if the work fails.
+ *  \ingroup logging_wrapper_module
+ *
+ *  \details    While a \ref wstux::logging::log_scope is active in a thread,
+ *      the records of the thread, which are filtered out by the global level
+ *      or the level of their channel, but are within the level of the scope,
+ *      are rendered into the arena of the scope instead of being dropped. The
+ *      records, which pass the filters, are written as usual.
+ *
+ *      When the scope ends, its records are discarded if the work succeeded,
+ *      or written in the order they were logged if the scope was marked as
+ *      failed or an exception is unwinding it. A nested scope, which fails,
+ *      passes its records to the enclosing scope, so they are written only if
+ *      the enclosing scope fails too.
+ *
+ *  \code
+ *  void handle(const request& req)
+ *  {
+ *      ::wstux::logging::log_scope scope(::wstux::logging::severity_level::debug);
+ *      LOGF_DEBUG(logger, "request %u: %zu bytes", req.id, req.size);
+ *      if (! process(req)) {
+ *          scope.fail();   // The debug records are written on return.
+ *      }
+ *  }
+ *  \endcode
+ */
+
+#ifndef _LIBS_LOGGING_WRAPPER_SCOPE_H_
+#define _LIBS_LOGGING_WRAPPER_SCOPE_H_
+
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+
+#include "logging_wrapper/format.h"
+#include "logging_wrapper/manager.h"
+#include "logging_wrapper/severity_level.h"
+#include "logging_wrapper/structured.h"
+
+namespace wstux {
+namespace logging {
+
+class log_scope;
+
+namespace details {
+
+/// \brief  Block of the arena of a scope.
+struct scope_block;
+/// \brief  Internal access to the arena of scopes.
+struct scope_writer;
+
+/**
+ *  \brief  Innermost active scope of the thread.
+ *
+ *  \details    The initial-exec model lets a filtered out record read it by a
+ *      single load relative to the thread pointer, without a call of
+ *      `__tls_get_addr`.
+ */
+inline thread_local log_scope* tl_p_scope __attribute__((tls_model("initial-exec"))) = nullptr;
+
+/**
+ *  \brief  Backend of a buffered record.
+ *
+ *  \details    Type-erased reference to the backend of the logger, which is
+ *      owned by the manager or by the static logger of the channel.
+ */
+struct scope_sink final
+{
+    void (*p_write)(void* p_backend, const char* p_data, size_t size); ///< Writer of a record.
+    void* p_backend;                                                    ///< Backend of the logger.
+};
+
+/// \brief  Checks that \ref write_record can pass a record to a backend.
+template<typename T, typename = void>
+struct can_write_record : std::bool_constant<std::is_invocable_v<T&, const char*, int, const char*> ||
+                                             has_write<T>::value>
+{};
+
+template<typename T>
+struct can_write_record<T, std::void_t<decltype(std::declval<T&>() << std::declval<std::string_view>())>>
+    : std::true_type
+{};
+
+/**
+ *  \brief  Returns the sink of the text records of a backend, or a sink
+ *      without a writer if the backend cannot receive a whole record.
+ */
+template<typename TBackend>
+scope_sink make_scope_sink(TBackend& backend) noexcept
+{
+    if constexpr (can_write_record<TBackend>::value) {
+        return scope_sink{[](void* p_backend, const char* p_data, size_t size) -> void {
+                              write_record(*static_cast<TBackend*>(p_backend), p_data, size);
+                          }, &backend};
+    } else {
+        return scope_sink{nullptr, &backend};
+    }
+}
+
+/**
+ *  \brief  Returns the sink of the binary structured records of a backend
+ *      with a `write_kv` member.
+ */
+template<typename TBackend>
+scope_sink make_scope_kv_sink(TBackend& backend) noexcept
+{
+    return scope_sink{[](void* p_backend, const char* p_data, size_t size) -> void {
+                          static_cast<TBackend*>(p_backend)->write_kv(kv_record(p_data, size));
+                      }, &backend};
+}
+
+/**
+ *  \brief  Returns true if a record of the level, which is filtered out, is
+ *      kept by the active scope of the thread.
+ */
+inline bool scope_captures(severity_level lvl) noexcept;
+
+/**
+ *  \brief  Copies a record into the arena of the active scope.
+ */
+void scope_capture(const scope_sink& sink, const char* p_data, size_t size) noexcept;
+
+/**
+ *  \brief  Formats a record with the head and a `printf`-like format string
+ *      into the arena of the active scope.
+ */
+void scope_printf(const scope_sink& sink, const char* p_head, size_t head_len, const char* p_fmt, ...) noexcept
+    __attribute__((format(printf, 4, 5)));
+
+/**
+ *  \brief  Returns the thread-local stream of records, which is reset and
+ *      starts with the head.
+ */
+std::ostream& scope_stream(const char* p_head, size_t head_len);
+
+/**
+ *  \brief  Ends the record of the stream of \ref scope_stream with a new line
+ *      and copies it into the arena of the active scope.
+ */
+void scope_stream_end(const scope_sink& sink) noexcept;
+
+/**
+ *  \brief  Renders a record of a `{}`-style format string into the arena of
+ *      the active scope.
+ */
+template<size_t TSize, typename TLogger, typename TLevel, typename TLocation, typename TFmt, typename... TArgs>
+void scope_formatted(TLogger&& logger, TLevel lvl, const TLocation& loc, TFmt fmt, const TArgs&... args)
+{
+    const size_t size = render_formatted<TSize>(logger, lvl, loc, fmt, args...);
+    scope_capture(make_scope_sink(logger.get_logger()), record_buffer<TSize>(), size);
+}
+
+/**
+ *  \brief  Keeps a structured record in the arena of the active scope: in
+ *      binary for a backend with a `write_kv` member, rendered otherwise.
+ */
+template<size_t TSize, typename TLogger, typename TLocation, typename... TFields>
+void scope_kv(TLogger&& logger, severity_level lvl, const TLocation& loc,
+              std::string_view message, const TFields&... fields)
+{
+    const kv_record record = encode_kv<TSize>(logger, lvl, message, fields...);
+    using backend_t = std::remove_reference_t<decltype(logger.get_logger())>;
+    if constexpr (has_write_kv<backend_t>::value) {
+        scope_capture(make_scope_kv_sink(logger.get_logger()), (const char*)record.data(), record.size());
+    } else {
+        const size_t size = render_kv_line<TSize>(logger, lvl, loc, record);
+        scope_capture(make_scope_sink(logger.get_logger()), record_buffer<TSize>(), size);
+    }
+}
+
+} // namespace details
+
+////////////////////////////////////////////////////////////////////////////////
+/// \class log_scope
+
+/**
+ *  \brief  RAII buffer of the verbose records of the current thread.
+ *
+ *  \details    The records are kept in blocks of memory, which are reused by
+ *      the later scopes of the thread. At most `max_size` bytes of records
+ *      are kept: later records are dropped and counted.
+ *
+ *  \attention  A scope belongs to the thread which created it and must be
+ *      destroyed by it, in the reverse order of creation. The loggers of the
+ *      kept records must outlive the scope.
+ */
+class log_scope final
+{
+    friend struct details::scope_writer;
+
+public:
+    /// \brief  Default limit of the size of the kept records.
+    static constexpr size_t default_max_size = 64 * 1024;
+
+    /**
+     *  \brief  Starts a scope in the current thread.
+     *  \param  lvl - the most verbose level of the kept records.
+     *  \param  max_size - limit of the size of the kept records in bytes.
+     */
+    explicit log_scope(severity_level lvl = severity_level::debug, size_t max_size = default_max_size) noexcept;
+
+    /**
+     *  \brief  Ends the scope: writes the records if it failed, discards them
+     *      otherwise.
+     */
+    ~log_scope();
+
+    log_scope(const log_scope&) = delete;
+    log_scope& operator=(const log_scope&) = delete;
+
+    /// \brief  Marks the work of the scope as failed.
+    void fail() noexcept { m_is_failed = true; }
+
+    /**
+     *  \brief  Returns true if the scope is marked as failed or an exception,
+     *      thrown after the start of the scope, is unwinding it.
+     */
+    bool failed() const noexcept;
+
+    /**
+     *  \brief  Writes the kept records now, after the records of the
+     *      enclosing scopes.
+     */
+    void flush();
+
+    /// \brief  Discards the kept records.
+    void discard() noexcept;
+
+    /// \brief  Returns the most verbose level of the kept records.
+    severity_level level() const noexcept { return m_level; }
+
+    /// \brief  Returns the size of the kept records in bytes.
+    size_t size() const noexcept { return m_size; }
+
+    /// \brief  Returns the number of records dropped by the size limit.
+    size_t dropped() const noexcept { return m_dropped; }
+
+    /// \brief  Returns the innermost active scope of the thread, or `nullptr`.
+    static log_scope* current() noexcept { return details::tl_p_scope; }
+
+private:
+    log_scope* m_p_parent;
+    severity_level m_level;
+    size_t m_max_size;
+    size_t m_size;
+    size_t m_dropped;
+    int m_exceptions;
+    bool m_is_failed;
+    details::scope_block* m_p_head;
+    details::scope_block* m_p_tail;
+};
+
+namespace details {
+
+inline bool scope_captures(severity_level lvl) noexcept
+{
+    const log_scope* p_scope = tl_p_scope;
+    return (p_scope != nullptr) && (p_scope->level() >= lvl);
+}
+
+} // namespace details
+} // namespace logging
+} // namespace wstux
+
+#endif /* _LIBS_LOGGING_WRAPPER_SCOPE_H_ */
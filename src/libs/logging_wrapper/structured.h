@@ -0,0 +1,450 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Structured key-value records.
+ *  \ingroup logging_wrapper_module
+ *
+ *  \details    A structured record is a message and a list of typed fields.
+ *      It is encoded in binary: a header with the timestamp, the level and
+ *      the channel, the message, and for every field its type, its key and
+ *      its raw value. Numbers are stored as their bits and are converted to
+ *      text only by \ref render_kv, which writes the record as text, logfmt
+ *      or JSON.
+ *
+ *      Only a backend with a `write_kv(const kv_record&)` member keeps the
+ *      conversion out of the logging thread: it receives the binary record
+ *      and may copy it and render it later, e.g. in another thread. Other
+ *      backends accept only text, so for them the logging thread renders the
+ *      record, numbers included, in the format set by \ref set_kv_format.
+ *
+ *  \code
+ *  using ::wstux::logging::kv;
+ *  LOG_KV(logger, INFO, "request done", kv("ms", elapsed_ms), kv("code", 200), kv("path", path));
+ *  // text:   2025-01-01 12:00:00.000 [INFO ] Root: request done ms=12.5 code=200 path=/index
+ *  // logfmt: ts=2025-01-01T12:00:00.000000Z level=info channel=Root msg="request done" ms=12.5 code=200 path=/index
+ *  // json:   {"ts":"2025-01-01T12:00:00.000000Z","level":"info","channel":"Root","msg":"request done","ms":12.5,"code":200,"path":"/index"}
+ *  \endcode
+ */
+
+#ifndef _LIBS_LOGGING_WRAPPER_STRUCTURED_H_
+#define _LIBS_LOGGING_WRAPPER_STRUCTURED_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "logging_wrapper/format.h"
+#include "logging_wrapper/severity_level.h"
+
+namespace wstux {
+namespace logging {
+
+/**
+ *  \brief  Output format of structured records.
+ */
+enum class kv_format : uint8_t
+{
+    text,   ///< Head of the layout, the message and `key=value` pairs.
+    logfmt, ///< `ts=... level=... channel=... msg=... key=value` with quoting.
+    json    ///< One JSON object per record.
+};
+
+/**
+ *  \brief  Type of a field value in a binary record.
+ */
+enum class kv_type : uint8_t
+{
+    i64,    ///< Signed integer.
+    u64,    ///< Unsigned integer.
+    f64,    ///< Floating point number.
+    boolean,///< Boolean.
+    str     ///< String.
+};
+
+/**
+ *  \brief  Decoded value of a field.
+ */
+struct kv_value
+{
+    kv_type type = kv_type::i64;    ///< Type of the value.
+    int64_t i = 0;                  ///< Value of a signed integer.
+    uint64_t u = 0;                 ///< Value of an unsigned integer.
+    double f = 0;                   ///< Value of a floating point number.
+    bool b = false;                 ///< Value of a boolean.
+    std::string_view s;             ///< Value of a string.
+};
+
+/**
+ *  \brief  Field of a structured record: a key and a value.
+ *  \tparam TValue - stored type: `int64_t`, `uint64_t`, `double`, `bool` or
+ *      `std::string_view`.
+ */
+template<typename TValue>
+struct kv_field
+{
+    std::string_view key;   ///< Key.
+    TValue value;           ///< Value.
+};
+
+/**
+ *  \brief  Creates a field of a structured record.
+ *  \param  key - key of the field.
+ *  \param  value - integer, floating point number, boolean, character or string.
+ *
+ *  \details    Strings are referenced, not copied, until the record is encoded.
+ */
+template<typename TValue>
+constexpr auto kv(std::string_view key, const TValue& value) noexcept
+{
+    using value_t = std::decay_t<TValue>;
+    if constexpr (std::is_same_v<value_t, bool>) {
+        return kv_field<bool>{key, value};
+    } else if constexpr (std::is_same_v<value_t, char>) {
+        return kv_field<std::string_view>{key, std::string_view(&value, 1)};
+    } else if constexpr (std::is_integral_v<value_t> && std::is_signed_v<value_t>) {
+        return kv_field<int64_t>{key, (int64_t)value};
+    } else if constexpr (std::is_integral_v<value_t> || std::is_enum_v<value_t>) {
+        return kv_field<uint64_t>{key, (uint64_t)value};
+    } else if constexpr (std::is_floating_point_v<value_t>) {
+        return kv_field<double>{key, (double)value};
+    } else {
+        static_assert(std::is_convertible_v<const TValue&, std::string_view>,
+                      "A field value must be a number, a boolean, a character or a string");
+        return kv_field<std::string_view>{key, std::string_view(value)};
+    }
+}
+
+/**
+ *  \brief  View of a binary structured record.
+ *
+ *  \details    The record is a header, the channel and the message, followed
+ *      by the fields. A field is its type (1 byte), the length of the key
+ *      (1 byte), the key and the value: 8 bytes of a number, 1 byte of a
+ *      boolean, or the length of a string (2 bytes) and the string. Values are
+ *      in the byte order of the host: a record is not meant to leave the
+ *      process before it is rendered.
+ */
+class kv_record
+{
+public:
+    /// \brief  Fixed header of a record.
+    struct header
+    {
+        uint64_t ts_ns;         ///< Timestamp in nanoseconds since the epoch.
+        uint16_t msg_len;       ///< Length of the message.
+        uint16_t field_count;   ///< Number of encoded fields.
+        uint8_t level;          ///< Severity level.
+        uint8_t channel_len;    ///< Length of the channel name.
+        uint8_t truncated;      ///< 1 if fields or a part of a string are dropped.
+        uint8_t reserved;
+    };
+
+    kv_record(const void* p_data, size_t size) noexcept
+        : m_p_data(static_cast<const uint8_t*>(p_data))
+        , m_size(size)
+    {
+        std::memcpy(&m_header, m_p_data, sizeof(m_header));
+    }
+
+    /// \brief  Returns the bytes of the record.
+    const void* data() const noexcept { return m_p_data; }
+    /// \brief  Returns the size of the record.
+    size_t size() const noexcept { return m_size; }
+
+    /// \brief  Returns the timestamp in nanoseconds since the epoch.
+    uint64_t timestamp_ns() const noexcept { return m_header.ts_ns; }
+    /// \brief  Returns the severity level.
+    severity_level level() const noexcept { return (severity_level)m_header.level; }
+    /// \brief  Returns the channel name, at most `255` characters of it.
+    std::string_view channel() const noexcept
+    {
+        return std::string_view((const char*)m_p_data + sizeof(header), m_header.channel_len);
+    }
+    /// \brief  Returns the message.
+    std::string_view message() const noexcept
+    {
+        return std::string_view((const char*)m_p_data + sizeof(header) + m_header.channel_len, m_header.msg_len);
+    }
+    /// \brief  Returns the number of encoded fields.
+    size_t field_count() const noexcept { return m_header.field_count; }
+    /// \brief  Returns true if fields or a part of a string are dropped.
+    bool truncated() const noexcept { return m_header.truncated != 0; }
+
+    /**
+     *  \brief  Decodes the fields.
+     *  \param  fn - functor `void(std::string_view key, const kv_value& value)`.
+     */
+    template<typename TFn>
+    void for_each_field(TFn&& fn) const
+    {
+        const uint8_t* p_cur = m_p_data + sizeof(header) + m_header.channel_len + m_header.msg_len;
+        for (size_t i = 0; i < m_header.field_count; ++i) {
+            kv_value value;
+            value.type = (kv_type)p_cur[0];
+            const std::string_view key((const char*)p_cur + 2, p_cur[1]);
+            p_cur += 2 + p_cur[1];
+            switch (value.type) {
+            case kv_type::i64:      std::memcpy(&value.i, p_cur, 8); p_cur += 8; break;
+            case kv_type::u64:      std::memcpy(&value.u, p_cur, 8); p_cur += 8; break;
+            case kv_type::f64:      std::memcpy(&value.f, p_cur, 8); p_cur += 8; break;
+            case kv_type::boolean:  value.b = (*p_cur++ != 0); break;
+            case kv_type::str: {
+                uint16_t len = 0;
+                std::memcpy(&len, p_cur, sizeof(len));
+                value.s = std::string_view((const char*)p_cur + sizeof(len), len);
+                p_cur += sizeof(len) + len;
+                break;
+            }
+            }
+            fn(key, value);
+        }
+    }
+
+private:
+    const uint8_t* m_p_data;
+    size_t m_size;
+    header m_header;
+};
+
+/**
+ *  \brief  Writes a structured record.
+ *  \param  out - output buffer.
+ *  \param  fmt - output format.
+ *  \param  record - binary record.
+ *
+ *  \details    In the `text` format only the message and the fields are
+ *      written: the head is written by the layout of the manager. The
+ *      `logfmt` and `json` formats write the timestamp (UTC, ISO 8601), the
+ *      level and the channel themselves. No new line is written.
+ *
+ *      In the `text` and `logfmt` formats the bytes of a key which would break
+ *      the `key=value` pair (spaces, control characters, `=`, `"` and `\`)
+ *      are replaced by `_`, and an empty key is written as `_`. A `json` record,
+ *      which does not fit into the buffer or whose fields were dropped on
+ *      encoding, ends at its last complete member with `"truncated":true`, so
+ *      it is still a valid object.
+ */
+void render_kv(text_buffer& out, kv_format fmt, const kv_record& record) noexcept;
+
+/**
+ *  \brief  Sets the format of structured records passed to backends without
+ *      a `write_kv` member (`text` by default).
+ */
+void set_kv_format(kv_format fmt) noexcept;
+
+/**
+ *  \brief  Returns the format of structured records.
+ */
+kv_format get_kv_format() noexcept;
+
+namespace details {
+
+/**
+ *  \brief  Writer of a binary structured record into a fixed-size buffer.
+ *
+ *  \details    A field which does not fit is dropped, and a string which does
+ *      not fit is shortened, and the record is marked as truncated.
+ */
+class kv_encoder
+{
+public:
+    kv_encoder(uint8_t* p_buf, size_t size, severity_level lvl, std::string_view channel,
+               std::string_view message) noexcept
+        : m_p_buf(p_buf)
+        , m_size(size)
+        , m_len(sizeof(kv_record::header))
+    {
+        const uint64_t ts_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        m_header = kv_record::header{ts_ns, 0, 0, (uint8_t)lvl, 0, 0, 0};
+
+        m_header.channel_len = (uint8_t)put_text(channel, 255);
+        m_header.msg_len = (uint16_t)put_text(message, UINT16_MAX);
+    }
+
+    void add(const kv_field<int64_t>& field) noexcept { add_number(kv_type::i64, field.key, &field.value); }
+    void add(const kv_field<uint64_t>& field) noexcept { add_number(kv_type::u64, field.key, &field.value); }
+    void add(const kv_field<double>& field) noexcept { add_number(kv_type::f64, field.key, &field.value); }
+
+    void add(const kv_field<bool>& field) noexcept
+    {
+        if (! add_key(kv_type::boolean, field.key, 1)) {
+            return;
+        }
+        m_p_buf[m_len++] = field.value ? 1 : 0;
+        ++m_header.field_count;
+    }
+
+    void add(const kv_field<std::string_view>& field) noexcept
+    {
+        if (! add_key(kv_type::str, field.key, sizeof(uint16_t))) {
+            return;
+        }
+        const size_t room = m_size - m_len - sizeof(uint16_t);
+        size_t len = (field.value.size() < UINT16_MAX) ? field.value.size() : UINT16_MAX;
+        if (len > room) {
+            len = room;
+            m_header.truncated = 1;
+        }
+        const uint16_t len16 = (uint16_t)len;
+        std::memcpy(m_p_buf + m_len, &len16, sizeof(len16));
+        std::memcpy(m_p_buf + m_len + sizeof(len16), field.value.data(), len);
+        m_len += sizeof(len16) + len;
+        ++m_header.field_count;
+    }
+
+    /// \brief  Completes the record and returns its size.
+    size_t finish() noexcept
+    {
+        std::memcpy(m_p_buf, &m_header, sizeof(m_header));
+        return m_len;
+    }
+
+private:
+    /// \brief  Writes a text of at most `max_len` characters which fits.
+    size_t put_text(std::string_view text, size_t max_len) noexcept
+    {
+        const size_t room = m_size - m_len;
+        size_t len = (text.size() < max_len) ? text.size() : max_len;
+        if (len > room) {
+            len = room;
+            m_header.truncated = 1;
+        }
+        std::memcpy(m_p_buf + m_len, text.data(), len);
+        m_len += len;
+        return len;
+    }
+
+    /// \brief  Writes the type and the key of a field if the field fits.
+    bool add_key(kv_type type, std::string_view key, size_t value_size) noexcept
+    {
+        const size_t key_len = (key.size() < 255) ? key.size() : 255;
+        if (m_size - m_len < 2 + key_len + value_size) {
+            m_header.truncated = 1;
+            return false;
+        }
+        m_p_buf[m_len] = (uint8_t)type;
+        m_p_buf[m_len + 1] = (uint8_t)key_len;
+        std::memcpy(m_p_buf + m_len + 2, key.data(), key_len);
+        m_len += 2 + key_len;
+        return true;
+    }
+
+    void add_number(kv_type type, std::string_view key, const void* p_value) noexcept
+    {
+        if (add_key(type, key, 8)) {
+            std::memcpy(m_p_buf + m_len, p_value, 8);
+            m_len += 8;
+            ++m_header.field_count;
+        }
+    }
+
+private:
+    uint8_t* m_p_buf;
+    const size_t m_size;
+    size_t m_len;
+    kv_record::header m_header;
+};
+
+/**
+ *  \brief  True if the backend receives binary structured records.
+ */
+template<typename T, typename = void>
+struct has_write_kv : std::false_type
+{};
+
+template<typename T>
+struct has_write_kv<T, std::void_t<decltype(std::declval<T&>().write_kv(std::declval<const kv_record&>()))>>
+    : std::true_type
+{};
+
+/**
+ *  \brief  Returns the thread-local buffer of binary records of `TSize` bytes.
+ */
+template<size_t TSize>
+uint8_t* kv_buffer() noexcept
+{
+    alignas(8) static thread_local uint8_t buf[TSize];
+    return buf;
+}
+
+/**
+ *  \brief  Encodes a structured record into the thread-local buffer of
+ *      binary records.
+ */
+template<size_t TSize, typename TLogger, typename... TFields>
+kv_record encode_kv(TLogger&& logger, severity_level lvl, std::string_view message, const TFields&... fields)
+{
+    static_assert(TSize >= sizeof(kv_record::header) + 2, "The record buffer is too small");
+    kv_encoder encoder(kv_buffer<TSize>(), TSize, lvl, logger.channel(), message);
+    (encoder.add(fields), ...);
+    return kv_record(kv_buffer<TSize>(), encoder.finish());
+}
+
+/**
+ *  \brief  Renders a structured record as a line into the thread-local buffer
+ *      of records, in the format of \ref get_kv_format.
+ *  \return Length of the line.
+ */
+template<size_t TSize, typename TLogger, typename TLocation>
+size_t render_kv_line(TLogger&& logger, severity_level lvl, const TLocation& loc, const kv_record& record)
+{
+    char* p_buf = record_buffer<TSize>();
+    const kv_format fmt = get_kv_format();
+    const size_t head_len = (fmt == kv_format::text) ? logger.format_head(p_buf, TSize - 1, lvl, loc) : 0;
+    text_buffer out(p_buf + head_len, TSize - 1 - head_len);
+    render_kv(out, fmt, record);
+    const size_t size = head_len + out.size();
+    p_buf[size] = '\n';
+    p_buf[size + 1] = '\0';
+    return size + 1;
+}
+
+/**
+ *  \brief  Encodes a structured record and passes it to the backend.
+ *
+ *  \details    A backend with a `write_kv` member receives the binary record.
+ *      Otherwise the record, numbers included, is rendered in the calling
+ *      thread into the thread-local buffer of records in the format of
+ *      \ref get_kv_format, and passed as a single line.
+ */
+template<size_t TSize, typename TLogger, typename TLocation, typename... TFields>
+void log_kv(TLogger&& logger, severity_level lvl, const TLocation& loc,
+            std::string_view message, const TFields&... fields)
+{
+    const kv_record record = encode_kv<TSize>(logger, lvl, message, fields...);
+    using backend_t = std::remove_reference_t<decltype(logger.get_logger())>;
+    if constexpr (has_write_kv<backend_t>::value) {
+        logger.get_logger().write_kv(record);
+    } else {
+        const size_t size = render_kv_line<TSize>(logger, lvl, loc, record);
+        write_record(logger.get_logger(), record_buffer<TSize>(), size);
+    }
+}
+
+} // namespace details
+} // namespace logging
+} // namespace wstux
+
+#endif /* _LIBS_LOGGING_WRAPPER_STRUCTURED_H_ */
@@ -0,0 +1,121 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Engine of the error-triggered verbosity bursts.
+ *  \ingroup loggingf_wrapper_module
+ *
+ *  \details    An engine keeps the burst state of the channels, which have
+ *      logged an error, in a hash table. A burst sets the burst level of a
+ *      channel through the setter of its owner, which lets the channel write
+ *      past the global and the channel levels, and schedules its end on a
+ *      hashed timer wheel, which is advanced by a housekeeping thread of the
+ *      engine. The thread sleeps while no timer
+ *      is scheduled.
+ *
+ *      A burst is never extended by later errors. After it ends the channel
+ *      cools down before it may burst again, and the number of channels
+ *      bursting at once is limited, so an error storm cannot keep channels
+ *      verbose.
+ *
+ *      The C manager owns an engine behind \ref lw_enable_burst. The C++
+ *      manager of `logging_wrapper` owns another one behind
+ *      `manager::enable_burst`, so the C++ library links this library for
+ *      it. The header does not include `loggingf_wrapper/manager.h`, which
+ *      cannot be included together with the C++ manager.
+ */
+
+#ifndef _LIBS_LOGGINGF_WRAPPER_BURST_H_
+#define _LIBS_LOGGINGF_WRAPPER_BURST_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+struct lw_burst_engine;
+/** \brief  Alias for the burst engine structure. */
+typedef struct lw_burst_engine  lw_burst_engine_t;
+
+/**
+ *  \brief  Returns the level up to which a channel writes its records (the
+ *      minimum of the global and the channel levels), or a negative value if
+ *      the channel is unknown.
+ */
+typedef int (*lw_burst_get_level_fn_t)(const char* channel);
+
+/**
+ *  \brief  Sets the burst level of a channel, or ends its burst with -1.
+ */
+typedef void (*lw_burst_set_level_fn_t)(const char* channel, int lvl);
+
+/**
+ *  \brief  Creates a stopped engine.
+ *  \param  p_get_level - level getter of the owner.
+ *  \param  p_set_level - burst level setter of the owner.
+ *  \return Engine, or NULL upon a memory allocation error.
+ *
+ *  \details    An engine lives until the end of the process, so the loggers
+ *      may trigger it without synchronizing with its start and stop.
+ */
+lw_burst_engine_t* lw_burst_engine_create(lw_burst_get_level_fn_t p_get_level, lw_burst_set_level_fn_t p_set_level);
+
+/**
+ *  \brief  Starts the housekeeping thread of an engine.
+ *  \param  p_burst - engine.
+ *  \param  lvl - level of a channel during a burst.
+ *  \param  window_ms - duration of a burst in milliseconds.
+ *  \param  cooldown_ms - time after a burst in milliseconds, during which the
+ *      channel does not burst again.
+ *  \param  max_active - maximum number of channels bursting at once, or 0 for
+ *      no limit.
+ *  \return true if the engine is started, false if the configuration is
+ *      invalid or the thread cannot be created.
+ *
+ *  \details    A started engine is stopped first, and the bursts of its
+ *      channels are ended. The parameters mirror the fields of
+ *      `lw_burst_config_t`.
+ */
+bool lw_burst_engine_start(lw_burst_engine_t* p_burst, int lvl, uint32_t window_ms, uint32_t cooldown_ms, uint32_t max_active);
+
+/**
+ *  \brief  Stops the housekeeping thread of an engine and forgets the states
+ *      of the channels.
+ *  \param  p_burst - engine.
+ *  \param  restore - end the bursts of the channels through the setter.
+ *
+ *  \details    Does nothing if the engine is stopped. Must not be called while
+ *      a lock of the owner, which its level setter takes, is held.
+ */
+void lw_burst_engine_stop(lw_burst_engine_t* p_burst, bool restore);
+
+/**
+ *  \brief  Starts a burst of a channel, which has logged an error, if the
+ *      limits permit it and the channel writes less than the burst level.
+ *  \param  p_burst - engine.
+ *  \param  channel - channel name.
+ */
+void lw_burst_engine_trigger(lw_burst_engine_t* p_burst, const char* channel);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _LIBS_LOGGINGF_WRAPPER_BURST_H_ */
@@ -0,0 +1,357 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Deferred (binary) formatting of C-style log records.
+ *  \ingroup loggingf_wrapper_module
+ *
+ *  \details    In the deferred mode a `LOGF_*` statement does not format its
+ *      message. The type of every argument is encoded at compile time by
+ *      `_Generic` into a static call site descriptor, together with the format
+ *      string and the number of arguments. At run time the statement only
+ *      stores the raw argument values (and copies of the strings) into a
+ *      record, and the text is rendered later by the writer thread of the
+ *      asynchronous backend.
+ *
+ *      The descriptor also holds the source location and the level of the
+ *      statement. It is interned on the first record: registered under a
+ *      32-bit id in a lock-free table, so a record carries the id instead of
+ *      the format string, and \ref lw_log_site_get resolves it (e.g. for a
+ *      dictionary of a binary output).
+ *
+ *      The deferred mode also provides a flight recorder. Records which fail
+ *      the level check of their channel, but pass the capture level set by
+ *      \ref lw_set_capture_level, are stored unformatted into a fixed-size
+ *      circular buffer of the calling thread (the oldest records are
+ *      overwritten). A record of the `error` level or above, or a call of
+ *      \ref lw_flight_dump, renders the buffers of all threads, oldest record
+ *      first, before the record itself.
+ *
+ *      The mode is enabled for a C translation unit by defining
+ *      `LOGGINGF_WRAPPER_DEFERRED` before including `loggingf_wrapper/logging.h`.
+ *      Restrictions of the mode:
+ *      - the format string must be a string literal;
+ *      - a statement takes at most `_LW_MAX_ARGS` (16) arguments;
+ *      - `long double` arguments are rendered with the precision of `double`;
+ *      - strings are copied only for `char*` (of any signedness) arguments,
+ *        other pointers (e.g. wide strings) are rendered as pointers;
+ *      - strings printed by `%.Ns` must be null-terminated;
+ *      - positional arguments (`%1$d`) and `%n` are not supported.
+ *
+ *  \code
+ *  #define LOGGINGF_WRAPPER_DEFERRED
+ *  #include "loggingf_wrapper/logging.h"
+ *
+ *  lw_init_logging_async(STDOUT_FILENO, dynamic_size, 0, info, "Root");
+ *  LOGF_INFO(lw_root_logger(), "Request %d from %s took %.3f ms", id, p_host, ms);
+ *  \endcode
+ */
+
+#ifndef _LIBS_LOGGINGF_WRAPPER_DEFERRED_H_
+#define _LIBS_LOGGINGF_WRAPPER_DEFERRED_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "loggingf_wrapper/manager.h"
+
+#if ! defined(LOG_FLIGHT_BUF_SIZE)
+    /** Size of the per-thread circular buffer of the flight recorder */
+    #define LOG_FLIGHT_BUF_SIZE (64 * 1024)
+#endif
+
+/** Capture level which disables the flight recorder. */
+#define LW_CAPTURE_OFF  (-1)
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ *  \enum   lw_arg_type
+ *  \brief  Types of the captured arguments of a deferred record.
+ */
+enum lw_arg_type
+{
+    LW_ARG_INT = 1, /**< Signed integer, stored as `long long` */
+    LW_ARG_UINT,    /**< Unsigned integer, stored as `unsigned long long` */
+    LW_ARG_DOUBLE,  /**< Floating point number, stored as `double` */
+    LW_ARG_STR,     /**< String, copied into the record */
+    LW_ARG_PTR      /**< Any other pointer, stored as is */
+};
+
+/**
+ *  \brief  Captured value of an argument of a deferred record.
+ */
+typedef union lw_arg
+{
+    long long i;          /**< Value of a `LW_ARG_INT` argument */
+    unsigned long long u; /**< Value of a `LW_ARG_UINT` argument */
+    double d;             /**< Value of a `LW_ARG_DOUBLE` argument */
+    const char* s;        /**< Value of a `LW_ARG_STR` argument */
+    const void* p;        /**< Value of a `LW_ARG_PTR` argument */
+} lw_arg_t;
+
+/**
+ *  \brief  Static descriptor of a deferred logging statement.
+ *
+ *  \details    Created at compile time for every `LOGF_*` statement. Only
+ *      the `char*` arguments which are printed by `%s` are copied into a
+ *      record; the mask of them is found by a scan of the format string when
+ *      the statement is executed for the first time, before its id is
+ *      published.
+ */
+typedef struct lw_log_site
+{
+    const char* fmt;                 /**< Format string (printf-style) */
+    const unsigned char* p_types;    /**< Types of the arguments (\ref lw_arg_type) */
+    size_t nargs;                    /**< Number of the arguments */
+    const char* file;                /**< Source file of the statement */
+    const char* func;                /**< Function of the statement */
+    int line;                        /**< Source line of the statement */
+    int level;                       /**< Severity level of the statement */
+    unsigned int str_mask;           /**< Mask of the arguments copied as strings,
+                                          valid once `id` is set (internal) */
+    uint32_t id;                     /**< Id of the interned statement, or 0 until
+                                          the first record (internal) */
+} lw_log_site_t;
+
+/**
+ *  \brief  Interns the descriptor of a statement (thread-safe, lock-free).
+ *  \param  p_site - descriptor of the statement.
+ *  \return Id of the statement (from 1), or 0 if the table of the statements
+ *      is full or cannot be allocated.
+ *
+ *  \details    Returns the id at once if the descriptor is already interned.
+ *      Threads which intern it concurrently all return the same id.
+ */
+uint32_t lw_log_site_register(const lw_log_site_t* p_site);
+
+/**
+ *  \brief  Returns the descriptor of an interned statement, or NULL if the id
+ *      is not assigned.
+ */
+const lw_log_site_t* lw_log_site_get(uint32_t id);
+
+/**
+ *  \brief  Returns the upper bound of the assigned ids (ids are in `[1, count]`).
+ */
+uint32_t lw_log_site_count(void);
+
+/**
+ *  \brief  Returns the id of a statement, interning it on the first call.
+ *
+ *  \details    After the first call it is a single atomic load.
+ */
+static inline uint32_t lw_log_site_id(const lw_log_site_t* p_site)
+{
+    const uint32_t id = __atomic_load_n(&p_site->id, __ATOMIC_ACQUIRE);
+    return (id != 0) ? id : lw_log_site_register(p_site);
+}
+
+/**
+ *  \brief  Current capture level of the flight recorder.
+ *
+ *  \details    Exported for the inline checks of the logging macros. The value
+ *      is \ref LW_CAPTURE_OFF until \ref lw_set_capture_level is called and
+ *      after \ref lw_deinit_logging.
+ */
+extern lw_atomic_level_t lw_g_capture_lvl;
+
+/**
+ *  \brief  Checks if a record, which fails the level check of its channel,
+ *      is captured by the flight recorder.
+ *  \param  p_logger - pointer to the channel logger.
+ *  \param  lvl - the severity level to check.
+ */
+static inline bool lw_is_capture_enabled(lw_loggerf_t p_logger, int lvl)
+{
+    return (p_logger != NULL) && (lvl >= 0) && (_LW_LEVEL_LOAD(lw_g_capture_lvl) >= lvl);
+}
+
+/**
+ *  \brief  Sets the capture level of the flight recorder.
+ *  \param  lvl - the most verbose level to capture, or \ref LW_CAPTURE_OFF.
+ *
+ *  \details    The buffers which are already captured are kept.
+ */
+void lw_set_capture_level(int lvl);
+
+/**
+ *  \brief  Renders the records of the flight recorder of all threads, oldest
+ *      first, and empties the buffers.
+ *
+ *  \details    Every record is passed to the output function of its channel,
+ *      in the format of the default implementation and with its original
+ *      timestamp. Called automatically for a record of the `error` level or
+ *      above.
+ */
+void lw_flight_dump(void);
+
+/**
+ *  \brief  Stores a deferred record of a logging statement.
+ *  \param  logger - logger of the channel.
+ *  \param  level - severity level of the record.
+ *  \param  p_site - descriptor of the statement.
+ *  \param  p_args - values of the arguments.
+ *
+ *  \details    With the asynchronous backend the raw values are enqueued and
+ *      the writer thread renders the line. With any other output function the
+ *      line is rendered in the calling thread and passed to it as `"%s"`. A
+ *      record which fails the level check of the channel is captured by the
+ *      flight recorder (see \ref lw_is_capture_enabled) or dropped.
+ */
+void lw_deferred_log(lw_loggerf_t logger, int level, const lw_log_site_t* p_site,
+                     const lw_arg_t* p_args);
+
+/**
+ *  \brief  Renders the message of a deferred record (similar to snprintf).
+ *  \param  buf - output buffer.
+ *  \param  size - size of the buffer, including the null terminator.
+ *  \param  p_site - descriptor of the statement.
+ *  \param  p_args - values of the arguments.
+ *  \return Length of the full message (which is truncated if it is not less
+ *      than `size`), or a negative value on error.
+ */
+int lw_deferred_format(char* buf, size_t size, const lw_log_site_t* p_site,
+                       const lw_arg_t* p_args);
+
+#if defined(__cplusplus)
+}
+#else
+
+/** \brief  Maximum number of arguments of a deferred statement. */
+#define _LW_MAX_ARGS    16
+
+/**
+ *  \name   Argument capture helpers
+ *  \brief  Conversions of an argument to \ref lw_arg_t selected by `_Generic`.
+ *  \note   Intended solely for internal use.
+ *  \{
+ */
+static inline lw_arg_t _lw_arg_i(long long v) { lw_arg_t arg; arg.i = v; return arg; }
+static inline lw_arg_t _lw_arg_u(unsigned long long v) { lw_arg_t arg; arg.u = v; return arg; }
+static inline lw_arg_t _lw_arg_d(double v) { lw_arg_t arg; arg.d = v; return arg; }
+static inline lw_arg_t _lw_arg_s(const void* v) { lw_arg_t arg; arg.s = (const char*)v; return arg; }
+static inline lw_arg_t _lw_arg_p(const volatile void* v) { lw_arg_t arg; arg.p = (const void*)v; return arg; }
+/** \} */
+
+/**
+ *  \brief  Never called function which makes the compiler check the format
+ *      string against the arguments.
+ */
+static inline __attribute__((format(printf, 1, 2))) void _lw_check_format(const char* fmt, ...)
+{
+    (void)fmt;
+}
+
+/**
+ *  \def    _LW_ARG_TYPE(x)
+ *  \brief  Integer constant of the \ref lw_arg_type of an argument.
+ */
+#define _LW_ARG_TYPE(x) _Generic((x),                                       \
+        _Bool: LW_ARG_UINT, char: LW_ARG_INT,                               \
+        signed char: LW_ARG_INT, unsigned char: LW_ARG_UINT,                \
+        short: LW_ARG_INT, unsigned short: LW_ARG_UINT,                     \
+        int: LW_ARG_INT, unsigned int: LW_ARG_UINT,                         \
+        long: LW_ARG_INT, unsigned long: LW_ARG_UINT,                       \
+        long long: LW_ARG_INT, unsigned long long: LW_ARG_UINT,             \
+        float: LW_ARG_DOUBLE, double: LW_ARG_DOUBLE,                        \
+        long double: LW_ARG_DOUBLE,                                         \
+        char*: LW_ARG_STR, const char*: LW_ARG_STR,                         \
+        signed char*: LW_ARG_STR, const signed char*: LW_ARG_STR,           \
+        unsigned char*: LW_ARG_STR, const unsigned char*: LW_ARG_STR,       \
+        default: LW_ARG_PTR)
+
+/**
+ *  \def    _LW_ARG_VALUE(x)
+ *  \brief  Captured \ref lw_arg_t value of an argument.
+ */
+#define _LW_ARG_VALUE(x) _Generic((x),                                      \
+        _Bool: _lw_arg_u, char: _lw_arg_i,                                  \
+        signed char: _lw_arg_i, unsigned char: _lw_arg_u,                   \
+        short: _lw_arg_i, unsigned short: _lw_arg_u,                        \
+        int: _lw_arg_i, unsigned int: _lw_arg_u,                            \
+        long: _lw_arg_i, unsigned long: _lw_arg_u,                          \
+        long long: _lw_arg_i, unsigned long long: _lw_arg_u,                \
+        float: _lw_arg_d, double: _lw_arg_d,                                \
+        long double: _lw_arg_d,                                             \
+        char*: _lw_arg_s, const char*: _lw_arg_s,                           \
+        signed char*: _lw_arg_s, const signed char*: _lw_arg_s,             \
+        unsigned char*: _lw_arg_s, const unsigned char*: _lw_arg_s,         \
+        default: _lw_arg_p)(x)
+
+/**
+ *  \name   Argument list helpers
+ *  \brief  Counting of the arguments and application of a macro to each of them.
+ *  \note   Intended solely for internal use.
+ *  \{
+ */
+#define _LW_CAT(a, b)   _LW_CAT_I(a, b)
+#define _LW_CAT_I(a, b) a ## b
+#define _LW_NARGS(...)                                                      \
+    _LW_NARGS_I(__VA_ARGS__ __VA_OPT__(,)                                   \
+                16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _LW_NARGS_I(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12,      \
+                    _13, _14, _15, _16, n, ...) n
+/** Expands to `f(x),` for every argument `x`. */
+#define _LW_MAP(f, ...) _LW_CAT(_LW_MAP_, _LW_NARGS(__VA_ARGS__))(f __VA_OPT__(,) __VA_ARGS__)
+#define _LW_MAP_0(f)
+#define _LW_MAP_1(f, x)         f(x),
+#define _LW_MAP_2(f, x, ...)    f(x), _LW_MAP_1(f, __VA_ARGS__)
+#define _LW_MAP_3(f, x, ...)    f(x), _LW_MAP_2(f, __VA_ARGS__)
+#define _LW_MAP_4(f, x, ...)    f(x), _LW_MAP_3(f, __VA_ARGS__)
+#define _LW_MAP_5(f, x, ...)    f(x), _LW_MAP_4(f, __VA_ARGS__)
+#define _LW_MAP_6(f, x, ...)    f(x), _LW_MAP_5(f, __VA_ARGS__)
+#define _LW_MAP_7(f, x, ...)    f(x), _LW_MAP_6(f, __VA_ARGS__)
+#define _LW_MAP_8(f, x, ...)    f(x), _LW_MAP_7(f, __VA_ARGS__)
+#define _LW_MAP_9(f, x, ...)    f(x), _LW_MAP_8(f, __VA_ARGS__)
+#define _LW_MAP_10(f, x, ...)   f(x), _LW_MAP_9(f, __VA_ARGS__)
+#define _LW_MAP_11(f, x, ...)   f(x), _LW_MAP_10(f, __VA_ARGS__)
+#define _LW_MAP_12(f, x, ...)   f(x), _LW_MAP_11(f, __VA_ARGS__)
+#define _LW_MAP_13(f, x, ...)   f(x), _LW_MAP_12(f, __VA_ARGS__)
+#define _LW_MAP_14(f, x, ...)   f(x), _LW_MAP_13(f, __VA_ARGS__)
+#define _LW_MAP_15(f, x, ...)   f(x), _LW_MAP_14(f, __VA_ARGS__)
+#define _LW_MAP_16(f, x, ...)   f(x), _LW_MAP_15(f, __VA_ARGS__)
+/** \} */
+
+/**
+ *  \def    LW_DEFERRED_CAPTURE(site, args, level, fmt, ...)
+ *  \brief  Declares the static descriptor and the captured arguments of a
+ *      deferred statement in the current block.
+ *  \param  site - name of the \ref lw_log_site_t variable.
+ *  \param  args - name of the \ref lw_arg_t array.
+ *  \param  level - severity level of the statement.
+ *  \param  fmt - format string literal.
+ *  \param  ... - arguments (evaluated once; an unevaluated call checks them
+ *      against the format string).
+ */
+#define LW_DEFERRED_CAPTURE(site, args, level, fmt, ...)                    \
+    static const unsigned char site ## _types[] = {                         \
+        _LW_MAP(_LW_ARG_TYPE, __VA_ARGS__) 0 };                             \
+    static lw_log_site_t site = {                                           \
+        fmt, site ## _types, sizeof(site ## _types) - 1,                    \
+        __FILE__, __func__, __LINE__, level, 0, 0 };                        \
+    const lw_arg_t args[] = { _LW_MAP(_LW_ARG_VALUE, __VA_ARGS__) { 0 } };  \
+    if (0) {                                                                \
+        _lw_check_format(fmt __VA_OPT__(,) __VA_ARGS__);                    \
+    }
+
+#endif /* __cplusplus */
+
+#endif /* _LIBS_LOGGINGF_WRAPPER_DEFERRED_H_ */
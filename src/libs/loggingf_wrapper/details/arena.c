@@ -0,0 +1,89 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \ingroup loggingf_wrapper_module
+ */
+
+#include <assert.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "loggingf_wrapper/details/arena.h"
+
+/** \brief  Minimum data size of a chunk. */
+#define _ARENA_MIN_CHUNK    4096
+/** \brief  Maximum data size of a chunk, chunks stop growing after it. */
+#define _ARENA_MAX_CHUNK    (1 << 20)
+
+/**
+ *  \brief  Header of an arena chunk, the data follows it.
+ */
+struct _lw_arena_chunk
+{
+    alignas(max_align_t) struct _lw_arena_chunk* p_next; /**< Previously allocated chunk. */
+};
+
+void _lw_arena_init(_lw_arena_t* p_arena, size_t initial_size)
+{
+    p_arena->p_chunks = NULL;
+    p_arena->p_cur = NULL;
+    p_arena->p_end = NULL;
+    p_arena->next_size = (initial_size < _ARENA_MIN_CHUNK) ? _ARENA_MIN_CHUNK : initial_size;
+}
+
+void* _lw_arena_alloc(_lw_arena_t* p_arena, size_t size, size_t align)
+{
+    assert(align != 0 && (align & (align - 1)) == 0 && align <= alignof(max_align_t));
+
+    uintptr_t cur = ((uintptr_t)p_arena->p_cur + (align - 1)) & ~(uintptr_t)(align - 1);
+    if (p_arena->p_cur == NULL || cur + size > (uintptr_t)p_arena->p_end) {
+        size_t chunk_size = p_arena->next_size;
+        while (chunk_size < size) {
+            chunk_size *= 2;
+        }
+        struct _lw_arena_chunk* p_chunk =
+            (struct _lw_arena_chunk*)malloc(sizeof(struct _lw_arena_chunk) + chunk_size);
+        if (p_chunk == NULL) {
+            return NULL;
+        }
+        p_chunk->p_next = p_arena->p_chunks;
+        p_arena->p_chunks = p_chunk;
+        p_arena->p_cur = (char*)(p_chunk + 1);
+        p_arena->p_end = p_arena->p_cur + chunk_size;
+        if (p_arena->next_size < _ARENA_MAX_CHUNK) {
+            p_arena->next_size *= 2;
+        }
+        cur = (uintptr_t)p_arena->p_cur;
+    }
+
+    p_arena->p_cur = (char*)(cur + size);
+    return (void*)cur;
+}
+
+void _lw_arena_release(_lw_arena_t* p_arena)
+{
+    while (p_arena->p_chunks != NULL) {
+        struct _lw_arena_chunk* p_chunk = p_arena->p_chunks;
+        p_arena->p_chunks = p_chunk->p_next;
+        free(p_chunk);
+    }
+    p_arena->p_cur = NULL;
+    p_arena->p_end = NULL;
+}
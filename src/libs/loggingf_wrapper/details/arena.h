@@ -0,0 +1,73 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Internal arena allocator of the logging manager.
+ *  \ingroup loggingf_wrapper_module
+ *
+ *  \details    Objects are carved sequentially from chunks whose size grows
+ *      geometrically, and are released all at once together with the arena.
+ *      The arena is not thread-safe.
+ */
+
+#ifndef _LIBS_LOGGINGF_WRAPPER_DETAILS_ARENA_H_
+#define _LIBS_LOGGINGF_WRAPPER_DETAILS_ARENA_H_
+
+#include <stddef.h>
+
+struct _lw_arena_chunk;
+
+/**
+ *  \brief  Arena allocator state.
+ */
+struct _lw_arena
+{
+    struct _lw_arena_chunk* p_chunks; /**< List of allocated chunks, the current one first. */
+    char* p_cur;                      /**< First free byte of the current chunk. */
+    char* p_end;                      /**< End of the current chunk. */
+    size_t next_size;                 /**< Data size of the next chunk. */
+};
+
+typedef struct _lw_arena    _lw_arena_t;
+
+/**
+ *  \brief  Initializes an empty arena.
+ *  \param  p_arena - arena to initialize.
+ *  \param  initial_size - data size of the first chunk in bytes.
+ *
+ *  \details    No memory is allocated until the first allocation.
+ */
+void _lw_arena_init(_lw_arena_t* p_arena, size_t initial_size);
+
+/**
+ *  \brief  Allocates memory from the arena.
+ *  \param  p_arena - arena.
+ *  \param  size - size of the object in bytes.
+ *  \param  align - alignment of the object (a power of two).
+ *  \return Pointer to the uninitialized memory, or NULL upon memory allocation
+ *      error.
+ */
+void* _lw_arena_alloc(_lw_arena_t* p_arena, size_t size, size_t align);
+
+/**
+ *  \brief  Releases all chunks of the arena and returns it to the empty state.
+ *  \param  p_arena - arena.
+ */
+void _lw_arena_release(_lw_arena_t* p_arena);
+
+#endif /* _LIBS_LOGGINGF_WRAPPER_DETAILS_ARENA_H_ */
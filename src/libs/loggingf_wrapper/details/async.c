@@ -0,0 +1,616 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \ingroup loggingf_wrapper_module
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "loggingf_wrapper/details/async.h"
+#include "loggingf_wrapper/manager.h"
+
+/** \brief  Size of the buffer of the writer thread, i.e. the largest `write(2)`. */
+#define _BATCH_SIZE     (64 * 1024)
+/** \brief  Line size which marks a drain marker. */
+#define _MARKER_SIZE    SIZE_MAX
+/** \brief  Size of a pooled queue node, including its header. */
+#define _NODE_SIZE      256
+/** \brief  Number of the nodes allocated at once when a pool runs empty. */
+#define _SLAB_NODES     64
+
+/*******************************************************************************
+ * Private functions & Data Structures
+ ******************************************************************************/
+
+struct _lw_async_line;
+/** \brief  Alias for the internal queue node structure. */
+typedef struct _lw_async_line       async_line_t;
+struct _lw_async_marker;
+/** \brief  Alias for the internal drain marker structure. */
+typedef struct _lw_async_marker     async_marker_t;
+struct _lw_async_backend;
+/** \brief  Alias for the internal backend structure. */
+typedef struct _lw_async_backend    async_backend_t;
+struct _lw_async_pool;
+/** \brief  Alias for the internal node pool structure. */
+typedef struct _lw_async_pool       async_pool_t;
+
+/**
+ *  \brief  Queue node of a line.
+ *
+ *  \details    The text of the line (without a terminator), or the record to
+ *      render, immediately follows the node in the same allocation. A node of
+ *      `_NODE_SIZE` bytes is taken from the pool of its producer and returned
+ *      to it by the writer, a larger one is allocated by `malloc`.
+ */
+struct _lw_async_line
+{
+    _Atomic(async_line_t*) p_next;  /**< Next node of the queue, or of the returned nodes of the pool. */
+    size_t size;                    /**< Size of the line, or `_MARKER_SIZE` for a drain marker. */
+    _lw_async_render_fn_t p_render; /**< Renderer of a record, or NULL for a line of text. */
+    async_pool_t* p_pool;           /**< Pool of the node, or NULL for a node allocated by `malloc`. */
+};
+
+_Static_assert(sizeof(async_line_t) % _Alignof(long long) == 0,
+               "Record which follows a queue node must be aligned");
+
+_Static_assert(_NODE_SIZE % _Alignof(long long) == 0, "Pooled nodes must be aligned");
+
+/**
+ *  \brief  Pool of the queue nodes of a producer thread.
+ *
+ *  \details    The owner takes nodes from its private free list. The writer
+ *      returns released nodes onto a lock-free stack, which the owner takes
+ *      over as a whole when its free list runs empty, so neither side takes a
+ *      lock. Only an empty pool calls `malloc`, for a slab of `_SLAB_NODES`
+ *      nodes. The pool of an exited thread is adopted by a later thread with
+ *      its nodes; pools and slabs are kept until the end of the process.
+ */
+struct _lw_async_pool
+{
+    async_line_t* p_free;                      /**< Free list of the owner. */
+    _Alignas(64) _Atomic(async_line_t*) p_returned; /**< Nodes returned by the writer. */
+    atomic_bool is_owned;                      /**< Flag of the pool having a live owner thread. */
+    async_pool_t* p_next_pool;                 /**< Next pool of the registry. */
+};
+
+/**
+ *  \brief  Drain marker. It is not written, but signalled by the writer when
+ *      all lines enqueued before it are written.
+ */
+struct _lw_async_marker
+{
+    async_line_t line; /**< Queue node. */
+    bool done;         /**< Flag of the marker being reached (guarded by `mutex`). */
+};
+
+/**
+ *  \brief  State of the asynchronous backend.
+ *
+ *  \details    The head of the queue is written by producers and the tail
+ *      only by the writer, so they are kept on separate cache lines.
+ */
+struct _lw_async_backend
+{
+    _Alignas(64) _Atomic(async_line_t*) p_head; /**< Last pushed node. */
+    _Alignas(64) async_line_t* p_tail;          /**< Next node to pop (owned by the writer). */
+    async_line_t stub;                          /**< Stub node, which keeps the queue non-empty. */
+    char* p_batch;                              /**< Buffer of the lines of the next `write(2)`. */
+    size_t batch_size;                          /**< Size of the data in the buffer. */
+    int fd;                                     /**< Output file descriptor. */
+    atomic_bool failed;                         /**< Flag of a write error since the last drain. */
+    pthread_t writer;                           /**< Writer thread. */
+    pthread_mutex_t mutex;                      /**< Mutex of the wakeup and the drain handshakes. */
+    pthread_cond_t wake_cond;                   /**< Condition of the writer being woken. */
+    pthread_cond_t done_cond;                   /**< Condition of a drain marker being reached. */
+    bool wake;                                  /**< Wakeup request of the writer (guarded by `mutex`). */
+    bool stop;                                  /**< Stop request of the writer (guarded by `mutex`). */
+};
+
+/** \brief  Global pointer to the asynchronous backend, or NULL. */
+static async_backend_t* g_p_async = NULL;
+
+/** \brief  Formatting buffer of the current thread. */
+static _Thread_local char tl_line[LOG_ASYNC_LINE_LEN];
+
+/** \brief  Node pool of the current thread, or NULL. */
+static _Thread_local async_pool_t* tl_p_pool = NULL;
+/** \brief  Registry of all node pools (push-only). */
+static _Atomic(async_pool_t*) g_p_pools = NULL;
+/** \brief  Key whose destructor releases the pool of an exiting thread. */
+static pthread_key_t g_pool_key;
+/** \brief  Guard of the creation of `g_pool_key`. */
+static pthread_once_t g_pool_key_once = PTHREAD_ONCE_INIT;
+
+/**
+ *  \brief  Releases the pool of an exiting thread for adoption.
+ */
+static void _release_pool(void* p_arg)
+{
+    atomic_store_explicit(&((async_pool_t*)p_arg)->is_owned, false, memory_order_release);
+}
+
+/**
+ *  \brief  Creates the key of the pools.
+ */
+static void _create_pool_key(void)
+{
+    pthread_key_create(&g_pool_key, _release_pool);
+}
+
+/**
+ *  \brief  Returns the pool of the current thread, which adopts a released
+ *      pool or creates one on the first call.
+ *  \return Pointer to the pool, or NULL upon a memory allocation error.
+ */
+static async_pool_t* _thread_pool(void)
+{
+    if (tl_p_pool != NULL) {
+        return tl_p_pool;
+    }
+    pthread_once(&g_pool_key_once, _create_pool_key);
+
+    async_pool_t* p_pool = atomic_load_explicit(&g_p_pools, memory_order_acquire);
+    for (; p_pool != NULL; p_pool = p_pool->p_next_pool) {
+        bool is_owned = false;
+        if (atomic_compare_exchange_strong_explicit(&p_pool->is_owned, &is_owned, true,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            break;
+        }
+    }
+    if (p_pool == NULL) {
+        p_pool = (async_pool_t*)aligned_alloc(_Alignof(async_pool_t), sizeof(async_pool_t));
+        if (p_pool == NULL) {
+            return NULL;
+        }
+        p_pool->p_free = NULL;
+        atomic_init(&p_pool->p_returned, NULL);
+        atomic_init(&p_pool->is_owned, true);
+        p_pool->p_next_pool = atomic_load_explicit(&g_p_pools, memory_order_relaxed);
+        while (! atomic_compare_exchange_weak_explicit(&g_p_pools, &p_pool->p_next_pool, p_pool,
+                                                       memory_order_release, memory_order_relaxed)) {
+        }
+    }
+    pthread_setspecific(g_pool_key, p_pool);
+    tl_p_pool = p_pool;
+    return p_pool;
+}
+
+/**
+ *  \brief  Allocates a queue node with room for `size` bytes of data.
+ *  \return Pointer to the node, or NULL upon a memory allocation error.
+ */
+static async_line_t* _alloc_node(size_t size)
+{
+    async_pool_t* p_pool = (size <= _NODE_SIZE - sizeof(async_line_t)) ? _thread_pool() : NULL;
+    if (p_pool == NULL) {
+        async_line_t* p_line = (async_line_t*)malloc(sizeof(async_line_t) + size);
+        if (p_line != NULL) {
+            p_line->p_pool = NULL;
+        }
+        return p_line;
+    }
+
+    if (p_pool->p_free == NULL) {
+        p_pool->p_free = atomic_exchange_explicit(&p_pool->p_returned, NULL, memory_order_acquire);
+    }
+    if (p_pool->p_free == NULL) {
+        char* p_slab = (char*)malloc((size_t)_NODE_SIZE * _SLAB_NODES);
+        if (p_slab == NULL) {
+            return NULL;
+        }
+        for (size_t i = 0; i < _SLAB_NODES; ++i) {
+            async_line_t* p_line = (async_line_t*)(p_slab + i * _NODE_SIZE);
+            p_line->p_pool = p_pool;
+            atomic_init(&p_line->p_next, p_pool->p_free);
+            p_pool->p_free = p_line;
+        }
+    }
+    async_line_t* p_line = p_pool->p_free;
+    p_pool->p_free = atomic_load_explicit(&p_line->p_next, memory_order_relaxed);
+    return p_line;
+}
+
+/**
+ *  \brief  Releases a popped queue node (writer thread only).
+ *
+ *  \details    A pooled node is pushed onto the returned nodes of its pool.
+ *      The owner takes the whole stack by an exchange, so the push is free of
+ *      the ABA problem.
+ */
+static void _free_node(async_line_t* p_line)
+{
+    async_pool_t* p_pool = p_line->p_pool;
+    if (p_pool == NULL) {
+        free(p_line);
+        return;
+    }
+    async_line_t* p_top = atomic_load_explicit(&p_pool->p_returned, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&p_line->p_next, p_top, memory_order_relaxed);
+    } while (! atomic_compare_exchange_weak_explicit(&p_pool->p_returned, &p_top, p_line,
+                                                     memory_order_release, memory_order_relaxed));
+}
+
+/**
+ *  \brief  Pushes a node to the queue (any thread).
+ *
+ *  \details    The exchange of the head linearizes the push. Until the link
+ *      from the previous node is stored, the node is invisible to the writer.
+ */
+static void _push(async_backend_t* p_async, async_line_t* p_line)
+{
+    atomic_store_explicit(&p_line->p_next, NULL, memory_order_relaxed);
+    async_line_t* p_prev = atomic_exchange_explicit(&p_async->p_head, p_line, memory_order_acq_rel);
+    atomic_store_explicit(&p_prev->p_next, p_line, memory_order_release);
+}
+
+/**
+ *  \brief  Pops a node from the queue (writer thread only).
+ *  \param  p_busy - set to true if the queue is not empty, but the next node
+ *      is not linked yet by its producer.
+ *  \return Pointer to the node, or NULL.
+ */
+static async_line_t* _pop(async_backend_t* p_async, bool* p_busy)
+{
+    *p_busy = false;
+    async_line_t* p_tail = p_async->p_tail;
+    async_line_t* p_next = atomic_load_explicit(&p_tail->p_next, memory_order_acquire);
+    if (p_tail == &p_async->stub) {
+        if (p_next == NULL) {
+            *p_busy = (atomic_load_explicit(&p_async->p_head, memory_order_acquire) != p_tail);
+            return NULL;
+        }
+        p_async->p_tail = p_next;
+        p_tail = p_next;
+        p_next = atomic_load_explicit(&p_tail->p_next, memory_order_acquire);
+    }
+    if (p_next != NULL) {
+        p_async->p_tail = p_next;
+        return p_tail;
+    }
+    if (p_tail != atomic_load_explicit(&p_async->p_head, memory_order_acquire)) {
+        *p_busy = true;
+        return NULL;
+    }
+    // The tail is the last node: put the stub behind it to detach it.
+    _push(p_async, &p_async->stub);
+    p_next = atomic_load_explicit(&p_tail->p_next, memory_order_acquire);
+    if (p_next != NULL) {
+        p_async->p_tail = p_next;
+        return p_tail;
+    }
+    *p_busy = true;
+    return NULL;
+}
+
+/**
+ *  \brief  Writes the whole buffer to the file descriptor.
+ *  \return true on success, false upon a write error.
+ */
+static bool _write_all(int fd, const char* p_data, size_t size)
+{
+    while (size > 0) {
+        const ssize_t rc = write(fd, p_data, size);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p_data += rc;
+        size -= (size_t)rc;
+    }
+    return true;
+}
+
+/**
+ *  \brief  Writes the buffered lines out.
+ */
+static void _write_batch(async_backend_t* p_async)
+{
+    if (p_async->batch_size == 0) {
+        return;
+    }
+    if (! _write_all(p_async->fd, p_async->p_batch, p_async->batch_size)) {
+        atomic_store(&p_async->failed, true);
+    }
+    p_async->batch_size = 0;
+}
+
+/**
+ *  \brief  Appends a line to the buffer and releases its node.
+ */
+static void _append_line(async_backend_t* p_async, async_line_t* p_line)
+{
+    const char* p_data = (const char*)(p_line + 1);
+    if (p_async->batch_size + p_line->size > _BATCH_SIZE) {
+        _write_batch(p_async);
+    }
+    if (p_line->size > _BATCH_SIZE) {
+        if (! _write_all(p_async->fd, p_data, p_line->size)) {
+            atomic_store(&p_async->failed, true);
+        }
+    } else {
+        memcpy(p_async->p_batch + p_async->batch_size, p_data, p_line->size);
+        p_async->batch_size += p_line->size;
+    }
+    _free_node(p_line);
+}
+
+/**
+ *  \brief  Renders a record into the buffer and releases its node.
+ *
+ *  \details    The record is rendered into the free space of the buffer. If it
+ *      does not fit, the buffer is written out and the record is rendered
+ *      again, into the empty buffer or, if it is larger, into a temporary one.
+ */
+static void _append_record(async_backend_t* p_async, async_line_t* p_line)
+{
+    const void* p_record = p_line + 1;
+    const size_t room = _BATCH_SIZE - p_async->batch_size;
+    size_t size = p_line->p_render(p_record, p_async->p_batch + p_async->batch_size, room);
+    if (size >= room) {
+        _write_batch(p_async);
+        if (size < _BATCH_SIZE) {
+            p_line->p_render(p_record, p_async->p_batch, _BATCH_SIZE);
+        } else {
+            char* p_text = (char*)malloc(size + 1);
+            if (p_text == NULL || ! _write_all(p_async->fd, p_text, p_line->p_render(p_record, p_text, size + 1))) {
+                atomic_store(&p_async->failed, true);
+            }
+            free(p_text);
+            size = 0;
+        }
+    }
+    p_async->batch_size += size;
+    _free_node(p_line);
+}
+
+/**
+ *  \brief  Main function of the writer thread.
+ *
+ *  \details    Lines are packed into the buffer while the queue has them, so
+ *      under load a single `write(2)` carries up to `_BATCH_SIZE` bytes. When
+ *      the queue runs empty, the buffer is written out and the writer sleeps
+ *      until it is woken or `LOG_ASYNC_FLUSH_MS` elapses.
+ */
+static void* _writer_main(void* p_arg)
+{
+    async_backend_t* p_async = (async_backend_t*)p_arg;
+    bool stopping = false;
+    for (;;) {
+        bool busy;
+        async_line_t* p_line = _pop(p_async, &busy);
+        if (p_line != NULL) {
+            if (p_line->p_render != NULL) {
+                _append_record(p_async, p_line);
+                continue;
+            }
+            if (p_line->size != _MARKER_SIZE) {
+                _append_line(p_async, p_line);
+                continue;
+            }
+            _write_batch(p_async);
+            pthread_mutex_lock(&p_async->mutex);
+            ((async_marker_t*)p_line)->done = true;
+            pthread_cond_broadcast(&p_async->done_cond);
+            pthread_mutex_unlock(&p_async->mutex);
+            continue;
+        }
+        if (busy) {
+            // A producer is between the exchange and the link of its node.
+            sched_yield();
+            continue;
+        }
+
+        _write_batch(p_async);
+        if (stopping) {
+            break;
+        }
+        pthread_mutex_lock(&p_async->mutex);
+        // The queue may have been filled after the pop above, so the writer
+        // exits only after one more pass which follows the stop request.
+        stopping = p_async->stop;
+        if (! stopping && ! p_async->wake) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_MONOTONIC, &deadline);
+            deadline.tv_nsec += (long)LOG_ASYNC_FLUSH_MS * 1000000L;
+            deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+            deadline.tv_nsec %= 1000000000L;
+            pthread_cond_timedwait(&p_async->wake_cond, &p_async->mutex, &deadline);
+        }
+        p_async->wake = false;
+        pthread_mutex_unlock(&p_async->mutex);
+    }
+    return NULL;
+}
+
+/**
+ *  \brief  Sets the wakeup request of the writer and wakes it.
+ */
+static void _wake_writer(async_backend_t* p_async)
+{
+    pthread_mutex_lock(&p_async->mutex);
+    p_async->wake = true;
+    pthread_cond_signal(&p_async->wake_cond);
+    pthread_mutex_unlock(&p_async->mutex);
+}
+
+/*******************************************************************************
+ * Internal interface
+ ******************************************************************************/
+
+bool _lw_async_start(int fd)
+{
+    assert(g_p_async == NULL && "Asynchronous backend is started");
+
+    async_backend_t* p_async = (async_backend_t*)aligned_alloc(_Alignof(async_backend_t), sizeof(async_backend_t));
+    if (p_async == NULL) {
+        return false;
+    }
+    p_async->p_batch = (char*)malloc(_BATCH_SIZE);
+    if (p_async->p_batch == NULL) {
+        free(p_async);
+        return false;
+    }
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&p_async->mutex, NULL);
+    pthread_cond_init(&p_async->wake_cond, &cond_attr);
+    pthread_cond_init(&p_async->done_cond, NULL);
+    pthread_condattr_destroy(&cond_attr);
+
+    atomic_init(&p_async->stub.p_next, NULL);
+    p_async->stub.size = 0;
+    p_async->stub.p_render = NULL;
+    p_async->stub.p_pool = NULL;
+    atomic_init(&p_async->p_head, &p_async->stub);
+    p_async->p_tail = &p_async->stub;
+    p_async->batch_size = 0;
+    p_async->fd = fd;
+    atomic_init(&p_async->failed, false);
+    p_async->wake = false;
+    p_async->stop = false;
+
+    if (pthread_create(&p_async->writer, NULL, _writer_main, p_async) != 0) {
+        pthread_cond_destroy(&p_async->done_cond);
+        pthread_cond_destroy(&p_async->wake_cond);
+        pthread_mutex_destroy(&p_async->mutex);
+        free(p_async->p_batch);
+        free(p_async);
+        return false;
+    }
+    g_p_async = p_async;
+    return true;
+}
+
+void _lw_async_stop(void)
+{
+    async_backend_t* p_async = g_p_async;
+    if (p_async == NULL) {
+        return;
+    }
+
+    // The writer exits only when the queue is empty.
+    pthread_mutex_lock(&p_async->mutex);
+    p_async->stop = true;
+    p_async->wake = true;
+    pthread_cond_signal(&p_async->wake_cond);
+    pthread_mutex_unlock(&p_async->mutex);
+    pthread_join(p_async->writer, NULL);
+
+    g_p_async = NULL;
+    pthread_cond_destroy(&p_async->done_cond);
+    pthread_cond_destroy(&p_async->wake_cond);
+    pthread_mutex_destroy(&p_async->mutex);
+    free(p_async->p_batch);
+    free(p_async);
+}
+
+bool _lw_async_started(void)
+{
+    return g_p_async != NULL;
+}
+
+void _lw_async_flush(void)
+{
+    assert(g_p_async != NULL && "Asynchronous backend is not started");
+    _wake_writer(g_p_async);
+}
+
+bool _lw_async_drain(void)
+{
+    assert(g_p_async != NULL && "Asynchronous backend is not started");
+
+    async_marker_t marker;
+    marker.line.size = _MARKER_SIZE;
+    marker.line.p_render = NULL;
+    marker.line.p_pool = NULL;
+    marker.done = false;
+    _push(g_p_async, &marker.line);
+
+    pthread_mutex_lock(&g_p_async->mutex);
+    g_p_async->wake = true;
+    pthread_cond_signal(&g_p_async->wake_cond);
+    while (! marker.done) {
+        pthread_cond_wait(&g_p_async->done_cond, &g_p_async->mutex);
+    }
+    pthread_mutex_unlock(&g_p_async->mutex);
+    return ! atomic_exchange(&g_p_async->failed, false);
+}
+
+int _lw_async_loggerf(const char* p_fmt, ...)
+{
+    assert(g_p_async != NULL && "Asynchronous backend is not started");
+
+    va_list args;
+    va_start(args, p_fmt);
+    const int rc = vsnprintf(tl_line, sizeof(tl_line), p_fmt, args);
+    va_end(args);
+    if (rc < 0) {
+        return rc;
+    }
+
+    async_line_t* p_line = _alloc_node((size_t)rc + 1);
+    if (p_line == NULL) {
+        return -1;
+    }
+    if ((size_t)rc < sizeof(tl_line)) {
+        memcpy(p_line + 1, tl_line, (size_t)rc);
+    } else {
+        // The line is longer than the buffer: format it again in place.
+        va_start(args, p_fmt);
+        vsnprintf((char*)(p_line + 1), (size_t)rc + 1, p_fmt, args);
+        va_end(args);
+    }
+    p_line->size = (size_t)rc;
+    p_line->p_render = NULL;
+    _push(g_p_async, p_line);
+    return rc;
+}
+
+void* _lw_async_alloc(size_t size)
+{
+    async_line_t* p_line = _alloc_node(size);
+    return (p_line != NULL) ? (void*)(p_line + 1) : NULL;
+}
+
+void _lw_async_push(void* p_record, _lw_async_render_fn_t p_render)
+{
+    assert(g_p_async != NULL && "Asynchronous backend is not started");
+
+    async_line_t* p_line = (async_line_t*)p_record - 1;
+    p_line->size = 0;
+    p_line->p_render = p_render;
+    _push(g_p_async, p_line);
+}
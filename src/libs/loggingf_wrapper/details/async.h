@@ -0,0 +1,110 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Internal asynchronous output backend of the logging manager.
+ *  \ingroup loggingf_wrapper_module
+ *
+ *  \details    Producers format a record into a per-thread buffer, copy the
+ *      finished line into a queue node from a per-thread pool and push it
+ *      onto a lock-free multi-producer single-consumer queue (the intrusive
+ *      queue of Dmitry Vyukov: one exchange per push, no CAS loop). A writer
+ *      thread pops the lines, packs them into a large buffer and hands the
+ *      buffer to `write(2)` whenever it is full or the queue runs empty.
+ *
+ *      Producers never wake the writer: an idle writer sleeps for up to
+ *      `LOG_ASYNC_FLUSH_MS` milliseconds. \ref _lw_async_flush and
+ *      \ref _lw_async_drain wake it explicitly. The writer returns the nodes
+ *      to the pools of their producers, so the write path of a record calls
+ *      `malloc` only to grow a pool or for a line which exceeds a pooled node.
+ */
+
+#ifndef _LIBS_LOGGINGF_WRAPPER_DETAILS_ASYNC_H_
+#define _LIBS_LOGGINGF_WRAPPER_DETAILS_ASYNC_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ *  \brief  Function which renders a record of the writer thread into text.
+ *  \param  p_record - record passed to \ref _lw_async_push.
+ *  \param  p_buf - output buffer.
+ *  \param  size - size of the buffer, including the null terminator.
+ *  \return Length of the full text (which is truncated if it is not less than
+ *      `size`), like snprintf returns.
+ */
+typedef size_t (*_lw_async_render_fn_t)(const void* p_record, char* p_buf, size_t size);
+
+/**
+ *  \brief  Starts the writer thread of the asynchronous backend.
+ *  \param  fd - file descriptor to write the lines to (not closed by the backend).
+ *  \return true if the backend is started, false upon a resource allocation
+ *      error.
+ */
+bool _lw_async_start(int fd);
+
+/**
+ *  \brief  Drains the queue, stops the writer thread and releases the backend.
+ *
+ *  \details    Does nothing if the backend is not started. Must not be called
+ *      concurrently with logging.
+ */
+void _lw_async_stop(void);
+
+/**
+ *  \brief  Checks if the asynchronous backend is started.
+ */
+bool _lw_async_started(void);
+
+/**
+ *  \brief  Wakes the writer thread without waiting for it.
+ */
+void _lw_async_flush(void);
+
+/**
+ *  \brief  Waits until all lines enqueued before the call are written.
+ *  \return true if the lines are handed to `write(2)` without errors, false
+ *      if a write error occurred since the previous drain.
+ */
+bool _lw_async_drain(void);
+
+/**
+ *  \brief  Logging function of the asynchronous backend (similar to printf).
+ *  \param  p_fmt - format string.
+ *  \param  ... - format arguments.
+ *  \return Number of characters of the line or a negative value on error.
+ *
+ *  \details    Formats the line in the calling thread and enqueues it.
+ */
+int _lw_async_loggerf(const char* p_fmt, ...);
+
+/**
+ *  \brief  Allocates a queue node for a record which is rendered by the writer.
+ *  \param  size - size of the record.
+ *  \return Pointer to the record (aligned as `long long`), or NULL.
+ */
+void* _lw_async_alloc(size_t size);
+
+/**
+ *  \brief  Enqueues a record allocated by \ref _lw_async_alloc.
+ *  \param  p_record - the record, owned by the backend after the call.
+ *  \param  p_render - function which renders the record in the writer thread.
+ */
+void _lw_async_push(void* p_record, _lw_async_render_fn_t p_render);
+
+#endif /* _LIBS_LOGGINGF_WRAPPER_DETAILS_ASYNC_H_ */
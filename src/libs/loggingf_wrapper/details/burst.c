@@ -0,0 +1,431 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \ingroup loggingf_wrapper_module
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "loggingf_wrapper/burst.h"
+#include "loggingf_wrapper/details/burst.h"
+#include "loggingf_wrapper/manager.h"
+
+/** \brief  Number of the slots of the timer wheel (a power of two). */
+#define _WHEEL_SLOTS    256
+/** \brief  Number of the buckets of the channel table (a power of two). */
+#define _BUCKETS        256
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+
+lw_atomic_level_t lw_g_burst_lvl = -1;
+
+/*******************************************************************************
+ * Private functions & Data Structures
+ ******************************************************************************/
+
+struct _lw_burst_entry;
+/** \brief  Alias for the internal channel state structure. */
+typedef struct _lw_burst_entry  burst_entry_t;
+
+/**
+ *  \brief  States of the bursts of a channel.
+ */
+enum _lw_burst_state
+{
+    _BURST_IDLE,     /**< The channel may burst. */
+    _BURST_ACTIVE,   /**< The channel is bursting. */
+    _BURST_COOLDOWN  /**< The burst has ended, and the channel may not burst yet. */
+};
+
+/**
+ *  \brief  Burst state of a channel.
+ *
+ *  \details    An entry is created on the first error of its channel and is
+ *      scheduled on the timer wheel while its channel is bursting or cooling
+ *      down. It is guarded by the mutex of the engine.
+ */
+struct _lw_burst_entry
+{
+    burst_entry_t* p_next;       /**< Next entry of the bucket. */
+    burst_entry_t* p_next_timer; /**< Next entry of the slot of the timer wheel. */
+    uint64_t hash;               /**< Hash of the channel name. */
+    uint64_t expire_tick;        /**< Tick of the expiration of the timer. */
+    int state;                   /**< State of the bursts of the channel. */
+    char channel[];              /**< Null-terminated channel name. */
+};
+
+/**
+ *  \brief  State of a burst engine.
+ */
+struct lw_burst_engine
+{
+    pthread_mutex_t ctl_mutex;               /**< Mutex serializing the start and the stop. */
+    pthread_mutex_t mutex;                   /**< Mutex of the channel table, the wheel and the thread handshakes. */
+    pthread_cond_t cond;                     /**< Condition of a timer being scheduled or the stop. */
+    pthread_t thread;                        /**< Housekeeping thread. */
+    lw_burst_get_level_fn_t p_get_level;     /**< Level getter of the owner. */
+    lw_burst_set_level_fn_t p_set_level;     /**< Burst level setter of the owner. */
+    lw_burst_config_t cfg;                   /**< Configuration of the bursts. */
+    bool is_running;                         /**< Flag of the engine being started (guarded by `mutex`). */
+    bool stop;                               /**< Stop request of the thread (guarded by `mutex`). */
+    uint64_t start_ns;                       /**< Monotonic time of the tick 0. */
+    uint64_t cur_tick;                       /**< Last tick processed by the thread. */
+    size_t scheduled;                        /**< Number of the scheduled timers. */
+    size_t active;                           /**< Number of the bursting channels. */
+    burst_entry_t* slots[_WHEEL_SLOTS];      /**< Slots of the timer wheel. */
+    burst_entry_t* buckets[_BUCKETS];        /**< Buckets of the channel table. */
+};
+
+/** \brief  Burst engine of the C manager, or NULL until the first enabling. */
+static _Atomic(lw_burst_engine_t*) g_p_burst = NULL;
+/** \brief  Guard of the creation of the engine of the C manager. */
+static pthread_once_t g_burst_once = PTHREAD_ONCE_INIT;
+
+/**
+ *  \brief  Returns the monotonic time in nanoseconds.
+ */
+static uint64_t _now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ *  \brief  Returns the current tick of the timer wheel of an engine.
+ */
+static inline uint64_t _now_tick(const lw_burst_engine_t* p_burst)
+{
+    return (_now_ns() - p_burst->start_ns) / ((uint64_t)LOG_BURST_TICK_MS * 1000000u);
+}
+
+/**
+ *  \brief  FNV-1a hash of a channel name.
+ */
+static uint64_t _hash(const char* channel)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const unsigned char* p_cur = (const unsigned char*)channel; *p_cur != '\0'; ++p_cur) {
+        hash = (hash ^ *p_cur) * 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ *  \brief  Returns the entry of a channel, which is created if it is missing.
+ *  \return Entry, or NULL upon a memory allocation error.
+ */
+static burst_entry_t* _get_entry(lw_burst_engine_t* p_burst, const char* channel)
+{
+    const uint64_t hash = _hash(channel);
+    burst_entry_t** pp_bucket = &p_burst->buckets[hash & (_BUCKETS - 1)];
+    for (burst_entry_t* p_entry = *pp_bucket; p_entry != NULL; p_entry = p_entry->p_next) {
+        if (p_entry->hash == hash && strcmp(p_entry->channel, channel) == 0) {
+            return p_entry;
+        }
+    }
+
+    const size_t len = strlen(channel);
+    burst_entry_t* p_entry = (burst_entry_t*)malloc(sizeof(burst_entry_t) + len + 1);
+    if (p_entry == NULL) {
+        return NULL;
+    }
+    p_entry->p_next = *pp_bucket;
+    p_entry->p_next_timer = NULL;
+    p_entry->hash = hash;
+    p_entry->expire_tick = 0;
+    p_entry->state = _BURST_IDLE;
+    memcpy(p_entry->channel, channel, len + 1);
+    *pp_bucket = p_entry;
+    return p_entry;
+}
+
+/**
+ *  \brief  Schedules the timer of an entry, which expires after a delay.
+ */
+static void _schedule(lw_burst_engine_t* p_burst, burst_entry_t* p_entry, uint32_t delay_ms)
+{
+    uint64_t ticks = ((uint64_t)delay_ms + LOG_BURST_TICK_MS - 1) / LOG_BURST_TICK_MS;
+    p_entry->expire_tick = _now_tick(p_burst) + ((ticks != 0) ? ticks : 1);
+    if (p_entry->expire_tick <= p_burst->cur_tick) {
+        p_entry->expire_tick = p_burst->cur_tick + 1;
+    }
+    burst_entry_t** pp_slot = &p_burst->slots[p_entry->expire_tick & (_WHEEL_SLOTS - 1)];
+    p_entry->p_next_timer = *pp_slot;
+    *pp_slot = p_entry;
+    if (p_burst->scheduled++ == 0) {
+        // The thread sleeps without a deadline while no timer is scheduled.
+        pthread_cond_signal(&p_burst->cond);
+    }
+}
+
+/**
+ *  \brief  Ends the burst of a channel.
+ */
+static void _end_burst(lw_burst_engine_t* p_burst, burst_entry_t* p_entry)
+{
+    p_burst->p_set_level(p_entry->channel, -1);
+    --p_burst->active;
+}
+
+/**
+ *  \brief  Handles the expiration of the timer of an entry.
+ */
+static void _expire(lw_burst_engine_t* p_burst, burst_entry_t* p_entry)
+{
+    if (p_entry->state == _BURST_ACTIVE) {
+        _end_burst(p_burst, p_entry);
+        if (p_burst->cfg.cooldown_ms != 0) {
+            p_entry->state = _BURST_COOLDOWN;
+            _schedule(p_burst, p_entry, p_burst->cfg.cooldown_ms);
+            return;
+        }
+    }
+    p_entry->state = _BURST_IDLE;
+}
+
+/**
+ *  \brief  Expires the timers of the ticks up to the current one.
+ */
+static void _advance(lw_burst_engine_t* p_burst, uint64_t now_tick)
+{
+    // A slot holds the timers of all the ticks which are equal to it modulo
+    // the size of the wheel, so a lap visits every slot at most once.
+    const uint64_t count = (now_tick - p_burst->cur_tick < _WHEEL_SLOTS) ? now_tick - p_burst->cur_tick : _WHEEL_SLOTS;
+    for (uint64_t tick = p_burst->cur_tick + 1; tick <= p_burst->cur_tick + count; ++tick) {
+        burst_entry_t** pp_entry = &p_burst->slots[tick & (_WHEEL_SLOTS - 1)];
+        while (*pp_entry != NULL) {
+            burst_entry_t* p_entry = *pp_entry;
+            if (p_entry->expire_tick > now_tick) {
+                pp_entry = &p_entry->p_next_timer;
+                continue;
+            }
+            *pp_entry = p_entry->p_next_timer;
+            p_entry->p_next_timer = NULL;
+            --p_burst->scheduled;
+            _expire(p_burst, p_entry);
+        }
+    }
+    p_burst->cur_tick = now_tick;
+}
+
+/**
+ *  \brief  Main function of the housekeeping thread.
+ */
+static void* _burst_main(void* p_arg)
+{
+    lw_burst_engine_t* p_burst = (lw_burst_engine_t*)p_arg;
+
+    pthread_mutex_lock(&p_burst->mutex);
+    while (! p_burst->stop) {
+        if (p_burst->scheduled == 0) {
+            pthread_cond_wait(&p_burst->cond, &p_burst->mutex);
+            continue;
+        }
+        const uint64_t now_tick = _now_tick(p_burst);
+        if (now_tick > p_burst->cur_tick) {
+            _advance(p_burst, now_tick);
+            continue;
+        }
+        const uint64_t deadline_ns = p_burst->start_ns + (now_tick + 1) * (uint64_t)LOG_BURST_TICK_MS * 1000000u;
+        struct timespec deadline;
+        deadline.tv_sec = (time_t)(deadline_ns / 1000000000u);
+        deadline.tv_nsec = (long)(deadline_ns % 1000000000u);
+        pthread_cond_timedwait(&p_burst->cond, &p_burst->mutex, &deadline);
+    }
+    pthread_mutex_unlock(&p_burst->mutex);
+    return NULL;
+}
+
+/**
+ *  \brief  Stops an engine, whose `ctl_mutex` is held.
+ */
+static void _stop(lw_burst_engine_t* p_burst, bool restore)
+{
+    pthread_mutex_lock(&p_burst->mutex);
+    if (! p_burst->is_running) {
+        pthread_mutex_unlock(&p_burst->mutex);
+        return;
+    }
+    p_burst->is_running = false;
+    p_burst->stop = true;
+    pthread_cond_signal(&p_burst->cond);
+    pthread_mutex_unlock(&p_burst->mutex);
+    pthread_join(p_burst->thread, NULL);
+
+    pthread_mutex_lock(&p_burst->mutex);
+    for (size_t b = 0; b < _BUCKETS; ++b) {
+        while (p_burst->buckets[b] != NULL) {
+            burst_entry_t* p_entry = p_burst->buckets[b];
+            p_burst->buckets[b] = p_entry->p_next;
+            if (restore && (p_entry->state == _BURST_ACTIVE)) {
+                _end_burst(p_burst, p_entry);
+            }
+            free(p_entry);
+        }
+    }
+    memset(p_burst->slots, 0, sizeof(p_burst->slots));
+    p_burst->scheduled = 0;
+    p_burst->active = 0;
+    pthread_mutex_unlock(&p_burst->mutex);
+}
+
+/**
+ *  \brief  Returns the effective level of a channel of the C manager.
+ */
+static int _get_channel_level(const char* channel)
+{
+    lw_loggerf_t p_logger = lw_get_logger(channel);
+    return (p_logger != NULL) ? _LW_LEVEL_LOAD(p_logger->eff_level) : -1;
+}
+
+/**
+ *  \brief  Creates the engine of the C manager.
+ */
+static void _create_c_burst(void)
+{
+    atomic_store_explicit(&g_p_burst, lw_burst_engine_create(_get_channel_level, _lw_set_burst_level), memory_order_release);
+}
+
+/*******************************************************************************
+ * Internal interface
+ ******************************************************************************/
+
+void _lw_burst_release(void)
+{
+    lw_burst_engine_t* p_burst = atomic_load_explicit(&g_p_burst, memory_order_acquire);
+    if (p_burst != NULL) {
+        atomic_store_explicit(&lw_g_burst_lvl, -1, memory_order_relaxed);
+        lw_burst_engine_stop(p_burst, false);
+    }
+}
+
+/*******************************************************************************
+ * Public interface
+ ******************************************************************************/
+
+lw_burst_engine_t* lw_burst_engine_create(lw_burst_get_level_fn_t p_get_level, lw_burst_set_level_fn_t p_set_level)
+{
+    lw_burst_engine_t* p_burst = (lw_burst_engine_t*)calloc(1, sizeof(lw_burst_engine_t));
+    if (p_burst == NULL) {
+        return NULL;
+    }
+
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_mutex_init(&p_burst->ctl_mutex, NULL);
+    pthread_mutex_init(&p_burst->mutex, NULL);
+    pthread_cond_init(&p_burst->cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    p_burst->p_get_level = p_get_level;
+    p_burst->p_set_level = p_set_level;
+    return p_burst;
+}
+
+bool lw_burst_engine_start(lw_burst_engine_t* p_burst, int lvl, uint32_t window_ms, uint32_t cooldown_ms, uint32_t max_active)
+{
+    if ((lvl < LVL_EMERG) || (lvl > LVL_TRACE) || (window_ms == 0)) {
+        return false;
+    }
+
+    pthread_mutex_lock(&p_burst->ctl_mutex);
+    _stop(p_burst, true);
+
+    pthread_mutex_lock(&p_burst->mutex);
+    p_burst->cfg.level = (lw_severity_level_t)lvl;
+    p_burst->cfg.window_ms = window_ms;
+    p_burst->cfg.cooldown_ms = cooldown_ms;
+    p_burst->cfg.max_active = max_active;
+    p_burst->stop = false;
+    p_burst->start_ns = _now_ns();
+    p_burst->cur_tick = 0;
+    const bool is_started = (pthread_create(&p_burst->thread, NULL, _burst_main, p_burst) == 0);
+    p_burst->is_running = is_started;
+    pthread_mutex_unlock(&p_burst->mutex);
+
+    pthread_mutex_unlock(&p_burst->ctl_mutex);
+    return is_started;
+}
+
+void lw_burst_engine_stop(lw_burst_engine_t* p_burst, bool restore)
+{
+    pthread_mutex_lock(&p_burst->ctl_mutex);
+    _stop(p_burst, restore);
+    pthread_mutex_unlock(&p_burst->ctl_mutex);
+}
+
+void lw_burst_engine_trigger(lw_burst_engine_t* p_burst, const char* channel)
+{
+    pthread_mutex_lock(&p_burst->mutex);
+    if (! p_burst->is_running) {
+        pthread_mutex_unlock(&p_burst->mutex);
+        return;
+    }
+    burst_entry_t* p_entry = _get_entry(p_burst, channel);
+    if ((p_entry == NULL) || (p_entry->state != _BURST_IDLE)
+        || ((p_burst->cfg.max_active != 0) && (p_burst->active >= p_burst->cfg.max_active))) {
+        pthread_mutex_unlock(&p_burst->mutex);
+        return;
+    }
+    const int lvl = p_burst->p_get_level(channel);
+    if ((lvl >= 0) && (lvl < (int)p_burst->cfg.level)) {
+        p_entry->state = _BURST_ACTIVE;
+        ++p_burst->active;
+        p_burst->p_set_level(channel, (int)p_burst->cfg.level);
+        _schedule(p_burst, p_entry, p_burst->cfg.window_ms);
+    }
+    pthread_mutex_unlock(&p_burst->mutex);
+}
+
+bool lw_enable_burst(const lw_burst_config_t* p_cfg)
+{
+    pthread_once(&g_burst_once, _create_c_burst);
+    lw_burst_engine_t* p_burst = atomic_load_explicit(&g_p_burst, memory_order_acquire);
+    if ((p_cfg == NULL) || (p_burst == NULL)
+        || ! lw_burst_engine_start(p_burst, (int)p_cfg->level, p_cfg->window_ms, p_cfg->cooldown_ms, p_cfg->max_active)) {
+        return false;
+    }
+    atomic_store_explicit(&lw_g_burst_lvl, (int)p_cfg->level, memory_order_relaxed);
+    return true;
+}
+
+void lw_disable_burst(void)
+{
+    lw_burst_engine_t* p_burst = atomic_load_explicit(&g_p_burst, memory_order_acquire);
+    if (p_burst != NULL) {
+        atomic_store_explicit(&lw_g_burst_lvl, -1, memory_order_relaxed);
+        lw_burst_engine_stop(p_burst, true);
+    }
+}
+
+void lw_burst_trigger(lw_loggerf_t p_logger)
+{
+    lw_burst_engine_t* p_burst = atomic_load_explicit(&g_p_burst, memory_order_acquire);
+    if ((p_logger != NULL) && (p_burst != NULL)) {
+        lw_burst_engine_trigger(p_burst, p_logger->channel);
+    }
+}
@@ -0,0 +1,55 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Internal interface of the burst engine of the C manager
+ *      (see `loggingf_wrapper/burst.h`).
+ *  \ingroup loggingf_wrapper_module
+ */
+
+#ifndef _LIBS_LOGGINGF_WRAPPER_DETAILS_BURST_H_
+#define _LIBS_LOGGINGF_WRAPPER_DETAILS_BURST_H_
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ *  \brief  Sets the burst level of a channel of the C manager.
+ *  \param  channel - channel name.
+ *  \param  lvl - level of the burst, or -1 to end it.
+ *
+ *  \details    Defined by the C manager, which folds the level into the
+ *      effective level of the channel.
+ */
+void _lw_set_burst_level(const char* channel, int lvl);
+
+/**
+ *  \brief  Releases the burst engine of the C manager without ending the
+ *      bursts of its channels.
+ *
+ *  \details    Called on deinitialization of the manager, as the engine
+ *      refers to its channels.
+ */
+void _lw_burst_release(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _LIBS_LOGGINGF_WRAPPER_DETAILS_BURST_H_ */
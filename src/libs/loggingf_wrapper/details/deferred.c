@@ -0,0 +1,872 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \ingroup loggingf_wrapper_module
+ */
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "loggingf_wrapper/deferred.h"
+#include "loggingf_wrapper/format.h"
+#include "loggingf_wrapper/details/async.h"
+#include "loggingf_wrapper/details/flight.h"
+#include "loggingf_wrapper/severity_level.h"
+
+/** \brief  Maximum length of a conversion specification which is rendered. */
+#define _SPEC_LEN           64
+/** \brief  Number of the bits of a site id which index a chunk of the table. */
+#define _SITE_CHUNK_BITS    10
+/** \brief  Number of the sites of a chunk of the table. */
+#define _SITE_CHUNK_SIZE    (1u << _SITE_CHUNK_BITS)
+/** \brief  Number of the chunks of the table (up to 4M sites). */
+#define _SITE_CHUNKS        4096u
+/** \brief  Size of the size prefix of a record of the flight recorder. */
+#define _FLIGHT_HDR         sizeof(size_t)
+/** \brief  Capacity of a buffer of the flight recorder (a multiple of the alignment). */
+#define _FLIGHT_CAP         ((size_t)LOG_FLIGHT_BUF_SIZE & ~(size_t)7)
+
+_Static_assert(_FLIGHT_CAP > 0, "LOG_FLIGHT_BUF_SIZE is too small");
+
+/*******************************************************************************
+ * Private functions & Data Structures
+ ******************************************************************************/
+
+struct _lw_deferred_record;
+/** \brief  Alias for the internal deferred record structure. */
+typedef struct _lw_deferred_record  deferred_record_t;
+struct _lw_output;
+/** \brief  Alias for the internal output buffer structure. */
+typedef struct _lw_output           output_t;
+struct _lw_conv_spec;
+/** \brief  Alias for the internal conversion specification structure. */
+typedef struct _lw_conv_spec        conv_spec_t;
+struct _lw_flight_buffer;
+/** \brief  Alias for the internal flight recorder buffer structure. */
+typedef struct _lw_flight_buffer    flight_buffer_t;
+
+/**
+ *  \brief  Deferred record of a logging statement.
+ *
+ *  \details    The statement is referenced by its interned id. The copies of
+ *      the string arguments follow the arguments in the same allocation, and
+ *      the arguments point to them.
+ */
+struct _lw_deferred_record
+{
+    lw_loggerf_t logger; /**< Logger of the channel. */
+    uint64_t ts_ns;      /**< Time of the record, in nanoseconds since the Epoch. */
+    uint32_t site_id;    /**< Id of the statement. */
+    int level;           /**< Severity level of the record. */
+    lw_arg_t args[];     /**< Values of the arguments. */
+};
+
+/**
+ *  \brief  Circular buffer of the flight recorder of a thread.
+ *
+ *  \details    Every record is prefixed by its size and never wraps around:
+ *      if it does not fit behind the newest record, it is placed at offset 0,
+ *      and the oldest records are dropped until it fits. While the buffer is
+ *      wrapped, the records are `[head, end)` followed by `[0, tail)`,
+ *      otherwise `[head, tail)`.
+ */
+struct _lw_flight_buffer
+{
+    pthread_mutex_t mutex;        /**< Mutex of the buffer (its thread and the dumps). */
+    flight_buffer_t* p_next;      /**< Next buffer of the global list. */
+    size_t head;                  /**< Offset of the oldest record. */
+    size_t tail;                  /**< Offset of the next record. */
+    size_t end;                   /**< End of the records behind the head, if wrapped. */
+    size_t count;                 /**< Number of the records. */
+    bool wrapped;                 /**< Flag of the records which continue from offset 0. */
+    _Alignas(8) char data[_FLIGHT_CAP]; /**< Records. */
+};
+
+/**
+ *  \brief  Output buffer with snprintf semantics.
+ *
+ *  \details    Counts the full length of the text, but writes only the part
+ *      which fits into the buffer.
+ */
+struct _lw_output
+{
+    char* p_buf; /**< Output buffer. */
+    size_t size; /**< Size of the buffer. */
+    size_t len;  /**< Length of the full text. */
+};
+
+/**
+ *  \brief  Length modifiers of a conversion specification.
+ */
+enum _lw_length
+{
+    _LEN_NONE,
+    _LEN_HH,
+    _LEN_H,
+    _LEN_L,
+    _LEN_LL
+};
+
+/** \brief  Tags of the severity levels. */
+static const char* const g_level_tags[] = {
+    LOGF_LEVEL(0), LOGF_LEVEL(1), LOGF_LEVEL(2), LOGF_LEVEL(3), LOGF_LEVEL(4),
+    LOGF_LEVEL(5), LOGF_LEVEL(6), LOGF_LEVEL(7), LOGF_LEVEL(8)
+};
+
+/**
+ *  \brief  Table of the interned sites, indexed by id.
+ *
+ *  \details    The chunks are allocated on demand and published by CAS, and
+ *      are never released: the sites are static.
+ */
+static const lw_log_site_t** g_site_chunks[_SITE_CHUNKS];
+/** \brief  Last assigned site id. */
+static uint32_t g_site_count = 0;
+
+lw_atomic_level_t lw_g_capture_lvl = LW_CAPTURE_OFF;
+
+/** \brief  Mutex of the list of the flight recorder buffers and of the dumps. */
+static pthread_mutex_t g_flight_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** \brief  List of the flight recorder buffers of all threads. */
+static flight_buffer_t* g_p_flight_list = NULL;
+/** \brief  Flag of the records captured since the last dump. */
+static bool g_flight_dirty = false;
+/** \brief  Key which releases the buffer of an exiting thread. */
+static pthread_key_t g_flight_key;
+/** \brief  Once flag of the creation of `g_flight_key`. */
+static pthread_once_t g_flight_once = PTHREAD_ONCE_INIT;
+/** \brief  Flight recorder buffer of the current thread, or NULL. */
+static _Thread_local flight_buffer_t* tl_p_flight = NULL;
+
+/**
+ *  \brief  Returns the chunk of the table, allocating it if needed.
+ *  \return Pointer to the chunk, or NULL upon an allocation error.
+ */
+static const lw_log_site_t** _site_chunk(uint32_t chunk)
+{
+    const lw_log_site_t** p_chunk = __atomic_load_n(&g_site_chunks[chunk], __ATOMIC_ACQUIRE);
+    if (p_chunk != NULL) {
+        return p_chunk;
+    }
+    const lw_log_site_t** p_new = (const lw_log_site_t**)calloc(_SITE_CHUNK_SIZE, sizeof(lw_log_site_t*));
+    if (p_new == NULL) {
+        return NULL;
+    }
+    if (! __atomic_compare_exchange_n(&g_site_chunks[chunk], &p_chunk, p_new, false,
+                                      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        // Another thread has published the chunk.
+        free(p_new);
+        return p_chunk;
+    }
+    return p_new;
+}
+
+/**
+ *  \brief  Appends characters to the output.
+ */
+static void _put(output_t* p_out, const char* p_data, size_t size)
+{
+    if (p_out->len + 1 < p_out->size) {
+        const size_t room = p_out->size - 1 - p_out->len;
+        memcpy(p_out->p_buf + p_out->len, p_data, (size < room) ? size : room);
+    }
+    p_out->len += size;
+}
+
+/**
+ *  \brief  Appends formatted text to the output.
+ */
+static __attribute__((format(printf, 2, 3))) void _put_fmt(output_t* p_out, const char* p_fmt, ...)
+{
+    const bool fits = p_out->len < p_out->size;
+    va_list args;
+    va_start(args, p_fmt);
+    const int rc = vsnprintf(fits ? p_out->p_buf + p_out->len : NULL,
+                             fits ? p_out->size - p_out->len : 0, p_fmt, args);
+    va_end(args);
+    if (rc > 0) {
+        p_out->len += (size_t)rc;
+    }
+}
+
+/**
+ *  \brief  Terminates the text of the output.
+ */
+static void _terminate(output_t* p_out)
+{
+    if (p_out->size > 0) {
+        p_out->p_buf[(p_out->len < p_out->size) ? p_out->len : p_out->size - 1] = '\0';
+    }
+}
+
+/**
+ *  \brief  Returns the value of an argument as a signed integer.
+ */
+static long long _arg_int(const lw_log_site_t* p_site, const lw_arg_t* p_args, size_t i)
+{
+    switch (p_site->p_types[i]) {
+    case LW_ARG_INT:    return p_args[i].i;
+    case LW_ARG_UINT:   return (long long)p_args[i].u;
+    case LW_ARG_DOUBLE: return (long long)p_args[i].d;
+    default:            return (long long)(intptr_t)p_args[i].p;
+    }
+}
+
+/**
+ *  \brief  Returns the value of an argument as a floating point number.
+ */
+static double _arg_double(const lw_log_site_t* p_site, const lw_arg_t* p_args, size_t i)
+{
+    switch (p_site->p_types[i]) {
+    case LW_ARG_INT:    return (double)p_args[i].i;
+    case LW_ARG_UINT:   return (double)p_args[i].u;
+    case LW_ARG_DOUBLE: return p_args[i].d;
+    default:            return 0.0;
+    }
+}
+
+/**
+ *  \brief  Converts an integer as printf converts it by the length modifier.
+ */
+static long long _cast_signed(long long v, enum _lw_length length)
+{
+    switch (length) {
+    case _LEN_HH:   return (signed char)v;
+    case _LEN_H:    return (short)v;
+    case _LEN_NONE: return (int)v;
+    case _LEN_L:    return (long)v;
+    default:        return v;
+    }
+}
+
+/**
+ *  \brief  Converts an unsigned integer as printf converts it by the length
+ *      modifier.
+ */
+static unsigned long long _cast_unsigned(unsigned long long v, enum _lw_length length)
+{
+    switch (length) {
+    case _LEN_HH:   return (unsigned char)v;
+    case _LEN_H:    return (unsigned short)v;
+    case _LEN_NONE: return (unsigned int)v;
+    case _LEN_L:    return (unsigned long)v;
+    default:        return v;
+    }
+}
+
+/**
+ *  \brief  Parsed conversion specification.
+ */
+struct _lw_conv_spec
+{
+    char spec[_SPEC_LEN];   /**< Flags, width and precision, with `*` replaced by values. */
+    size_t spec_len;        /**< Length of the specification. */
+    enum _lw_length length; /**< Length modifier. */
+    char conv;              /**< Conversion character, or 0 if it is invalid. */
+    const char* p_end;      /**< Character which follows the specification. */
+};
+
+/**
+ *  \brief  Appends the value of a `*` field to the specification.
+ */
+static void _spec_star(conv_spec_t* p_spec, const lw_log_site_t* p_site,
+                       const lw_arg_t* p_args, size_t* p_next, bool precision)
+{
+    int value = 0;
+    if (*p_next < p_site->nargs) {
+        value = (int)_arg_int(p_site, p_args, (*p_next)++);
+    }
+    if (precision && value < 0) {
+        // A negative precision is taken as if it were omitted.
+        --p_spec->spec_len;
+        return;
+    }
+    const int rc = snprintf(p_spec->spec + p_spec->spec_len, _SPEC_LEN - p_spec->spec_len, "%d", value);
+    p_spec->spec_len += (rc > 0) ? (size_t)rc : 0;
+    p_spec->spec_len = (p_spec->spec_len < _SPEC_LEN) ? p_spec->spec_len : _SPEC_LEN - 1;
+}
+
+/**
+ *  \brief  Parses a conversion specification.
+ *  \param  p_fmt - character which follows the `%`.
+ *  \param  p_args - values of the arguments, or NULL to skip the `*` fields.
+ *  \param  p_next - index of the next argument, advanced by the `*` fields.
+ *
+ *  \details    The specification is limited so that a `*` value, a length
+ *      modifier and a conversion always fit into the buffer; the rest of a
+ *      longer one is taken as an invalid conversion.
+ */
+static void _parse_spec(conv_spec_t* p_spec, const char* p_fmt, const lw_log_site_t* p_site,
+                        const lw_arg_t* p_args, size_t* p_next)
+{
+    p_spec->spec[0] = '%';
+    p_spec->spec_len = 1;
+    p_spec->length = _LEN_NONE;
+    p_spec->conv = '\0';
+
+    bool precision = false;
+    for (; *p_fmt != '\0' && p_spec->spec_len + 16 < _SPEC_LEN; ++p_fmt) {
+        const char c = *p_fmt;
+        if (c == '*') {
+            if (p_args != NULL) {
+                _spec_star(p_spec, p_site, p_args, p_next, precision);
+            } else {
+                ++(*p_next);
+            }
+            continue;
+        }
+        if (c == '.') {
+            precision = true;
+        }
+        if (strchr("-+ #0'.123456789", c) == NULL) {
+            break;
+        }
+        p_spec->spec[p_spec->spec_len++] = c;
+    }
+    p_spec->spec[p_spec->spec_len] = '\0';
+
+    for (;; ++p_fmt) {
+        if (*p_fmt == 'h') {
+            p_spec->length = (p_spec->length == _LEN_H) ? _LEN_HH : _LEN_H;
+        } else if (*p_fmt == 'l') {
+            p_spec->length = (p_spec->length == _LEN_L) ? _LEN_LL : _LEN_L;
+        } else if (*p_fmt == 'j' || *p_fmt == 'z' || *p_fmt == 't' || *p_fmt == 'q') {
+            p_spec->length = _LEN_LL;
+        } else if (*p_fmt != 'L') {
+            break;
+        }
+    }
+    if (*p_fmt != '\0' && strchr("diouxXcfFeEgGaAspn%", *p_fmt) != NULL) {
+        p_spec->conv = *p_fmt++;
+    }
+    p_spec->p_end = p_fmt;
+}
+
+/**
+ *  \brief  Returns the mask of the string arguments printed by `%s`.
+ */
+static unsigned int _find_str_mask(const lw_log_site_t* p_site)
+{
+    unsigned int mask = 0;
+    size_t next = 0;
+    for (const char* p_fmt = strchr(p_site->fmt, '%'); p_fmt != NULL; p_fmt = strchr(p_fmt, '%')) {
+        conv_spec_t spec;
+        _parse_spec(&spec, p_fmt + 1, p_site, NULL, &next);
+        p_fmt = spec.p_end;
+        if (spec.conv == '%' || spec.conv == '\0') {
+            continue;
+        }
+        if (next < p_site->nargs && spec.conv == 's' && p_site->p_types[next] == LW_ARG_STR) {
+            mask |= 1u << next;
+        }
+        ++next;
+    }
+    return mask;
+}
+
+/**
+ *  \brief  Renders the message of a statement into the output.
+ */
+static void _format_message(output_t* p_out, const lw_log_site_t* p_site, const lw_arg_t* p_args)
+{
+    const char* p_fmt = p_site->fmt;
+    size_t next = 0;
+    for (;;) {
+        const char* p_pct = strchr(p_fmt, '%');
+        if (p_pct == NULL) {
+            _put(p_out, p_fmt, strlen(p_fmt));
+            return;
+        }
+        _put(p_out, p_fmt, (size_t)(p_pct - p_fmt));
+
+        conv_spec_t spec;
+        _parse_spec(&spec, p_pct + 1, p_site, p_args, &next);
+        p_fmt = spec.p_end;
+        if (spec.conv == '%') {
+            _put(p_out, "%", 1);
+            continue;
+        }
+        if (spec.conv == '\0' || next >= p_site->nargs) {
+            // Invalid specification or missing argument: print it as is.
+            _put(p_out, p_pct, (size_t)(p_fmt - p_pct));
+            continue;
+        }
+
+        const size_t i = next++;
+        char* p_conv = spec.spec + spec.spec_len;
+        if (spec.spec_len == 1 && (spec.conv == 'd' || spec.conv == 'i' || spec.conv == 'u')) {
+            // Plain integer conversion: no flags, width or precision.
+            char digits[LW_FORMAT_INT_LEN];
+            const long long value = _arg_int(p_site, p_args, i);
+            const size_t len = (spec.conv == 'u')
+                ? lw_format_u64(digits, (uint64_t)_cast_unsigned((unsigned long long)value, spec.length))
+                : lw_format_i64(digits, (int64_t)_cast_signed(value, spec.length));
+            _put(p_out, digits, len);
+            continue;
+        }
+        switch (spec.conv) {
+        case 'd':
+        case 'i':
+            memcpy(p_conv, "ll", 2);
+            p_conv[2] = spec.conv;
+            p_conv[3] = '\0';
+            _put_fmt(p_out, spec.spec, _cast_signed(_arg_int(p_site, p_args, i), spec.length));
+            break;
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            memcpy(p_conv, "ll", 2);
+            p_conv[2] = spec.conv;
+            p_conv[3] = '\0';
+            _put_fmt(p_out, spec.spec, _cast_unsigned((unsigned long long)_arg_int(p_site, p_args, i), spec.length));
+            break;
+        case 'c':
+            memcpy(p_conv, "c", 2);
+            _put_fmt(p_out, spec.spec, (int)_arg_int(p_site, p_args, i));
+            break;
+        case 's':
+            if (p_site->p_types[i] == LW_ARG_STR) {
+                memcpy(p_conv, "s", 2);
+                _put_fmt(p_out, spec.spec, p_args[i].s);
+            } else {
+                _put_fmt(p_out, "%p", p_args[i].p);
+            }
+            break;
+        case 'p':
+            memcpy(p_conv, "p", 2);
+            _put_fmt(p_out, spec.spec, p_args[i].p);
+            break;
+        case 'n':
+            break;
+        default:
+            p_conv[0] = spec.conv;
+            p_conv[1] = '\0';
+            _put_fmt(p_out, spec.spec, _arg_double(p_site, p_args, i));
+            break;
+        }
+    }
+}
+
+/**
+ *  \brief  Renders a full line of a record: the timestamp, the level, the
+ *      channel and the message.
+ */
+static void _format_line(output_t* p_out, uint64_t ts_ns, int level,
+                         lw_loggerf_t logger, const lw_log_site_t* p_site, const lw_arg_t* p_args)
+{
+    const time_t sec = (time_t)(ts_ns / 1000000000u);
+    struct tm cur_tm;
+    if (localtime_r(&sec, &cur_tm) != NULL) {
+        _put_fmt(p_out, "%04d-%02d-%02d %02d:%02d:%02d.%03d %s %s: ",
+                 cur_tm.tm_year + 1900, cur_tm.tm_mon + 1, cur_tm.tm_mday,
+                 cur_tm.tm_hour, cur_tm.tm_min, cur_tm.tm_sec, (int)(ts_ns % 1000000000u / 1000000u),
+                 g_level_tags[level], logger->channel);
+    } else {
+        _put_fmt(p_out, "yyyy-MM-dd hh:mm:ss.mil %s %s: ", g_level_tags[level], logger->channel);
+    }
+    _format_message(p_out, p_site, p_args);
+    _put(p_out, "\n", 1);
+    _terminate(p_out);
+}
+
+/**
+ *  \brief  Renders a deferred record (called by the writer thread).
+ */
+static size_t _render_record(const void* p_data, char* p_buf, size_t size)
+{
+    const deferred_record_t* p_record = (const deferred_record_t*)p_data;
+    output_t out = { p_buf, size, 0 };
+    _format_line(&out, p_record->ts_ns, p_record->level, p_record->logger,
+                 lw_log_site_get(p_record->site_id), p_record->args);
+    return out.len;
+}
+
+/**
+ *  \brief  Renders a record in the calling thread and passes it to the output
+ *      function of the logger.
+ */
+static void _log_sync(lw_loggerf_t logger, int level, uint64_t ts_ns,
+                      const lw_log_site_t* p_site, const lw_arg_t* p_args)
+{
+    char line[LOG_ASYNC_LINE_LEN];
+    output_t out = { line, sizeof(line), 0 };
+    _format_line(&out, ts_ns, level, logger, p_site, p_args);
+    if (out.len < sizeof(line)) {
+        logger->p_logger("%s", line);
+        return;
+    }
+
+    // The line is longer than the buffer: render it again.
+    out.p_buf = (char*)malloc(out.len + 1);
+    if (out.p_buf == NULL) {
+        return;
+    }
+    out.size = out.len + 1;
+    out.len = 0;
+    _format_line(&out, ts_ns, level, logger, p_site, p_args);
+    logger->p_logger("%s", out.p_buf);
+    free(out.p_buf);
+}
+
+/**
+ *  \brief  Returns the size of the record of a statement.
+ *  \param  str_mask - mask of the arguments copied as strings.
+ *  \param  p_str_sizes - set to the sizes of the copies of the strings.
+ */
+static size_t _record_size(const lw_log_site_t* p_site, const lw_arg_t* p_args,
+                           unsigned int str_mask, size_t* p_str_sizes)
+{
+    size_t size = sizeof(deferred_record_t) + p_site->nargs * sizeof(lw_arg_t);
+    for (unsigned int mask = str_mask; mask != 0; mask &= mask - 1) {
+        const int i = __builtin_ctz(mask);
+        p_str_sizes[i] = (p_args[i].s != NULL) ? strlen(p_args[i].s) + 1 : 0;
+        size += p_str_sizes[i];
+    }
+    return size;
+}
+
+/**
+ *  \brief  Fills a record of the size returned by \ref _record_size.
+ */
+static void _fill_record(deferred_record_t* p_record, lw_loggerf_t logger, int level, uint64_t ts_ns,
+                         uint32_t site_id, const lw_log_site_t* p_site, const lw_arg_t* p_args,
+                         unsigned int str_mask, const size_t* p_str_sizes)
+{
+    p_record->logger = logger;
+    p_record->ts_ns = ts_ns;
+    p_record->site_id = site_id;
+    p_record->level = level;
+    memcpy(p_record->args, p_args, p_site->nargs * sizeof(lw_arg_t));
+
+    char* p_strings = (char*)(p_record->args + p_site->nargs);
+    for (unsigned int mask = str_mask; mask != 0; mask &= mask - 1) {
+        const int i = __builtin_ctz(mask);
+        if (p_str_sizes[i] != 0) {
+            memcpy(p_strings, p_args[i].s, p_str_sizes[i]);
+            p_record->args[i].s = p_strings;
+            p_strings += p_str_sizes[i];
+        }
+    }
+}
+
+/**
+ *  \brief  Unlinks and releases the flight recorder buffer of an exiting thread.
+ */
+static void _flight_thread_exit(void* p_arg)
+{
+    flight_buffer_t* p_buf = (flight_buffer_t*)p_arg;
+    pthread_mutex_lock(&g_flight_mutex);
+    for (flight_buffer_t** pp_cur = &g_p_flight_list; *pp_cur != NULL; pp_cur = &(*pp_cur)->p_next) {
+        if (*pp_cur == p_buf) {
+            *pp_cur = p_buf->p_next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&g_flight_mutex);
+    pthread_mutex_destroy(&p_buf->mutex);
+    free(p_buf);
+    tl_p_flight = NULL;
+}
+
+/**
+ *  \brief  Creates the key which releases the buffers of exiting threads.
+ */
+static void _flight_init_key(void)
+{
+    pthread_key_create(&g_flight_key, _flight_thread_exit);
+}
+
+/**
+ *  \brief  Returns the flight recorder buffer of the current thread, creating
+ *      it on the first call.
+ *  \return Pointer to the buffer, or NULL upon an allocation error.
+ */
+static flight_buffer_t* _flight_buffer(void)
+{
+    if (tl_p_flight != NULL) {
+        return tl_p_flight;
+    }
+    pthread_once(&g_flight_once, _flight_init_key);
+    flight_buffer_t* p_buf = (flight_buffer_t*)malloc(sizeof(flight_buffer_t));
+    if (p_buf == NULL) {
+        return NULL;
+    }
+    pthread_mutex_init(&p_buf->mutex, NULL);
+    p_buf->head = 0;
+    p_buf->tail = 0;
+    p_buf->end = 0;
+    p_buf->count = 0;
+    p_buf->wrapped = false;
+
+    pthread_mutex_lock(&g_flight_mutex);
+    p_buf->p_next = g_p_flight_list;
+    g_p_flight_list = p_buf;
+    pthread_mutex_unlock(&g_flight_mutex);
+    pthread_setspecific(g_flight_key, p_buf);
+    tl_p_flight = p_buf;
+    return p_buf;
+}
+
+/**
+ *  \brief  Returns the oldest record of a non-empty buffer.
+ */
+static const deferred_record_t* _flight_front(const flight_buffer_t* p_buf)
+{
+    return (const deferred_record_t*)(p_buf->data + p_buf->head + _FLIGHT_HDR);
+}
+
+/**
+ *  \brief  Drops the oldest record of a non-empty buffer.
+ */
+static void _flight_pop(flight_buffer_t* p_buf)
+{
+    size_t size;
+    memcpy(&size, p_buf->data + p_buf->head, sizeof(size));
+    p_buf->head += size;
+    --p_buf->count;
+    if (p_buf->wrapped && p_buf->head == p_buf->end) {
+        p_buf->head = 0;
+        p_buf->wrapped = false;
+    }
+}
+
+/**
+ *  \brief  Reserves space for a record, dropping the oldest records if needed.
+ *  \param  size - size of the record, including its prefix (aligned).
+ *  \return Pointer to the record, or NULL if it is larger than the buffer.
+ */
+static deferred_record_t* _flight_reserve(flight_buffer_t* p_buf, size_t size)
+{
+    if (size > _FLIGHT_CAP) {
+        return NULL;
+    }
+    for (;;) {
+        if (p_buf->count == 0) {
+            p_buf->head = 0;
+            p_buf->tail = 0;
+            p_buf->wrapped = false;
+        }
+        if (! p_buf->wrapped) {
+            if (p_buf->tail + size <= _FLIGHT_CAP) {
+                break;
+            }
+            // Continue from the beginning of the buffer.
+            p_buf->end = p_buf->tail;
+            p_buf->tail = 0;
+            p_buf->wrapped = true;
+        } else if (p_buf->tail + size <= p_buf->head) {
+            break;
+        } else {
+            _flight_pop(p_buf);
+        }
+    }
+    char* p_entry = p_buf->data + p_buf->tail;
+    memcpy(p_entry, &size, sizeof(size));
+    p_buf->tail += size;
+    ++p_buf->count;
+    return (deferred_record_t*)(p_entry + _FLIGHT_HDR);
+}
+
+/**
+ *  \brief  Captures a record into the flight recorder buffer of the current
+ *      thread.
+ */
+static void _flight_capture(lw_loggerf_t logger, int level, uint64_t ts_ns, const lw_log_site_t* p_site,
+                            uint32_t site_id, const lw_arg_t* p_args)
+{
+    flight_buffer_t* p_buf = _flight_buffer();
+    if (p_buf == NULL) {
+        return;
+    }
+    const unsigned int str_mask = __atomic_load_n(&p_site->str_mask, __ATOMIC_RELAXED);
+    size_t str_sizes[_LW_MAX_ARGS];
+    const size_t size = (_FLIGHT_HDR + _record_size(p_site, p_args, str_mask, str_sizes) + 7) & ~(size_t)7;
+
+    pthread_mutex_lock(&p_buf->mutex);
+    deferred_record_t* p_record = _flight_reserve(p_buf, size);
+    if (p_record != NULL) {
+        _fill_record(p_record, logger, level, ts_ns, site_id, p_site, p_args, str_mask, str_sizes);
+    }
+    pthread_mutex_unlock(&p_buf->mutex);
+    if (p_record != NULL && ! __atomic_load_n(&g_flight_dirty, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&g_flight_dirty, true, __ATOMIC_RELEASE);
+    }
+}
+
+/*******************************************************************************
+ * Internal interface
+ ******************************************************************************/
+
+void _lw_flight_release(void)
+{
+    atomic_store_explicit(&lw_g_capture_lvl, LW_CAPTURE_OFF, memory_order_relaxed);
+    pthread_mutex_lock(&g_flight_mutex);
+    for (flight_buffer_t* p_buf = g_p_flight_list; p_buf != NULL; p_buf = p_buf->p_next) {
+        pthread_mutex_lock(&p_buf->mutex);
+        p_buf->count = 0;
+        pthread_mutex_unlock(&p_buf->mutex);
+    }
+    __atomic_store_n(&g_flight_dirty, false, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&g_flight_mutex);
+}
+
+/*******************************************************************************
+ * Public interface
+ ******************************************************************************/
+
+uint32_t lw_log_site_register(const lw_log_site_t* p_site)
+{
+    lw_log_site_t* p_mutable_site = (lw_log_site_t*)p_site;
+    uint32_t id = __atomic_load_n(&p_mutable_site->id, __ATOMIC_ACQUIRE);
+    if (id != 0) {
+        return id;
+    }
+
+    // The mask may be computed concurrently by several threads, but always
+    // to the same value, and it is published by the release of the id.
+    __atomic_store_n(&p_mutable_site->str_mask, _find_str_mask(p_site), __ATOMIC_RELAXED);
+    // The limit is checked on the id, which is published, so concurrent
+    // registrations cannot pass it together.
+    uint32_t count = __atomic_load_n(&g_site_count, __ATOMIC_RELAXED);
+    do {
+        if (count >= _SITE_CHUNKS * _SITE_CHUNK_SIZE - 1) {
+            return 0;
+        }
+    } while (! __atomic_compare_exchange_n(&g_site_count, &count, count + 1, true,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    const uint32_t new_id = count + 1;
+    const lw_log_site_t** p_chunk = _site_chunk(new_id >> _SITE_CHUNK_BITS);
+    if (p_chunk == NULL) {
+        return 0;
+    }
+    const lw_log_site_t** p_slot = &p_chunk[new_id & (_SITE_CHUNK_SIZE - 1)];
+    __atomic_store_n(p_slot, p_site, __ATOMIC_RELEASE);
+    if (! __atomic_compare_exchange_n(&p_mutable_site->id, &id, new_id, false,
+                                      __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        // Another thread has interned the site: its id wins, this one is
+        // left unassigned.
+        __atomic_store_n(p_slot, NULL, __ATOMIC_RELEASE);
+        return id;
+    }
+    return new_id;
+}
+
+const lw_log_site_t* lw_log_site_get(uint32_t id)
+{
+    if (id == 0 || id > __atomic_load_n(&g_site_count, __ATOMIC_ACQUIRE)) {
+        return NULL;
+    }
+    const lw_log_site_t** p_chunk = __atomic_load_n(&g_site_chunks[id >> _SITE_CHUNK_BITS], __ATOMIC_ACQUIRE);
+    return (p_chunk != NULL) ? __atomic_load_n(&p_chunk[id & (_SITE_CHUNK_SIZE - 1)], __ATOMIC_ACQUIRE) : NULL;
+}
+
+uint32_t lw_log_site_count(void)
+{
+    return __atomic_load_n(&g_site_count, __ATOMIC_ACQUIRE);
+}
+
+void lw_set_capture_level(int lvl)
+{
+    lvl = (lvl < LW_CAPTURE_OFF) ? LW_CAPTURE_OFF : ((lvl > LVL_TRACE) ? LVL_TRACE : lvl);
+    atomic_store_explicit(&lw_g_capture_lvl, lvl, memory_order_relaxed);
+}
+
+void lw_flight_dump(void)
+{
+    if (! __atomic_load_n(&g_flight_dirty, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+    pthread_mutex_lock(&g_flight_mutex);
+    __atomic_store_n(&g_flight_dirty, false, __ATOMIC_RELAXED);
+    for (flight_buffer_t* p_buf = g_p_flight_list; p_buf != NULL; p_buf = p_buf->p_next) {
+        pthread_mutex_lock(&p_buf->mutex);
+    }
+    // Merge the buffers by the timestamps of their oldest records.
+    for (;;) {
+        flight_buffer_t* p_oldest = NULL;
+        for (flight_buffer_t* p_buf = g_p_flight_list; p_buf != NULL; p_buf = p_buf->p_next) {
+            if (p_buf->count != 0
+                && (p_oldest == NULL || _flight_front(p_buf)->ts_ns < _flight_front(p_oldest)->ts_ns)) {
+                p_oldest = p_buf;
+            }
+        }
+        if (p_oldest == NULL) {
+            break;
+        }
+        const deferred_record_t* p_record = _flight_front(p_oldest);
+        _log_sync(p_record->logger, p_record->level, p_record->ts_ns,
+                  lw_log_site_get(p_record->site_id), p_record->args);
+        _flight_pop(p_oldest);
+    }
+    for (flight_buffer_t* p_buf = g_p_flight_list; p_buf != NULL; p_buf = p_buf->p_next) {
+        pthread_mutex_unlock(&p_buf->mutex);
+    }
+    pthread_mutex_unlock(&g_flight_mutex);
+}
+
+void lw_deferred_log(lw_loggerf_t logger, int level, const lw_log_site_t* p_site,
+                     const lw_arg_t* p_args)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    const uint64_t ts_ns = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    const uint32_t site_id = lw_log_site_id(p_site);
+    if (! lw_is_log_enabled(logger, level)) {
+        if (site_id != 0 && lw_is_capture_enabled(logger, level)) {
+            _flight_capture(logger, level, ts_ns, p_site, site_id, p_args);
+        }
+        return;
+    }
+    if (level <= LVL_ERROR) {
+        // The context of the error precedes it.
+        lw_flight_dump();
+    }
+    if (logger->p_logger != _lw_async_loggerf || site_id == 0) {
+        // A statement which is not interned is rendered in the calling thread.
+        _log_sync(logger, level, ts_ns, p_site, p_args);
+        return;
+    }
+
+    const unsigned int str_mask = __atomic_load_n(&p_site->str_mask, __ATOMIC_RELAXED);
+    size_t str_sizes[_LW_MAX_ARGS];
+    const size_t size = _record_size(p_site, p_args, str_mask, str_sizes);
+    deferred_record_t* p_record = (deferred_record_t*)_lw_async_alloc(size);
+    if (p_record == NULL) {
+        return;
+    }
+    _fill_record(p_record, logger, level, ts_ns, site_id, p_site, p_args, str_mask, str_sizes);
+    _lw_async_push(p_record, _render_record);
+}
+
+int lw_deferred_format(char* buf, size_t size, const lw_log_site_t* p_site,
+                       const lw_arg_t* p_args)
+{
+    output_t out = { buf, size, 0 };
+    _format_message(&out, p_site, p_args);
+    _terminate(&out);
+    return (out.len <= INT_MAX) ? (int)out.len : -1;
+}
@@ -0,0 +1,41 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Internal interface of the flight recorder of the deferred records.
+ *  \ingroup loggingf_wrapper_module
+ *
+ *  \details    Every thread which captures a record gets a circular buffer,
+ *      guarded by a mutex of its own, which is taken by the thread on every
+ *      capture and by a dump. The buffers are linked into a global list and
+ *      released when their threads exit. The flight recorder is implemented
+ *      by `deferred.c`, next to the records it stores.
+ */
+
+#ifndef _LIBS_LOGGINGF_WRAPPER_DETAILS_FLIGHT_H_
+#define _LIBS_LOGGINGF_WRAPPER_DETAILS_FLIGHT_H_
+
+/**
+ *  \brief  Disables the capture and empties the buffers of all threads.
+ *
+ *  \details    Called on deinitialization of the manager, as the captured
+ *      records refer to its loggers.
+ */
+void _lw_flight_release(void);
+
+#endif /* _LIBS_LOGGINGF_WRAPPER_DETAILS_FLIGHT_H_ */
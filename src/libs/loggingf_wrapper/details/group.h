@@ -0,0 +1,278 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Internal SIMD primitives of the channel hash tables.
+ *  \ingroup loggingf_wrapper_module
+ *
+ *  \details    The channel tables are SwissTable-like: slots are split into
+ *      groups of 16, and every slot has a control byte, which is either a
+ *      state (`EMPTY`, `BUSY`) or 7 bits of the hash of the stored channel. All
+ *      control bytes of a group are matched by one SSE2/NEON compare. A channel
+ *      key is its name padded with zeros to `LOG_CHANNEL_LEN` bytes, so two keys
+ *      are compared by one 16-byte vector compare for the default length.
+ *
+ *      Control bytes are written concurrently with lookups, so a group is
+ *      matched on a racy snapshot and every candidate is confirmed by an
+ *      acquire load of its control byte. Under sanitizers the snapshot is taken
+ *      by atomic loads of the scalar implementation.
+ */
+
+#ifndef _LIBS_LOGGINGF_WRAPPER_DETAILS_GROUP_H_
+#define _LIBS_LOGGINGF_WRAPPER_DETAILS_GROUP_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "loggingf_wrapper/manager.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
+#if defined(__SANITIZE_THREAD__) || defined(__SANITIZE_ADDRESS__)
+    #define _LW_SANITIZED
+#elif defined(__has_feature)
+    #if __has_feature(thread_sanitizer) || __has_feature(address_sanitizer)
+        #define _LW_SANITIZED
+    #endif
+#endif
+
+#if defined(__SSE2__) && ! defined(_LW_SANITIZED)
+    #define _LW_GROUP_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__) && ! defined(_LW_SANITIZED)
+    #define _LW_GROUP_NEON
+#else
+    #define _LW_GROUP_SCALAR
+#endif
+
+/** \brief  Number of slots in a group. */
+#define _LW_GROUP_SIZE  16
+
+/** \brief  Control byte of a free slot, which terminates a probe sequence. */
+#define _LW_CTRL_EMPTY  0x00
+/** \brief  Control byte of a slot claimed by a writer and not yet published. */
+#define _LW_CTRL_BUSY   0x01
+/** \brief  Control byte flag of a published slot, the low 7 bits hold the hash. */
+#define _LW_CTRL_FULL   0x80
+
+/**
+ *  \brief  Bit mask of the slots of a group.
+ *
+ *  \details    Every slot is represented by one bit, which is bit `i` for SSE2
+ *      and the scalar implementation and bit `4 * i + 3` for NEON.
+ */
+typedef uint64_t    _lw_group_mask_t;
+
+#if defined(_LW_GROUP_SSE2)
+    typedef __m128i         _lw_group_t;
+    #define _LW_MASK_SHIFT  0
+#elif defined(_LW_GROUP_NEON)
+    typedef uint8x16_t      _lw_group_t;
+    #define _LW_MASK_SHIFT  2
+#else
+    /** \brief  Snapshot of the control bytes of a group. */
+    typedef struct { unsigned char ctrl[_LW_GROUP_SIZE]; } _lw_group_t;
+    #define _LW_MASK_SHIFT  0
+#endif
+
+/**
+ *  \brief  Takes a snapshot of the control bytes of a group.
+ *  \param  p_ctrl - first control byte of the group (16-byte aligned).
+ */
+static inline _lw_group_t _lw_group_load(const atomic_uchar* p_ctrl)
+{
+#if defined(_LW_GROUP_SSE2)
+    return _mm_load_si128((const __m128i*)(const void*)p_ctrl);
+#elif defined(_LW_GROUP_NEON)
+    return vld1q_u8((const uint8_t*)(const void*)p_ctrl);
+#else
+    _lw_group_t group;
+    for (int i = 0; i < _LW_GROUP_SIZE; ++i) {
+        group.ctrl[i] = atomic_load_explicit(&p_ctrl[i], memory_order_relaxed);
+    }
+    return group;
+#endif
+}
+
+/**
+ *  \brief  Returns the mask of the slots of a group with the control byte.
+ *  \param  group - snapshot of the group.
+ *  \param  ctrl - control byte to match.
+ */
+static inline _lw_group_mask_t _lw_group_match(_lw_group_t group, unsigned char ctrl)
+{
+#if defined(_LW_GROUP_SSE2)
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)ctrl)));
+#elif defined(_LW_GROUP_NEON)
+    const uint8x16_t eq = vceqq_u8(group, vdupq_n_u8(ctrl));
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ull;
+#else
+    _lw_group_mask_t mask = 0;
+    for (int i = 0; i < _LW_GROUP_SIZE; ++i) {
+        mask |= (_lw_group_mask_t)(group.ctrl[i] == ctrl) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ *  \brief  Returns the index in the group of the first slot of a non-empty mask.
+ */
+static inline size_t _lw_mask_first(_lw_group_mask_t mask)
+{
+    return (size_t)__builtin_ctzll(mask) >> _LW_MASK_SHIFT;
+}
+
+/**
+ *  \brief  Returns the mask without its first slot.
+ */
+static inline _lw_group_mask_t _lw_mask_next(_lw_group_mask_t mask)
+{
+    return mask & (mask - 1);
+}
+
+/**
+ *  \brief  Builds the key of a channel.
+ *  \param  p_key - buffer of `LOG_CHANNEL_LEN` bytes.
+ *  \param  channel - channel name, truncated to `LOG_CHANNEL_LEN - 1` characters.
+ *
+ *  \details    For the default length the name is read by one 16-byte load
+ *      if it does not cross a page boundary (like vectorized `strlen` does),
+ *      and the bytes from its terminator on are cleared by a vector mask.
+ */
+static inline void _lw_make_key(char* p_key, const char* channel)
+{
+#if (LOG_CHANNEL_LEN == 16) && (defined(_LW_GROUP_SSE2) || defined(_LW_GROUP_NEON))
+    if (((uintptr_t)channel & 4095) <= 4096 - 16) {
+    #if defined(_LW_GROUP_SSE2)
+        const __m128i bytes = _mm_loadu_si128((const __m128i*)(const void*)channel);
+        const unsigned zeros = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_setzero_si128())) | 0x8000u;
+        const __m128i index = _mm_set_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        const __m128i keep = _mm_cmplt_epi8(index, _mm_set1_epi8((char)__builtin_ctz(zeros)));
+        _mm_storeu_si128((__m128i*)(void*)p_key, _mm_and_si128(bytes, keep));
+    #else
+        static const uint8_t index_bytes[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+        const uint8x16_t bytes = vld1q_u8((const uint8_t*)channel);
+        const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(vceqzq_u8(bytes)), 4);
+        const uint64_t zeros = vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) | 0xF000000000000000ull;
+        const uint8x16_t keep = vcltq_u8(vld1q_u8(index_bytes), vdupq_n_u8((uint8_t)(__builtin_ctzll(zeros) >> 2)));
+        vst1q_u8((uint8_t*)p_key, vandq_u8(bytes, keep));
+    #endif
+        return;
+    }
+#endif
+    memset(p_key, 0, LOG_CHANNEL_LEN);
+    for (size_t i = 0; i < (LOG_CHANNEL_LEN - 1) && channel[i] != '\0'; ++i) {
+        p_key[i] = channel[i];
+    }
+}
+
+/**
+ *  \brief  Compares two channel keys.
+ *  \param  p_lhs, p_rhs - names padded with zeros to `LOG_CHANNEL_LEN` bytes.
+ */
+static inline bool _lw_key_equal(const char* p_lhs, const char* p_rhs)
+{
+#if (LOG_CHANNEL_LEN == 16) && defined(__SSE2__)
+    const __m128i lhs = _mm_loadu_si128((const __m128i*)(const void*)p_lhs);
+    const __m128i rhs = _mm_loadu_si128((const __m128i*)(const void*)p_rhs);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(lhs, rhs)) == 0xFFFF;
+#elif (LOG_CHANNEL_LEN == 16) && defined(__ARM_NEON) && defined(__aarch64__)
+    const uint8x16_t eq = vceqq_u8(vld1q_u8((const uint8_t*)p_lhs), vld1q_u8((const uint8_t*)p_rhs));
+    return vminvq_u8(eq) == 0xFF;
+#else
+    return memcmp(p_lhs, p_rhs, LOG_CHANNEL_LEN) == 0;
+#endif
+}
+
+/**
+ *  \brief  Folded 64x64->128 bit multiplication.
+ */
+static inline uint64_t _lw_mix(uint64_t lhs, uint64_t rhs)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 u128_t;
+    const u128_t r = (u128_t)lhs * rhs;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    const uint64_t r = lhs * rhs;
+    return r ^ (r >> 32);
+#endif
+}
+
+/**
+ *  \brief  Hash of a channel key.
+ *  \param  p_key - name padded with zeros to `LOG_CHANNEL_LEN` bytes.
+ *
+ *  \details    The key is consumed by 8-byte words, each of which is mixed
+ *      into the state by a folded multiplication (as in wyhash), so the hash
+ *      of the default 16-byte key costs three multiplications. The low 7 bits
+ *      go to the control byte, the rest selects the first group.
+ *
+ *  \todo   If channel names can contain user-controlled input, consider a
+ *      seeded or keyed hash (e.g. SipHash) to prevent Hash DoS attacks.
+ */
+static inline uint64_t _lw_key_hash(const char* p_key)
+{
+    uint64_t h = 0x9E3779B97F4A7C15ull;
+    size_t i = 0;
+    for (; i + 8 <= LOG_CHANNEL_LEN; i += 8) {
+        uint64_t word;
+        memcpy(&word, p_key + i, 8);
+        h = _lw_mix(h ^ word, 0xBF58476D1CE4E5B9ull);
+    }
+#if (LOG_CHANNEL_LEN % 8) != 0
+    uint64_t word = 0;
+    memcpy(&word, p_key + i, LOG_CHANNEL_LEN % 8);
+    h = _lw_mix(h ^ word, 0xBF58476D1CE4E5B9ull);
+#endif
+    return _lw_mix(h, 0x94D049BB133111EBull);
+}
+
+/**
+ *  \brief  Hash of a channel name of any length.
+ *  \param  p_name - channel name.
+ *  \param  len - length of the name.
+ *
+ *  \details    Mixes the name by 8-byte words like \ref _lw_key_hash, with
+ *      the length folded into the seed.
+ */
+static inline uint64_t _lw_name_hash(const char* p_name, size_t len)
+{
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)len;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, p_name + i, 8);
+        h = _lw_mix(h ^ word, 0xBF58476D1CE4E5B9ull);
+    }
+    if (i < len) {
+        uint64_t word = 0;
+        memcpy(&word, p_name + i, len - i);
+        h = _lw_mix(h ^ word, 0xBF58476D1CE4E5B9ull);
+    }
+    return _lw_mix(h, 0x94D049BB133111EBull);
+}
+
+#endif /* _LIBS_LOGGINGF_WRAPPER_DETAILS_GROUP_H_ */
@@ -23,12 +23,20 @@
 #include <sys/time.h>
 #include <assert.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
+#include "loggingf_wrapper/details/arena.h"
+#include "loggingf_wrapper/details/async.h"
+#include "loggingf_wrapper/details/burst.h"
+#include "loggingf_wrapper/details/flight.h"
+#include "loggingf_wrapper/details/group.h"
 #include "loggingf_wrapper/manager.h"
+#include "loggingf_wrapper/manifest.h"
 
 /**
  *  \def    _TS_FILL_DFL(ts_buf, buf_size)
@@ -40,6 +48,12 @@
 #define _TS_FILL_DFL(ts_buf, buf_size)                               \
     memcpy(ts_buf, "yyyy-MM-dd hh:mm:ss.mil", (buf_size < 24) ? buf_size : 24)
 
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+
+lw_atomic_level_t lw_g_global_lvl = -1;
+
 /*******************************************************************************
  * Private functions & Data Structures
  ******************************************************************************/
@@ -47,6 +61,14 @@
 struct _lw_hash_node;
 /** \brief  Alias for the internal hash table node structure. */
 typedef struct _lw_hash_node    hash_node_t;
+struct _lw_slot_array;
+/** \brief  Alias for the internal slot array structure. */
+typedef struct _lw_slot_array   slot_array_t;
+struct _lw_epoch_rec;
+/** \brief  Alias for the internal per-thread epoch record structure. */
+typedef struct _lw_epoch_rec    epoch_rec_t;
+/** \brief  Alias for the channel token structure. */
+typedef struct lw_channel_token channel_token_t;
 /** \brief  Internal alias for the logger structure. */
 typedef struct lw_loggerf       _lw_loggerf_t;
 /** \brief  Prototype of the internal function to retrieve a logger. */
@@ -54,12 +76,68 @@ typedef _lw_loggerf_t*	(*get_logger_fn_t)(const char*);
 
 /**
  *  \brief  Hash table node containing a channel logger instance.
+ *
+ *  \details    The channel name is padded with zeros up to `LOG_CHANNEL_LEN`
+ *      bytes and serves as the key of the node, the name of the logger points
+ *      to the key. Longer names are kept by their tokens. Nodes of
+ *      the fixed_size policy are stored in the slots of the table, nodes of
+ *      the dynamic_size policy are allocated from the node arena and are
+ *      referenced by the slots. In both cases a node is never moved or freed
+ *      until `lw_deinit_logging`.
  */
 struct _lw_hash_node
 {
-    hash_node_t* p_next;  /**< Pointer to the next node in case of a collision. */
     _lw_loggerf_t logger; /**< Logger structure (channel, level, output function). */
-    int channel_length;   /**< Real length of the channel name (comparison optimization). */
+    uint64_t hash;        /**< Hash of the channel key (avoids rehashing on resize). */
+    char key[LOG_CHANNEL_LEN]; /**< Channel name padded with zeros. */
+};
+
+/**
+ *  \brief  Interned channel name.
+ *
+ *  \details    Tokens are allocated from the intern arena, chained into the
+ *      buckets of the intern table under `intern_mutex` and never moved or
+ *      freed until `lw_deinit_logging`. A name shorter than `LOG_CHANNEL_LEN`
+ *      refers to the logger of the channel table, a longer one owns its logger,
+ *      because its key would be truncated.
+ */
+struct lw_channel_token
+{
+    _lw_loggerf_t* p_logger;  /**< Logger of the channel. */
+    channel_token_t* p_next;  /**< Next token of the bucket. */
+    uint64_t hash;            /**< Hash of the full name. */
+    size_t len;               /**< Length of the name. */
+    _lw_loggerf_t logger;     /**< Own logger of a long name. */
+    char name[];              /**< Null-terminated name. */
+};
+
+/**
+ *  \brief  Array of slots of the hash table (dynamic_size policy).
+ *
+ *  \details    A slot is written only under `write_mutex`: first its node
+ *      pointer, then its control byte by a release store.
+ */
+struct _lw_slot_array
+{
+    size_t group_mask;               /**< Number of groups minus one (the number of groups is a power of two). */
+    atomic_uchar* p_ctrl;            /**< Control bytes of the slots (16-byte aligned). */
+    _Atomic(hash_node_t*)* p_slots;  /**< Nodes of the slots. */
+    slot_array_t* p_next_retired;    /**< Next array of the list of retired arrays. */
+    size_t retired_epoch;            /**< Epoch of the retirement of the array. */
+};
+
+/**
+ *  \brief  Per-thread record of the epoch-based reclamation of slot arrays.
+ *
+ *  \details    Records are allocated once per thread, kept in a global
+ *      lock-free list for the lifetime of the process and reused by new
+ *      threads after their owner exits.
+ */
+struct _lw_epoch_rec
+{
+    _Alignas(64) atomic_size_t epoch; /**< Global epoch observed on entering a read section, 0 outside of it. */
+    atomic_int in_use;                /**< Flag of the record being owned by a thread. */
+    epoch_rec_t* p_next;              /**< Next record of the global list (immutable after publication). */
 };
 
 /**
@@ -67,16 +145,29 @@ struct _lw_hash_node
  */
 struct _lw_loggingf_manager
 {
-    volatile sig_atomic_t global_lvl;   /**< Global logging level. */
-    volatile sig_atomic_t is_immutable; /**< Flag preventing changes to the global level. */
-    pthread_rwlock_t bucket_mutex;      /**< Read-write lock protecting hash table modifications and resizing. */
-    hash_node_t** p_bucket;             /**< Array of hash table buckets. */
+    atomic_int is_immutable;            /**< Flag preventing changes to the global level. */
+    pthread_mutex_t write_mutex;        /**< Mutex serializing channel creation and resizing (dynamic_size policy). */
+    _Atomic(slot_array_t*) p_table;     /**< Current slot array, new channels are inserted here. */
+    _Atomic(slot_array_t*) p_old_table; /**< Slot array being migrated into the current one, or NULL. */
+    size_t migrate_pos;                 /**< Index of the next group of the old array to migrate. */
+    slot_array_t* p_retired;            /**< List of migrated slot arrays waiting for reclamation. */
+    _lw_arena_t node_arena;             /**< Arena of the hash table nodes (dynamic_size policy). */
     size_t size;                        /**< Current number of registered channels. */
-    size_t capacity;                    /**< Current hash table capacity (number of buckets). */
-    hash_node_t* p_pool;                /**< Static pool of nodes (used with fixed_size policy). */
+    size_t capacity;                    /**< Channel limit of the fixed_size policy, or the initial number of slots. */
+    atomic_uchar* p_ctrl;               /**< Control bytes of the preallocated table (fixed_size policy). */
+    hash_node_t* p_slots;               /**< Nodes of the preallocated table (fixed_size policy). */
+    size_t group_mask;                  /**< Number of groups of the preallocated table minus one. */
+    atomic_size_t slot_size;            /**< Number of claimed slots (fixed_size policy). */
     _lw_loggerf_t* p_root_logger;       /**< Pointer to the root logger. */
     lw_loggerf_fn_t logger_fn;          /**< Function for log output. */
     get_logger_fn_t get_logger_fn;      /**< Pointer to the channel search/creation function being used. */
+    pthread_mutex_t intern_mutex;       /**< Mutex of the intern table (taken before `write_mutex`, never after). */
+    channel_token_t** p_buckets;        /**< Buckets of the intern table, or NULL until the first token. */
+    size_t bucket_mask;                 /**< Number of buckets minus one (a power of two). */
+    size_t token_count;                 /**< Number of interned names. */
+    _lw_arena_t intern_arena;           /**< Arena of the tokens. */
+    _Atomic(const lw_channel_manifest_t*) p_manifest; /**< Registered channel manifest, or NULL. */
+    channel_token_t** p_manifest_tokens; /**< Tokens of the manifest channels by id (immutable after publication). */
 };
 
 typedef struct _lw_loggingf_manager loggingf_manager_t;
@@ -84,262 +175,885 @@ typedef struct _lw_loggingf_manager loggingf_manager_t;
 /** \brief  Global pointer to the single instance of the logging manager. */
 static loggingf_manager_t* g_p_manager = NULL;
 
+/** \brief  Number of old groups migrated by one insertion or lookup during a resize. */
+#define _MIGRATE_STEP   4
+
+/** \brief  Global epoch of the reclamation of slot arrays (starts at 1, 0 marks inactive records). */
+static atomic_size_t g_epoch = 1;
+/** \brief  Global list of per-thread epoch records. */
+static _Atomic(epoch_rec_t*) g_p_epoch_recs = NULL;
+/** \brief  Guard of the creation of `g_epoch_key`. */
+static pthread_once_t g_epoch_once = PTHREAD_ONCE_INIT;
+/** \brief  Key releasing the epoch record of an exiting thread. */
+static pthread_key_t g_epoch_key;
+/** \brief  Epoch record of the current thread. */
+static _Thread_local epoch_rec_t* tl_p_epoch_rec = NULL;
+
+/** \brief  Binary logarithm of the number of entries of the per-thread lookup cache. */
+#define _LOOKUP_CACHE_BITS  6
+
 /**
- *  \details    The Dan Bernstein popuralized hash..  See
- *  https://github.com/pjps/ndjbdns/blob/master/cdb_hash.c#L26 Due to hash
- *  collisions it seems to be replaced with "siphash" in n-djbdns, see
+ *  \brief  Entry of the per-thread lookup cache.
  *
+ *  \details    The entry is keyed by the address of the channel name passed
+ *      to `lw_get_logger`, which is usually a string literal of the call site.
+ *      It is valid only for the generation of the manager it was filled in.
  */
+struct _lw_cache_entry
+{
+    const char* channel;     /**< Channel name as passed by the caller. */
+    _lw_loggerf_t* p_logger; /**< Logger of the channel. */
+    const channel_token_t* p_token; /**< Token of a long name, or NULL. */
+    size_t generation;       /**< Generation of the manager (0 marks an empty entry). */
+};
+/** \brief  Alias for the internal lookup cache entry structure. */
+typedef struct _lw_cache_entry  cache_entry_t;
+
+/** \brief  Generation of the manager, incremented by `lw_deinit_logging`. */
+static atomic_size_t g_generation = 1;
+/** \brief  Direct-mapped lookup cache of the current thread. */
+static _Thread_local cache_entry_t tl_lookup_cache[1 << _LOOKUP_CACHE_BITS];
+
 /**
- *  \brief  DJB2 hash function (Dan Bernstein).
- *  \param  p_key - the key string (channel name).
- *  \param  length - length of the key string.
- *  \return The calculated hash value of type size_t.
+ *  \brief  Returns the control byte of a published slot with the hash.
+ */
+static inline unsigned char _ctrl_of(uint64_t hash)
+{
+    return (unsigned char)(_LW_CTRL_FULL | (hash & 0x7F));
+}
+
+/**
+ *  \brief  Returns the first group of the probe sequence of the hash.
  *
- *  \details    Used to distribute channel names across the hash table buckets.
+ *  \details    Groups are probed quadratically (by triangular numbers), which
+ *      visits every group for a power-of-two number of groups.
+ */
+static inline size_t _first_group(uint64_t hash, size_t group_mask)
+{
+    return (size_t)(hash >> 7) & group_mask;
+}
+
+/**
+ *  \brief  Returns the effective level of a channel with the levels.
  *
- *  \see    https://github.com/pjps/ndjbdns/blob/master/cdb_hash.c#L26
- *  \todo   If channel names can contain user-controlled input, consider
- *      replacing this with SipHash to prevent Hash DoS attacks
- *      (https://github.com/pjps/ndjbdns/commit/16cb625eccbd68045737729792f09b4945a4b508).
+ *  \details    A burst lets the channel write past the global level as well.
  */
-static size_t _hash_fn(const char* p_key, size_t length)
+static inline int _eff_level_of(int global_lvl, int channel_lvl, int burst_lvl)
 {
-    size_t h = 5381;
-    while (length--) {
-        /* h = 33 * h ^ s[i]; */
-        h += (h << 5);
-        h ^= *p_key++;
-    }
-    return h;
+    const int lvl = (global_lvl < channel_lvl) ? global_lvl : channel_lvl;
+    return (lvl < burst_lvl) ? burst_lvl : lvl;
 }
 
 /**
- *  \brief  Retrieves an existing logger channel or dynamically creates a new one.
- *  \param  channel - the name of the requested channel.
- *  \return Pointer to the internal logger structure, or NULL upon memory
- *      allocation error.
+ *  \brief  Recomputes the effective level of a logger.
  *
- *  \details    If the capacity limit is reached (`size >= capacity`), it
- *      automatically doubles the size of the hash table and performs a rehash.
+ *  \details    Called after every change of the global, the channel or the
+ *      burst level and after the publication of a new channel. The changes, the
+ *      publication and the loads below are sequentially consistent, so a
+ *      concurrent writer of the other level either is seen here or sees this
+ *      logger and recomputes its level itself. The result is validated by
+ *      reloading the levels, so the store of a preempted writer that loaded
+ *      stale levels is never the last one.
  */
-static _lw_loggerf_t* _get_logger_dynamic_size(const char* channel)
+static void _update_eff_level(_lw_loggerf_t* p_logger)
 {
-    assert(g_p_manager != NULL && "Logging manager is not initialized");
+    int global_lvl;
+    int channel_lvl;
+    int burst_lvl;
+    do {
+        global_lvl = atomic_load(&lw_g_global_lvl);
+        channel_lvl = atomic_load(&p_logger->level);
+        burst_lvl = atomic_load(&p_logger->burst_level);
+        atomic_store(&p_logger->eff_level, _eff_level_of(global_lvl, channel_lvl, burst_lvl));
+    } while (global_lvl != atomic_load(&lw_g_global_lvl) || channel_lvl != atomic_load(&p_logger->level)
+             || burst_lvl != atomic_load(&p_logger->burst_level));
+}
 
-    int length = strlen(channel);
-    if (length > (LOG_CHANNEL_LEN - 1)) {
-        length = LOG_CHANNEL_LEN - 1;
+/**
+ *  \brief  Initializes the levels of a new logger before its publication.
+ */
+static inline void _init_levels(_lw_loggerf_t* p_logger)
+{
+    // It is assumed that the level is initialized to default (hardcoded as debug in the code)
+    atomic_store_explicit(&p_logger->level, debug, memory_order_relaxed);
+    atomic_store_explicit(&p_logger->burst_level, -1, memory_order_relaxed);
+    atomic_store_explicit(&p_logger->eff_level,
+                          _eff_level_of(atomic_load_explicit(&lw_g_global_lvl, memory_order_relaxed), debug, -1),
+                          memory_order_relaxed);
+}
+
+/**
+ *  \brief  Releases the epoch record of an exiting thread.
+ *  \param  p_rec - epoch record of the thread.
+ */
+static void _epoch_rec_release(void* p_rec)
+{
+    atomic_store(&((epoch_rec_t*)p_rec)->epoch, 0);
+    atomic_store(&((epoch_rec_t*)p_rec)->in_use, 0);
+}
+
+/** \brief  Creates the key releasing epoch records of exiting threads. */
+static void _epoch_key_create(void)
+{
+    pthread_key_create(&g_epoch_key, _epoch_rec_release);
+}
+
+/**
+ *  \brief  Returns the epoch record of the current thread.
+ *  \return Pointer to the record, or NULL upon memory allocation error.
+ *
+ *  \details    A free record of an exited thread is reused, otherwise a new
+ *      one is allocated and pushed to the global list.
+ */
+static epoch_rec_t* _epoch_rec(void)
+{
+    if (tl_p_epoch_rec != NULL) {
+        return tl_p_epoch_rec;
     }
-    size_t hash = _hash_fn(channel, length);
 
-    // Fast Read (Multiple threads simultaneously)
-    pthread_rwlock_rdlock(&g_p_manager->bucket_mutex);
-    int i = hash % g_p_manager->capacity;
+    pthread_once(&g_epoch_once, _epoch_key_create);
 
-    hash_node_t** p_node;
-    for (p_node = &g_p_manager->p_bucket[i]; *p_node != NULL; p_node = &(*p_node)->p_next) {
-        if ((*p_node)->channel_length == length && memcmp((*p_node)->logger.channel, channel, length) == 0) {
-            //return &(*p_node)->logger;
-            _lw_loggerf_t* p_logger = &(*p_node)->logger;
-            pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
-            return p_logger;
+    epoch_rec_t* p_rec;
+    for (p_rec = atomic_load(&g_p_epoch_recs); p_rec != NULL; p_rec = p_rec->p_next) {
+        int in_use = 0;
+        if (atomic_compare_exchange_strong(&p_rec->in_use, &in_use, 1)) {
+            break;
+        }
+    }
+    if (p_rec == NULL) {
+        p_rec = (epoch_rec_t*)aligned_alloc(_Alignof(epoch_rec_t), sizeof(epoch_rec_t));
+        if (p_rec == NULL) {
+            return NULL;
         }
+        atomic_init(&p_rec->epoch, 0);
+        atomic_init(&p_rec->in_use, 1);
+        p_rec->p_next = atomic_load(&g_p_epoch_recs);
+        while (! atomic_compare_exchange_weak(&g_p_epoch_recs, &p_rec->p_next, p_rec)) {}
     }
 
-    pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
+    pthread_setspecific(g_epoch_key, p_rec);
+    tl_p_epoch_rec = p_rec;
+    return p_rec;
+}
 
-    // Exclusive Write (Only one thread)
-    pthread_rwlock_wrlock(&g_p_manager->bucket_mutex);
-    // Double-check. While we were waiting for the wrlock, another thread might
-    // have already created this channel.
-    i = hash % g_p_manager->capacity;
-    for (p_node = &g_p_manager->p_bucket[i]; *p_node != NULL; p_node = &(*p_node)->p_next) {
-        if ((*p_node)->channel_length == length && memcmp((*p_node)->logger.channel, channel, length) == 0) {
-            _lw_loggerf_t* p_logger = &(*p_node)->logger;
-            pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
-            return p_logger;
+/**
+ *  \brief  Frees the retired slot arrays which are not accessible anymore.
+ *
+ *  \details    An array is freed if no thread is in a read section entered
+ *      before its retirement. Must be called under `write_mutex`.
+ */
+static void _try_reclaim(void)
+{
+    if (g_p_manager->p_retired == NULL) {
+        return;
+    }
+    size_t min_epoch = SIZE_MAX;
+    for (epoch_rec_t* p_rec = atomic_load(&g_p_epoch_recs); p_rec != NULL; p_rec = p_rec->p_next) {
+        const size_t epoch = atomic_load(&p_rec->epoch);
+        if (epoch != 0 && epoch < min_epoch) {
+            min_epoch = epoch;
+        }
+    }
+    for (slot_array_t** p_table = &g_p_manager->p_retired; *p_table != NULL;) {
+        if ((*p_table)->retired_epoch <= min_epoch) {
+            slot_array_t* p_free = *p_table;
+            *p_table = p_free->p_next_retired;
+            free(p_free);
+        } else {
+            p_table = &(*p_table)->p_next_retired;
         }
     }
+}
+
+/**
+ *  \brief  Allocates an empty slot array.
+ *  \param  capacity - number of slots (a power of two, at least one group).
+ *  \return Pointer to the array, or NULL upon memory allocation error.
+ */
+static slot_array_t* _slot_array_create(size_t capacity)
+{
+    // The header, the control bytes and the slots share one block. Zeroed
+    // memory is a valid array of empty slots, and large arrays are mapped
+    // lazily by calloc, so the cost of their clearing is not paid at once.
+    const size_t ctrl_offset = (sizeof(slot_array_t) + _LW_GROUP_SIZE - 1) & ~(size_t)(_LW_GROUP_SIZE - 1);
+    char* p_block = (char*)calloc(1, ctrl_offset + capacity * (1 + sizeof(hash_node_t*)));
+    if (p_block == NULL) {
+        return NULL;
+    }
+    assert(((uintptr_t)p_block % _LW_GROUP_SIZE) == 0 && "Control bytes must be aligned");
 
-    // Hash table resizing and rehashing
-    if (g_p_manager->size >= g_p_manager->capacity) {
-        size_t capacity = g_p_manager->capacity * 2;
-        hash_node_t** p_bucket = (hash_node_t**)malloc(capacity * sizeof(hash_node_t*));
-        if (p_bucket == NULL) {
-            pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
+    slot_array_t* p_table = (slot_array_t*)p_block;
+    p_table->group_mask = capacity / _LW_GROUP_SIZE - 1;
+    p_table->p_ctrl = (atomic_uchar*)(p_block + ctrl_offset);
+    p_table->p_slots = (_Atomic(hash_node_t*)*)(p_block + ctrl_offset + capacity);
+    return p_table;
+}
+
+/**
+ *  \brief  Searches for a channel in the slot array.
+ *  \return Pointer to the node, or NULL if the channel is not found.
+ */
+static hash_node_t* _find_node(slot_array_t* p_table, uint64_t hash, const char* p_key)
+{
+    const unsigned char ctrl = _ctrl_of(hash);
+    size_t g = _first_group(hash, p_table->group_mask);
+    for (size_t step = 1; step <= p_table->group_mask + 1; ++step) {
+        atomic_uchar* p_group_ctrl = &p_table->p_ctrl[g * _LW_GROUP_SIZE];
+        const _lw_group_t group = _lw_group_load(p_group_ctrl);
+        for (_lw_group_mask_t m = _lw_group_match(group, ctrl); m != 0; m = _lw_mask_next(m)) {
+            const size_t i = _lw_mask_first(m);
+            if (atomic_load_explicit(&p_group_ctrl[i], memory_order_acquire) != ctrl) {
+                continue;
+            }
+            hash_node_t* p_node = atomic_load_explicit(&p_table->p_slots[g * _LW_GROUP_SIZE + i], memory_order_relaxed);
+            if (p_node->hash == hash && _lw_key_equal(p_node->key, p_key)) {
+                return p_node;
+            }
+        }
+        if (_lw_group_match(group, _LW_CTRL_EMPTY) != 0) {
             return NULL;
         }
-        for (size_t i = 0; i < capacity; ++i) {
-            p_bucket[i] = NULL;
+        g = (g + step) & p_table->group_mask;
+    }
+    return NULL;
+}
+
+/**
+ *  \brief  Publishes the node in the first empty slot of its probe sequence.
+ *
+ *  \details    The node pointer is written before the release store of the
+ *      control byte, so concurrent readers never see a half-filled slot. The
+ *      array always has empty slots (the load factor does not exceed 7/8).
+ *      Must be called under `write_mutex`.
+ */
+static void _link_node(slot_array_t* p_table, hash_node_t* p_node)
+{
+    size_t g = _first_group(p_node->hash, p_table->group_mask);
+    for (size_t step = 1; ; ++step) {
+        atomic_uchar* p_group_ctrl = &p_table->p_ctrl[g * _LW_GROUP_SIZE];
+        const _lw_group_mask_t empty = _lw_group_match(_lw_group_load(p_group_ctrl), _LW_CTRL_EMPTY);
+        if (empty != 0) {
+            const size_t i = _lw_mask_first(empty);
+            atomic_store_explicit(&p_table->p_slots[g * _LW_GROUP_SIZE + i], p_node, memory_order_relaxed);
+            atomic_store_explicit(&p_group_ctrl[i], _ctrl_of(p_node->hash), memory_order_release);
+            return;
         }
-        for (size_t i = 0; i < g_p_manager->capacity; ++i) {
-            if (g_p_manager->p_bucket[i] == NULL) {
-                continue;
-            }
-            for (hash_node_t* p_old_node = g_p_manager->p_bucket[i]; p_old_node != NULL;) {
-                hash = _hash_fn(p_old_node->logger.channel, p_old_node->channel_length);
-                p_node = &p_bucket[hash % capacity];
-                while (*p_node != NULL) {
-                    p_node = &(*p_node)->p_next;
-                }
-                *p_node = p_old_node;
-                p_old_node = p_old_node->p_next;
-                (*p_node)->p_next = NULL;
+        g = (g + step) & p_table->group_mask;
+    }
+}
+
+/**
+ *  \brief  Migrates up to `count` groups of the old array into the current one.
+ *
+ *  \details    The old array is left intact, because slots refer to stable
+ *      nodes. When the last group is migrated, the old array is unpublished
+ *      and retired. Must be called under `write_mutex`.
+ */
+static void _migrate_groups(size_t count)
+{
+    slot_array_t* p_old = atomic_load_explicit(&g_p_manager->p_old_table, memory_order_relaxed);
+    if (p_old == NULL) {
+        return;
+    }
+    slot_array_t* p_table = atomic_load_explicit(&g_p_manager->p_table, memory_order_relaxed);
+
+    for (; count > 0 && g_p_manager->migrate_pos <= p_old->group_mask; --count, ++g_p_manager->migrate_pos) {
+        const size_t first = g_p_manager->migrate_pos * _LW_GROUP_SIZE;
+        for (size_t i = first; i < first + _LW_GROUP_SIZE; ++i) {
+            if (atomic_load_explicit(&p_old->p_ctrl[i], memory_order_relaxed) != _LW_CTRL_EMPTY) {
+                _link_node(p_table, atomic_load_explicit(&p_old->p_slots[i], memory_order_relaxed));
             }
         }
-        g_p_manager->capacity = capacity;
-        free(g_p_manager->p_bucket);
-        g_p_manager->p_bucket = p_bucket;
-        // Recursive call to insert into the already expanded table
-        pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
-        return _get_logger_dynamic_size(channel);
-
-        // Recalculate the bucket index for the current insertion using the new capacity
-        //i = hash % g_p_manager->capacity;
-        //p_node = &g_p_manager->p_bucket[i];
-        //while (*p_node != NULL) {
-        //    p_node = &(*p_node)->p_next;
-        //}
-    }
-
-    // Allocation of memory for a new node
-    *p_node = (hash_node_t*)malloc(sizeof(hash_node_t));
-    if (*p_node == NULL) {
-        pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
+    }
+
+    if (g_p_manager->migrate_pos > p_old->group_mask) {
+        atomic_store(&g_p_manager->p_old_table, NULL);
+        p_old->retired_epoch = atomic_fetch_add(&g_epoch, 1) + 1;
+        p_old->p_next_retired = g_p_manager->p_retired;
+        g_p_manager->p_retired = p_old;
+        _try_reclaim();
+    }
+}
+
+/**
+ *  \brief  Creates a new channel (slow path of the dynamic_size policy).
+ *  \return Pointer to the logger, or NULL upon memory allocation error.
+ *
+ *  \details    Called under `write_mutex`. If the load factor would exceed
+ *      7/8 and the previous resize is complete, a slot array of double
+ *      capacity is published, and the groups of the current one are migrated
+ *      into it incrementally by subsequent insertions and lookups.
+ */
+static _lw_loggerf_t* _insert_dynamic_size(const char* p_key, uint64_t hash)
+{
+    slot_array_t* p_table = atomic_load_explicit(&g_p_manager->p_table, memory_order_relaxed);
+    slot_array_t* p_old = atomic_load_explicit(&g_p_manager->p_old_table, memory_order_relaxed);
+
+    // Double-check. Another thread might have already created this channel,
+    // or the lock-free lookup might have missed it during a resize.
+    hash_node_t* p_node = _find_node(p_table, hash, p_key);
+    if (p_node == NULL && p_old != NULL) {
+        p_node = _find_node(p_old, hash, p_key);
+    }
+    if (p_node != NULL) {
+        return &p_node->logger;
+    }
+
+    size_t capacity = (p_table->group_mask + 1) * _LW_GROUP_SIZE;
+    _try_reclaim();
+    if (p_old == NULL && g_p_manager->size + 1 > capacity - capacity / 8) {
+        // During a resize the new array is at most half full, and the
+        // migration completes long before it reaches the load limit.
+        slot_array_t* p_new = _slot_array_create(2 * capacity);
+        if (p_new != NULL) {
+            g_p_manager->migrate_pos = 0;
+            atomic_store(&g_p_manager->p_old_table, p_table);
+            atomic_store(&g_p_manager->p_table, p_new);
+            p_table = p_new;
+            capacity *= 2;
+        }
+    }
+    _migrate_groups(_MIGRATE_STEP);
+    if (g_p_manager->size + 1 >= capacity) {
+        // Keep at least one empty slot, which terminates probe sequences.
+        return NULL;
+    }
+
+    // Allocation of memory for a new node. Nodes are packed into large
+    // chunks and released all at once by `lw_deinit_logging`.
+    p_node = (hash_node_t*)_lw_arena_alloc(&g_p_manager->node_arena, sizeof(hash_node_t), _Alignof(hash_node_t));
+    if (p_node == NULL) {
         return NULL;
     }
-    (*p_node)->p_next = NULL;
+    p_node->logger.p_logger = g_p_manager->logger_fn;
+    _init_levels(&p_node->logger);
+    memcpy(p_node->key, p_key, LOG_CHANNEL_LEN);
+    p_node->logger.channel = p_node->key;
+    p_node->hash = hash;
+    _link_node(p_table, p_node);
+    _update_eff_level(&p_node->logger);
     ++g_p_manager->size;
 
-    (*p_node)->logger.p_logger = g_p_manager->logger_fn;
-    // It is assumed that the level is initialized to default (hardcoded as debug in the code)
-    (*p_node)->logger.level = debug;
-    memcpy((*p_node)->logger.channel, channel, length);
-    (*p_node)->logger.channel[length] = '\0';
-    (*p_node)->channel_length = length;
+    return &p_node->logger;
+}
+
+/**
+ *  \brief  Retrieves an existing logger channel or dynamically creates a new one.
+ *  \param  channel - the name of the requested channel.
+ *  \return Pointer to the internal logger structure, or NULL upon memory
+ *      allocation error.
+ *
+ *  \details    Lookups are lock-free. During a resize both the current and
+ *      the old slot arrays are searched; the old one is freed only when no
+ *      reader can access it (epoch-based reclamation). A miss, which may be
+ *      false during a resize, is resolved under `write_mutex`. Lookups that
+ *      find the channel during a resize also migrate a few groups if the mutex
+ *      is free, so the resize completes without a stop-the-world pause.
+ */
+static _lw_loggerf_t* _get_logger_dynamic_size(const char* channel)
+{
+    assert(g_p_manager != NULL && "Logging manager is not initialized");
+
+    char key[LOG_CHANNEL_LEN];
+    _lw_make_key(key, channel);
+    const uint64_t hash = _lw_key_hash(key);
+
+    epoch_rec_t* p_rec = _epoch_rec();
+    if (p_rec != NULL) {
+        atomic_store(&p_rec->epoch, atomic_load(&g_epoch));
+        slot_array_t* p_table = atomic_load(&g_p_manager->p_table);
+        slot_array_t* p_old = atomic_load(&g_p_manager->p_old_table);
+        hash_node_t* p_node = _find_node(p_table, hash, key);
+        if (p_node == NULL && p_old != NULL) {
+            p_node = _find_node(p_old, hash, key);
+        }
+        atomic_store_explicit(&p_rec->epoch, 0, memory_order_release);
 
-    pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
-    return &(*p_node)->logger;
+        if (p_node != NULL) {
+            if (p_old != NULL && pthread_mutex_trylock(&g_p_manager->write_mutex) == 0) {
+                _migrate_groups(_MIGRATE_STEP);
+                pthread_mutex_unlock(&g_p_manager->write_mutex);
+            }
+            return &p_node->logger;
+        }
+    }
+
+    pthread_mutex_lock(&g_p_manager->write_mutex);
+    _lw_loggerf_t* p_logger = _insert_dynamic_size(key, hash);
+    pthread_mutex_unlock(&g_p_manager->write_mutex);
+    return p_logger;
 }
 
 /**
- *  \brief  Retrieves an existing logger channel or takes a new one from the
- *      preallocated pool.
+ *  \brief  Retrieves an existing logger channel or claims a new slot of the
+ *      preallocated table.
  *  \param  channel - the name of the requested channel.
- *  \return Pointer to the logger structure, or NULL if the pool is full.
+ *  \return Pointer to the logger structure, or NULL if the channel limit is
+ *      reached.
  *
- *  \details    Operates without additional `malloc` system calls.
+ *  \details    Operates without `malloc` and without locks. Slots of the table
+ *      are never removed or moved, so a lookup is a probe over snapshots of
+ *      control byte groups. A new channel claims the first empty slot of its
+ *      probe sequence by CAS of its control byte and publishes the filled node
+ *      by a release store of its hash bits. A thread which meets a claimed but
+ *      not yet published slot waits for its publication, because the slot may
+ *      contain the same channel.
  */
 static _lw_loggerf_t* _get_logger_fixed_size(const char* channel)
 {
     assert(g_p_manager != NULL && "Logging manager is not initialized");
 
-    int length = strlen(channel);
-    if (length > (LOG_CHANNEL_LEN - 1)) {
-        length = LOG_CHANNEL_LEN - 1;
-    }
-    size_t hash = _hash_fn(channel, length);
+    char key[LOG_CHANNEL_LEN];
+    _lw_make_key(key, channel);
+    const uint64_t hash = _lw_key_hash(key);
+    const unsigned char ctrl = _ctrl_of(hash);
 
-    // Fast Read (Multiple threads simultaneously)
-    pthread_rwlock_rdlock(&g_p_manager->bucket_mutex);
-    int i = hash % g_p_manager->capacity;
+    size_t g = _first_group(hash, g_p_manager->group_mask);
+    size_t step = 1;
+    while (step <= g_p_manager->group_mask + 1) {
+        atomic_uchar* p_group_ctrl = &g_p_manager->p_ctrl[g * _LW_GROUP_SIZE];
+        hash_node_t* p_group_slots = &g_p_manager->p_slots[g * _LW_GROUP_SIZE];
+        // All decisions below are made on a single snapshot of the group.
+        const _lw_group_t group = _lw_group_load(p_group_ctrl);
+        for (_lw_group_mask_t m = _lw_group_match(group, ctrl); m != 0; m = _lw_mask_next(m)) {
+            const size_t i = _lw_mask_first(m);
+            if (atomic_load_explicit(&p_group_ctrl[i], memory_order_acquire) == ctrl
+                    && p_group_slots[i].hash == hash && _lw_key_equal(p_group_slots[i].key, key)) {
+                return &p_group_slots[i].logger;
+            }
+        }
+
+        _lw_group_mask_t busy = _lw_group_match(group, _LW_CTRL_BUSY);
+        if (busy != 0) {
+            // Wait for the publication of concurrently created channels and
+            // examine the group again.
+            for (; busy != 0; busy = _lw_mask_next(busy)) {
+                const size_t i = _lw_mask_first(busy);
+                while (atomic_load_explicit(&p_group_ctrl[i], memory_order_acquire) == _LW_CTRL_BUSY) {
+                    sched_yield();
+                }
+            }
+            continue;
+        }
+
+        const _lw_group_mask_t empty = _lw_group_match(group, _LW_CTRL_EMPTY);
+        if (empty != 0) {
+            const size_t i = _lw_mask_first(empty);
+            unsigned char expected = _LW_CTRL_EMPTY;
+            if (! atomic_compare_exchange_strong_explicit(&p_group_ctrl[i], &expected, _LW_CTRL_BUSY,
+                                                          memory_order_acquire, memory_order_relaxed)) {
+                // The slot is claimed by another thread, examine the group again.
+                continue;
+            }
+            // The slot is claimed, check the channel limit.
+            if (atomic_fetch_add_explicit(&g_p_manager->slot_size, 1, memory_order_relaxed) >= g_p_manager->capacity) {
+                atomic_fetch_sub_explicit(&g_p_manager->slot_size, 1, memory_order_relaxed);
+                atomic_store_explicit(&p_group_ctrl[i], _LW_CTRL_EMPTY, memory_order_release);
+                return NULL;
+            }
+
+            p_group_slots[i].hash = hash;
+            _init_levels(&p_group_slots[i].logger);
+            memcpy(p_group_slots[i].key, key, LOG_CHANNEL_LEN);
+            // Sequentially consistent with the loads of the global level (see _update_eff_level).
+            atomic_store(&p_group_ctrl[i], ctrl);
+            _update_eff_level(&p_group_slots[i].logger);
+            return &p_group_slots[i].logger;
+        }
+
+        g = (g + step) & g_p_manager->group_mask;
+        ++step;
+    }
+    return NULL;
+}
 
-    hash_node_t** p_node;
-    for (p_node = &g_p_manager->p_bucket[i]; *p_node != NULL; p_node = &(*p_node)->p_next) {
-        if ((*p_node)->channel_length == length && memcmp((*p_node)->logger.channel, channel, length) == 0) {
-            //return &(*p_node)->logger;
-            _lw_loggerf_t* p_logger = &(*p_node)->logger;
-            pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
-            return p_logger;
+/**
+ *  \brief  Searches for an interned name.
+ *  \return Pointer to the token, or NULL if the name is not interned.
+ *
+ *  \details    Must be called under `intern_mutex`.
+ */
+static channel_token_t* _find_token(const char* channel, size_t len, uint64_t hash)
+{
+    if (g_p_manager->p_buckets == NULL) {
+        return NULL;
+    }
+    for (channel_token_t* p_token = g_p_manager->p_buckets[hash & g_p_manager->bucket_mask];
+            p_token != NULL; p_token = p_token->p_next) {
+        if (p_token->hash == hash && p_token->len == len && memcmp(p_token->name, channel, len) == 0) {
+            return p_token;
         }
     }
+    return NULL;
+}
 
-    pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
+/**
+ *  \brief  Makes room for one more token in the intern table.
+ *  \return false if the table has no buckets and cannot be allocated.
+ *
+ *  \details    The number of buckets is doubled when it is reached by the
+ *      number of tokens. If the new buckets cannot be allocated, the old ones
+ *      are kept with longer chains. Must be called under `intern_mutex`.
+ */
+static bool _reserve_token(void)
+{
+    const size_t bucket_count = (g_p_manager->p_buckets != NULL) ? g_p_manager->bucket_mask + 1 : 0;
+    if (g_p_manager->token_count < bucket_count) {
+        return true;
+    }
+    const size_t new_count = (bucket_count != 0) ? 2 * bucket_count : 16;
+    channel_token_t** p_buckets = (channel_token_t**)calloc(new_count, sizeof(channel_token_t*));
+    if (p_buckets == NULL) {
+        return bucket_count != 0;
+    }
+    for (size_t b = 0; b < bucket_count; ++b) {
+        while (g_p_manager->p_buckets[b] != NULL) {
+            channel_token_t* p_token = g_p_manager->p_buckets[b];
+            g_p_manager->p_buckets[b] = p_token->p_next;
+            p_token->p_next = p_buckets[p_token->hash & (new_count - 1)];
+            p_buckets[p_token->hash & (new_count - 1)] = p_token;
+        }
+    }
+    free(g_p_manager->p_buckets);
+    g_p_manager->p_buckets = p_buckets;
+    g_p_manager->bucket_mask = new_count - 1;
+    return true;
+}
 
-    // Exclusive Write (Only one thread)
-    pthread_rwlock_wrlock(&g_p_manager->bucket_mutex);
-    // Double-check. While we were waiting for the wrlock, another thread might
-    // have already created this channel.
-    i = hash % g_p_manager->capacity;
-    for (p_node = &g_p_manager->p_bucket[i]; *p_node != NULL; p_node = &(*p_node)->p_next) {
-        if ((*p_node)->channel_length == length && memcmp((*p_node)->logger.channel, channel, length) == 0) {
-            _lw_loggerf_t* p_logger = &(*p_node)->logger;
-            pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
-            return p_logger;
+/**
+ *  \brief  Interns a new name.
+ *  \return Pointer to the token, or NULL if the channel cannot be created.
+ *
+ *  \details    A short name resolves its logger in the channel table, a long
+ *      one gets its own logger, which counts against the channel limit of the
+ *      fixed_size policy. Must be called under `intern_mutex`.
+ */
+static channel_token_t* _insert_token(const char* channel, size_t len, uint64_t hash)
+{
+    const bool is_long = (len >= LOG_CHANNEL_LEN);
+    _lw_loggerf_t* p_logger = NULL;
+    if (! is_long) {
+        p_logger = g_p_manager->get_logger_fn(channel);
+        if (p_logger == NULL) {
+            return NULL;
+        }
+    } else if (g_p_manager->p_ctrl != NULL) {
+        if (atomic_fetch_add_explicit(&g_p_manager->slot_size, 1, memory_order_relaxed) >= g_p_manager->capacity) {
+            atomic_fetch_sub_explicit(&g_p_manager->slot_size, 1, memory_order_relaxed);
+            return NULL;
         }
     }
 
-    if (g_p_manager->size >= g_p_manager->capacity) {
-        pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
+    channel_token_t* p_token = NULL;
+    if (_reserve_token()) {
+        p_token = (channel_token_t*)_lw_arena_alloc(&g_p_manager->intern_arena, sizeof(channel_token_t) + len + 1,
+                                                    _Alignof(channel_token_t));
+    }
+    if (p_token == NULL) {
+        if (is_long && g_p_manager->p_ctrl != NULL) {
+            atomic_fetch_sub_explicit(&g_p_manager->slot_size, 1, memory_order_relaxed);
+        }
         return NULL;
     }
-    if (g_p_manager->p_pool == NULL) {
-        pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
+    p_token->hash = hash;
+    p_token->len = len;
+    memcpy(p_token->name, channel, len + 1);
+    if (is_long) {
+        p_token->logger.p_logger = g_p_manager->logger_fn;
+        p_token->logger.channel = p_token->name;
+        _init_levels(&p_token->logger);
+        p_logger = &p_token->logger;
+    }
+    p_token->p_logger = p_logger;
+    p_token->p_next = g_p_manager->p_buckets[hash & g_p_manager->bucket_mask];
+    g_p_manager->p_buckets[hash & g_p_manager->bucket_mask] = p_token;
+    ++g_p_manager->token_count;
+    if (is_long) {
+        // The token is visible to _update_eff_levels from here on.
+        _update_eff_level(p_logger);
+    }
+    return p_token;
+}
+
+/**
+ *  \brief  Returns the token of a channel name, interning it on the first call.
+ *  \return Pointer to the token, or NULL if the channel cannot be created.
+ */
+static channel_token_t* _intern(const char* channel)
+{
+    const size_t len = strlen(channel);
+    const uint64_t hash = _lw_name_hash(channel, len);
+
+    pthread_mutex_lock(&g_p_manager->intern_mutex);
+    channel_token_t* p_token = _find_token(channel, len, hash);
+    if (p_token == NULL) {
+        p_token = _insert_token(channel, len, hash);
+    }
+    pthread_mutex_unlock(&g_p_manager->intern_mutex);
+    return p_token;
+}
+
+/**
+ *  \brief  Searches for a channel of the registered manifest.
+ *  \param  channel - channel name.
+ *  \param  hash - hash of the name returned by `lw_manifest_hash`.
+ *  \return Pointer to the token of the channel, or NULL if the channel is not
+ *      in the manifest.
+ *
+ *  \details    Lock-free: the tokens are published before the manifest.
+ */
+static inline const channel_token_t* _find_manifest_token(const char* channel, uint32_t hash)
+{
+    const lw_channel_manifest_t* p_manifest = atomic_load_explicit(&g_p_manager->p_manifest, memory_order_acquire);
+    if (p_manifest == NULL) {
         return NULL;
     }
+    const size_t id = lw_manifest_slot(p_manifest, hash);
+    return (strcmp(p_manifest->p_names[id], channel) == 0) ? g_p_manager->p_manifest_tokens[id] : NULL;
+}
 
-    // Allocation from a fixed array
-    *p_node = &g_p_manager->p_pool[g_p_manager->size];
-    (*p_node)->p_next = NULL;
-    ++g_p_manager->size;
+/**
+ *  \brief  Retrieves an existing logger channel or creates a new one, for a
+ *      name of any length.
+ *  \param  channel - the name of the requested channel.
+ *  \param  pp_token - receives the token of a long name, or NULL for a short one.
+ *  \return Pointer to the logger structure, or NULL if the channel cannot be
+ *      created.
+ *
+ *  \details    Channels of the registered manifest are found by the perfect
+ *      hash. Other names shorter than `LOG_CHANNEL_LEN` are searched in the
+ *      channel table by their keys, longer ones are interned.
+ */
+static _lw_loggerf_t* _get_logger_any(const char* channel, const channel_token_t** pp_token)
+{
+    if (atomic_load_explicit(&g_p_manager->p_manifest, memory_order_relaxed) != NULL) {
+        const channel_token_t* p_token = _find_manifest_token(channel, lw_manifest_hash(channel));
+        if (p_token != NULL) {
+            *pp_token = (p_token->len >= LOG_CHANNEL_LEN) ? p_token : NULL;
+            return p_token->p_logger;
+        }
+    }
+    if (strnlen(channel, LOG_CHANNEL_LEN) < LOG_CHANNEL_LEN) {
+        *pp_token = NULL;
+        return g_p_manager->get_logger_fn(channel);
+    }
+    *pp_token = _intern(channel);
+    return (*pp_token != NULL) ? (*pp_token)->p_logger : NULL;
+}
+
+/**
+ *  \brief  Recomputes the effective levels of all channels after a change of
+ *      the global level.
+ *
+ *  \details    Channels of the fixed_size policy which are being created
+ *      concurrently are skipped: their creators recompute the level after the
+ *      publication. The slot arrays of the dynamic_size policy are traversed
+ *      under `write_mutex`, which keeps them alive. The loggers of long names
+ *      are traversed under `intern_mutex`.
+ */
+static void _update_eff_levels(void)
+{
+    if (g_p_manager->p_ctrl != NULL) {
+        const size_t slot_count = (g_p_manager->group_mask + 1) * _LW_GROUP_SIZE;
+        for (size_t i = 0; i < slot_count; ++i) {
+            if (atomic_load(&g_p_manager->p_ctrl[i]) & _LW_CTRL_FULL) {
+                _update_eff_level(&g_p_manager->p_slots[i].logger);
+            }
+        }
+    } else {
+        pthread_mutex_lock(&g_p_manager->write_mutex);
+        slot_array_t* tables[2] = {atomic_load_explicit(&g_p_manager->p_table, memory_order_relaxed),
+                                   atomic_load_explicit(&g_p_manager->p_old_table, memory_order_relaxed)};
+        for (size_t t = 0; t < 2 && tables[t] != NULL; ++t) {
+            const size_t slot_count = (tables[t]->group_mask + 1) * _LW_GROUP_SIZE;
+            for (size_t i = 0; i < slot_count; ++i) {
+                if (atomic_load_explicit(&tables[t]->p_ctrl[i], memory_order_relaxed) != _LW_CTRL_EMPTY) {
+                    _update_eff_level(&atomic_load_explicit(&tables[t]->p_slots[i], memory_order_relaxed)->logger);
+                }
+            }
+        }
+        pthread_mutex_unlock(&g_p_manager->write_mutex);
+    }
+
+    pthread_mutex_lock(&g_p_manager->intern_mutex);
+    if (g_p_manager->p_buckets != NULL) {
+        for (size_t b = 0; b <= g_p_manager->bucket_mask; ++b) {
+            for (channel_token_t* p_token = g_p_manager->p_buckets[b]; p_token != NULL; p_token = p_token->p_next) {
+                if (p_token->p_logger == &p_token->logger) {
+                    _update_eff_level(&p_token->logger);
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&g_p_manager->intern_mutex);
+}
+
+/**
+ *  \brief  Retrieves a logger channel missed by the lookup cache of the thread
+ *      and fills the cache entry.
+ *
+ *  \details    Kept out of line, so the cache hit path does not pay for the
+ *      register spills of the channel table search.
+ */
+static __attribute__((noinline)) _lw_loggerf_t* _get_logger_uncached(const char* channel, cache_entry_t* p_entry,
+                                                                     size_t generation)
+{
+    const channel_token_t* p_token = NULL;
+    _lw_loggerf_t* p_logger = _get_logger_any(channel, &p_token);
+    if (p_logger != NULL) {
+        p_entry->channel = channel;
+        p_entry->p_logger = p_logger;
+        p_entry->p_token = p_token;
+        p_entry->generation = generation;
+    }
+    return p_logger;
+}
+
+/**
+ *  \brief  Retrieves a logger channel through the lookup cache of the thread.
+ *  \param  channel - the name of the requested channel.
+ *  \return Pointer to the logger structure, or NULL if the channel cannot be
+ *      created.
+ *
+ *  \details    A hit costs one load of the name and one key compare: the
+ *      content at a cached address is still verified against the channel name
+ *      of the cached logger, because the caller may reuse a buffer for another
+ *      name. A name of `LOG_CHANNEL_LEN - 1` characters has the same key as its
+ *      extensions, so it must also end there, and a long name is compared with
+ *      its token in full. The cache is private to the thread and is
+ *      invalidated as a whole by a new generation of the manager, so no shared
+ *      state is written.
+ */
+static inline _lw_loggerf_t* _get_logger_cached(const char* channel)
+{
+    const uint64_t addr_hash = (uint64_t)(uintptr_t)channel * 0x9E3779B97F4A7C15ull;
+    cache_entry_t* p_entry = &tl_lookup_cache[addr_hash >> (64 - _LOOKUP_CACHE_BITS)];
+    const size_t generation = atomic_load_explicit(&g_generation, memory_order_relaxed);
+    if (p_entry->channel == channel && p_entry->generation == generation) {
+        if (p_entry->p_token == NULL) {
+            char key[LOG_CHANNEL_LEN];
+            _lw_make_key(key, channel);
+            if (_lw_key_equal(key, p_entry->p_logger->channel)
+                    && (key[LOG_CHANNEL_LEN - 2] == '\0' || channel[LOG_CHANNEL_LEN - 1] == '\0')) {
+                return p_entry->p_logger;
+            }
+        } else if (strcmp(channel, p_entry->p_token->name) == 0) {
+            return p_entry->p_logger;
+        }
+    }
+    return _get_logger_uncached(channel, p_entry, generation);
+}
 
-    (*p_node)->logger.level = debug;
-    memcpy((*p_node)->logger.channel, channel, length);
-    (*p_node)->logger.channel[length] = '\0';
-    (*p_node)->channel_length = length;
+/*******************************************************************************
+ * Internal interface
+ ******************************************************************************/
 
-    pthread_rwlock_unlock(&g_p_manager->bucket_mutex);
-    return &(*p_node)->logger;
+void _lw_set_burst_level(const char* channel, int lvl)
+{
+    const channel_token_t* p_token = NULL;
+    _lw_loggerf_t* p_logger = _get_logger_any(channel, &p_token);
+    if (p_logger != NULL) {
+        atomic_store(&p_logger->burst_level, lvl);
+        _update_eff_level(p_logger);
+    }
 }
 
 /*******************************************************************************
  * Public interface
  ******************************************************************************/
 
-bool lw_can_log(int lvl)
+lw_loggerf_t lw_get_logger(const char* channel)
 {
     assert(g_p_manager != NULL && "Logging manager is not initialized");
-    if (lvl < 0 || lvl > LVL_TRACE) {
-        return false;
+    return _get_logger_cached(channel);
+}
+
+lw_loggerf_t lw_get_logger_dfl(const char* channel, lw_severity_level_t dfl_lvl)
+{
+    assert(g_p_manager != NULL && "Logging manager is not initialized");
+
+    _lw_loggerf_t* p_logger = _get_logger_cached(channel);
+    if (p_logger != NULL) {
+        atomic_store(&p_logger->level, dfl_lvl);
+        _update_eff_level(p_logger);
     }
-    // Safe atomic read
-    return g_p_manager->global_lvl >= lvl;
+    return p_logger;
 }
 
-bool lw_can_channel_log(lw_loggerf_t p_logger, int lvl)
+lw_severity_level_t lw_global_level(void)
+{
+    assert(g_p_manager != NULL && "Logging manager is not initialized");
+    return (lw_severity_level_t)atomic_load_explicit(&lw_g_global_lvl, memory_order_relaxed);
+}
+
+bool lw_register_channel_manifest(const lw_channel_manifest_t* p_manifest)
 {
-    if (p_logger == NULL) {
+    assert(g_p_manager != NULL && "Logging manager is not initialized");
+
+    if (p_manifest == NULL || p_manifest->count == 0 || p_manifest->bucket_count == 0
+            || atomic_load(&g_p_manager->p_manifest) != NULL) {
         return false;
     }
-    if (lvl < 0 || lvl > LVL_TRACE) {
+    channel_token_t** p_tokens = (channel_token_t**)malloc(p_manifest->count * sizeof(channel_token_t*));
+    if (p_tokens == NULL) {
         return false;
     }
-    // Safe atomic read
-    return p_logger->level >= lvl;
+    for (size_t id = 0; id < p_manifest->count; ++id) {
+        // Tables generated for another hash function would miss the channels.
+        const char* p_name = p_manifest->p_names[id];
+        if (lw_manifest_slot(p_manifest, lw_manifest_hash(p_name)) != id || (p_tokens[id] = _intern(p_name)) == NULL) {
+            free(p_tokens);
+            return false;
+        }
+    }
+
+    bool is_registered = false;
+    pthread_mutex_lock(&g_p_manager->intern_mutex);
+    if (atomic_load_explicit(&g_p_manager->p_manifest, memory_order_relaxed) == NULL) {
+        g_p_manager->p_manifest_tokens = p_tokens;
+        atomic_store_explicit(&g_p_manager->p_manifest, p_manifest, memory_order_release);
+        is_registered = true;
+    }
+    pthread_mutex_unlock(&g_p_manager->intern_mutex);
+    if (! is_registered) {
+        free(p_tokens);
+    }
+    return is_registered;
 }
 
-lw_loggerf_t lw_get_logger(const char* channel)
+lw_loggerf_t lw_get_manifest_logger(size_t id)
 {
     assert(g_p_manager != NULL && "Logging manager is not initialized");
-    return g_p_manager->get_logger_fn(channel);
+
+    const lw_channel_manifest_t* p_manifest = atomic_load_explicit(&g_p_manager->p_manifest, memory_order_acquire);
+    if (p_manifest == NULL || id >= p_manifest->count) {
+        return NULL;
+    }
+    return g_p_manager->p_manifest_tokens[id]->p_logger;
 }
 
-lw_loggerf_t lw_get_logger_dfl(const char* channel, lw_severity_level_t dfl_lvl)
+lw_loggerf_t lw_get_logger_hashed(const char* channel, uint32_t hash)
 {
     assert(g_p_manager != NULL && "Logging manager is not initialized");
 
-    _lw_loggerf_t* p_logger = g_p_manager->get_logger_fn(channel);
-    if (p_logger != NULL) {
-        p_logger->level = dfl_lvl;
-    }
-    return p_logger;
+    const channel_token_t* p_token = _find_manifest_token(channel, hash);
+    return (p_token != NULL) ? p_token->p_logger : _get_logger_cached(channel);
 }
 
-lw_severity_level_t lw_global_level(void)
+lw_channel_t lw_intern_channel(const char* channel)
 {
     assert(g_p_manager != NULL && "Logging manager is not initialized");
-    return g_p_manager->global_lvl;
+    return _intern(channel);
+}
+
+lw_loggerf_t lw_get_interned_logger(lw_channel_t token)
+{
+    return (token != NULL) ? token->p_logger : NULL;
+}
+
+const char* lw_channel_name(lw_channel_t token)
+{
+    return (token != NULL) ? token->name : NULL;
 }
 
 bool lw_init_logging(lw_loggerf_fn_t p_logger_fn, lw_logging_policy_t policy, size_t channel_count,
@@ -357,19 +1071,38 @@ bool lw_init_logging(lw_loggerf_fn_t p_logger_fn, lw_logging_policy_t policy, si
         return false;
     }
 
-    // Initialize the read/write mutex
-    if (pthread_rwlock_init(&g_p_manager->bucket_mutex, NULL) != 0) {
+    // Initialize the writer mutex
+    if (pthread_mutex_init(&g_p_manager->write_mutex, NULL) != 0) {
+        free(g_p_manager);
+        g_p_manager = NULL;
+        return false;
+    }
+    if (pthread_mutex_init(&g_p_manager->intern_mutex, NULL) != 0) {
+        pthread_mutex_destroy(&g_p_manager->write_mutex);
         free(g_p_manager);
         g_p_manager = NULL;
         return false;
     }
+    g_p_manager->p_buckets = NULL;
+    g_p_manager->bucket_mask = 0;
+    g_p_manager->token_count = 0;
+    _lw_arena_init(&g_p_manager->intern_arena, 0);
+    atomic_init(&g_p_manager->p_manifest, NULL);
+    g_p_manager->p_manifest_tokens = NULL;
 
     g_p_manager->size = 0;
     g_p_manager->capacity = channel_count;
-    g_p_manager->global_lvl = dfl_lvl;
-    g_p_manager->is_immutable = 0;
-    g_p_manager->p_bucket = NULL;
-    g_p_manager->p_pool = NULL;
+    atomic_store_explicit(&lw_g_global_lvl, dfl_lvl, memory_order_relaxed);
+    atomic_init(&g_p_manager->is_immutable, 0);
+    atomic_init(&g_p_manager->p_table, NULL);
+    atomic_init(&g_p_manager->p_old_table, NULL);
+    g_p_manager->migrate_pos = 0;
+    g_p_manager->p_retired = NULL;
+    _lw_arena_init(&g_p_manager->node_arena, channel_count * sizeof(hash_node_t));
+    g_p_manager->p_ctrl = NULL;
+    g_p_manager->p_slots = NULL;
+    g_p_manager->group_mask = 0;
+    atomic_init(&g_p_manager->slot_size, 0);
     g_p_manager->p_root_logger = NULL;
     g_p_manager->logger_fn = p_logger_fn;
     if (policy == fixed_size) {
@@ -379,63 +1112,114 @@ bool lw_init_logging(lw_loggerf_fn_t p_logger_fn, lw_logging_policy_t policy, si
         g_p_manager->get_logger_fn = _get_logger_dynamic_size;
     }
 
-    g_p_manager->p_bucket = (hash_node_t**)malloc(channel_count * sizeof(hash_node_t*));
-    if (g_p_manager->p_bucket == NULL) {
-        lw_deinit_logging();
-        return false;
-    }
-    for (size_t i = 0; i < channel_count; ++i) {
-        g_p_manager->p_bucket[i] = NULL;
+    // The load factor of the tables does not exceed 7/8, so probe sequences
+    // stay short and always meet an empty slot.
+    size_t slot_count = _LW_GROUP_SIZE;
+    while (slot_count - slot_count / 8 <= channel_count) {
+        slot_count <<= 1;
     }
-
     if (policy == fixed_size) {
-        g_p_manager->p_pool = (hash_node_t*)malloc(channel_count * sizeof(hash_node_t));
-        if (g_p_manager->p_pool == NULL) {
+        g_p_manager->p_ctrl = (atomic_uchar*)aligned_alloc(_LW_GROUP_SIZE, slot_count);
+        g_p_manager->p_slots = (hash_node_t*)malloc(slot_count * sizeof(hash_node_t));
+        if (g_p_manager->p_ctrl == NULL || g_p_manager->p_slots == NULL) {
             lw_deinit_logging();
             return false;
         }
-        for (size_t i = 0; i < channel_count; ++i) {
-            g_p_manager->p_pool[i].logger.p_logger = p_logger_fn;
-            g_p_manager->p_pool[i].p_next = NULL;
+        g_p_manager->group_mask = slot_count / _LW_GROUP_SIZE - 1;
+        for (size_t i = 0; i < slot_count; ++i) {
+            atomic_init(&g_p_manager->p_ctrl[i], _LW_CTRL_EMPTY);
+            g_p_manager->p_slots[i].logger.p_logger = p_logger_fn;
+            g_p_manager->p_slots[i].logger.channel = g_p_manager->p_slots[i].key;
+            atomic_init(&g_p_manager->p_slots[i].logger.level, debug);
+            atomic_init(&g_p_manager->p_slots[i].logger.burst_level, -1);
+            atomic_init(&g_p_manager->p_slots[i].logger.eff_level, debug);
+        }
+    } else {
+        slot_array_t* p_table = _slot_array_create(slot_count);
+        if (p_table == NULL) {
+            lw_deinit_logging();
+            return false;
         }
+        atomic_store(&g_p_manager->p_table, p_table);
     }
 
     if (p_root_ch != NULL) {
-        g_p_manager->p_root_logger = g_p_manager->get_logger_fn(p_root_ch);
+        const channel_token_t* p_token = NULL;
+        g_p_manager->p_root_logger = _get_logger_any(p_root_ch, &p_token);
     }
 
     return true;
 }
 
+bool lw_init_logging_async(int fd, lw_logging_policy_t policy, size_t channel_count,
+                           lw_severity_level_t dfl_lvl, const char* p_root_ch)
+{
+    assert(g_p_manager == NULL && "Logging manager is initialized");
+
+    if (fd < 0) {
+        return false;
+    }
+    if (! _lw_async_start(fd)) {
+        return false;
+    }
+    if (! lw_init_logging(_lw_async_loggerf, policy, channel_count, dfl_lvl, p_root_ch)) {
+        _lw_async_stop();
+        return false;
+    }
+    return true;
+}
+
+void lw_flush_logging(void)
+{
+    if (_lw_async_started()) {
+        _lw_async_flush();
+    }
+}
+
+bool lw_drain_logging(void)
+{
+    return _lw_async_started() ? _lw_async_drain() : true;
+}
+
 bool lw_deinit_logging(void)
 {
     if (g_p_manager == NULL) {
         return true;
     }
 
+    // Stop the bursts, drop the captured records and write out the queued
+    // lines while the loggers are still alive.
+    _lw_burst_release();
+    _lw_flight_release();
+    _lw_async_stop();
+
     loggingf_manager_t* p_manager = g_p_manager;
 
-    pthread_rwlock_wrlock(&p_manager->bucket_mutex);
+    pthread_mutex_lock(&p_manager->write_mutex);
 
     g_p_manager = NULL;
+    atomic_store_explicit(&lw_g_global_lvl, -1, memory_order_relaxed);
+    // Invalidate the lookup caches of all threads.
+    atomic_fetch_add(&g_generation, 1);
 
     // Destroy the lock before freeing memory
-    pthread_rwlock_unlock(&p_manager->bucket_mutex);
-    pthread_rwlock_destroy(&p_manager->bucket_mutex);
-
-    if (p_manager->p_bucket != NULL && p_manager->p_pool == NULL) {
-        for (size_t i = 0; i < p_manager->capacity; ++i) {
-            hash_node_t* p_node = p_manager->p_bucket[i];
-            while (p_node != NULL) {
-                hash_node_t* p_del_node = p_node;
-                p_node = p_node->p_next;
-                free(p_del_node);
-            }
-        }
-    }
+    pthread_mutex_unlock(&p_manager->write_mutex);
+    pthread_mutex_destroy(&p_manager->write_mutex);
+    pthread_mutex_destroy(&p_manager->intern_mutex);
 
-    free(p_manager->p_pool);
-    free(p_manager->p_bucket);
+    _lw_arena_release(&p_manager->node_arena);
+    _lw_arena_release(&p_manager->intern_arena);
+    free(p_manager->p_buckets);
+    free(p_manager->p_manifest_tokens);
+    free(atomic_load(&p_manager->p_old_table));
+    free(atomic_load(&p_manager->p_table));
+    free(p_manager->p_ctrl);
+    free(p_manager->p_slots);
+    while (p_manager->p_retired != NULL) {
+        slot_array_t* p_table = p_manager->p_retired;
+        p_manager->p_retired = p_table->p_next_retired;
+        free(p_table);
+    }
     free(p_manager);
     g_p_manager = NULL;
     return true;
@@ -450,20 +1234,21 @@ lw_loggerf_t lw_root_logger(void)
 void lw_set_global_level(lw_severity_level_t lvl)
 {
     assert(g_p_manager != NULL && "Logging manager is not initialized");
-    if (! g_p_manager->is_immutable) {
+    if (! atomic_load_explicit(&g_p_manager->is_immutable, memory_order_acquire)) {
         if ((lvl < emerg) || (lvl > trace)) {
             return;
         }
-        g_p_manager->global_lvl = lvl;
+        atomic_store(&lw_g_global_lvl, lvl);
+        _update_eff_levels();
     }
 }
 
 void lw_set_immutable_global_level(lw_severity_level_t lvl)
 {
     assert(g_p_manager != NULL && "Logging manager is not initialized");
-    if (! g_p_manager->is_immutable) {
+    if (! atomic_load_explicit(&g_p_manager->is_immutable, memory_order_acquire)) {
         lw_set_global_level(lvl);
-        g_p_manager->is_immutable = 1;
+        atomic_store_explicit(&g_p_manager->is_immutable, 1, memory_order_release);
     }
 }
 
@@ -471,12 +1256,14 @@ void lw_set_logger_level(const char* channel, lw_severity_level_t lvl)
 {
     assert(g_p_manager != NULL && "Logging, lw_logging_policy_t policy manager is not initialized");
 
-    _lw_loggerf_t* p_logger = g_p_manager->get_logger_fn(channel);
+    const channel_token_t* p_token = NULL;
+    _lw_loggerf_t* p_logger = _get_logger_any(channel, &p_token);
     if (p_logger != NULL) {
         if ((lvl < emerg) || (lvl > trace)) {
             return;
         }
-        p_logger->level = lvl;
+        atomic_store(&p_logger->level, lvl);
+        _update_eff_level(p_logger);
     }
 }
 
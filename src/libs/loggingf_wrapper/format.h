@@ -0,0 +1,87 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Fast conversion of numbers to text.
+ *  \ingroup loggingf_wrapper_module
+ *
+ *  \details    The functions write the text of a number directly into a
+ *      caller-provided buffer, which must have room for the longest text of
+ *      the type, and return its length. The text is not null-terminated.
+ *
+ *      Integers are converted two digits at a time by a table lookup.
+ *      Floating point numbers are converted to the shortest decimal which
+ *      reads back to the same value, by the Schubfach algorithm of
+ *      R. Giulietti, and printed in the fixed or the scientific notation,
+ *      whichever is shorter (the fixed one on a tie). The text is the same as
+ *      that of `std::to_chars(first, last, value)` of C++17.
+ *
+ *  \code
+ *  char buf[LW_FORMAT_DOUBLE_LEN];
+ *  const size_t len = lw_format_double(buf, 0.1);   // "0.1"
+ *  fwrite(buf, 1, len, stdout);
+ *  \endcode
+ */
+
+#ifndef _LIBS_LOGGINGF_WRAPPER_FORMAT_H_
+#define _LIBS_LOGGINGF_WRAPPER_FORMAT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/** \brief  Maximum length of the text of a 64-bit integer, e.g. `-9223372036854775808`. */
+#define LW_FORMAT_INT_LEN       20
+/** \brief  Maximum length of the text of a `double`, e.g. `-2.2250738585072014e-308`. */
+#define LW_FORMAT_DOUBLE_LEN    24
+
+/**
+ *  \brief  Writes the decimal text of an unsigned integer.
+ *  \param  p_buf - buffer of at least \ref LW_FORMAT_INT_LEN characters.
+ *  \param  value - number.
+ *  \return Length of the text.
+ */
+size_t lw_format_u64(char* p_buf, uint64_t value);
+
+/**
+ *  \brief  Writes the decimal text of a signed integer.
+ *  \param  p_buf - buffer of at least \ref LW_FORMAT_INT_LEN characters.
+ *  \param  value - number.
+ *  \return Length of the text.
+ */
+size_t lw_format_i64(char* p_buf, int64_t value);
+
+/**
+ *  \brief  Writes the shortest round-trip text of a floating point number.
+ *  \param  p_buf - buffer of at least \ref LW_FORMAT_DOUBLE_LEN characters.
+ *  \param  value - number.
+ *  \return Length of the text.
+ *
+ *  \details    Infinities are written as `inf` and NaNs as `nan`, with a sign
+ *      if it is negative.
+ */
+size_t lw_format_double(char* p_buf, double value);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _LIBS_LOGGINGF_WRAPPER_FORMAT_H_ */
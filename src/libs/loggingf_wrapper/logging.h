@@ -27,7 +27,46 @@
 #include "loggingf_wrapper/manager.h"
 #include "loggingf_wrapper/severity_level.h"
 
-#if defined(LOGGINGF_WRAPPER_IMPL)
+#if defined(LOGGINGF_WRAPPER_DEFERRED)
+    #if defined(__cplusplus)
+        #error "LOGGINGF_WRAPPER_DEFERRED requires C11 _Generic"
+    #endif
+
+    #include "loggingf_wrapper/deferred.h"
+
+    /**
+     *  \def    _LOGGINGF_WRAPPER_IMPL(logger, level, fmt, ...)
+     *  \brief  Deferred implementation of formatted C-style logging.
+     *  \param  logger - logger object providing the channel and write method.
+     *  \param  level - severity level for the log entry.
+     *  \param  fmt - format string literal (printf-style).
+     *  \param  ... - variadic arguments for the format string.
+     *
+     *  \details    The types of the arguments are captured at compile time and
+     *      their raw values are stored into a record, which is rendered later
+     *      (see `loggingf_wrapper/deferred.h`). The line has the format of the
+     *      default implementation.
+     */
+    #define _LOGGINGF_WRAPPER_IMPL(logger, level, fmt, ...)                 \
+        LW_DEFERRED_CAPTURE(_lw_site, _lw_args, level, fmt, __VA_ARGS__)    \
+        lw_deferred_log(logger, level, &_lw_site, _lw_args)
+
+    /**
+     *  \def    _LOGF_IS_ENABLED(logger, level)
+     *  \brief  Level check of a deferred statement: the record is either
+     *      written or captured by the flight recorder.
+     */
+    #define _LOGF_IS_ENABLED(logger, level)                                 \
+        (lw_is_log_enabled(logger, level) || lw_is_capture_enabled(logger, level))
+
+    /**
+     *  \def    _LOGF_IS_WRITTEN(logger, level)
+     *  \brief  Checks that a deferred statement, which passed
+     *      \ref _LOGF_IS_ENABLED, is written rather than only captured by the
+     *      flight recorder.
+     */
+    #define _LOGF_IS_WRITTEN(logger, level) lw_is_log_enabled(logger, level)
+#elif defined(LOGGINGF_WRAPPER_IMPL)
      /**
      *  \def    _LOGGINGF_WRAPPER_IMPL(logger, level, fmt, ...)
      *  \brief  Internal macro to invoke the custom C-style logging implementation.
@@ -76,6 +115,42 @@
                          cur_ts, logger->channel __VA_OPT__(,) __VA_ARGS__)
 #endif
 
+#if ! defined(_LOGF_IS_ENABLED)
+    /**
+     *  \def    _LOGF_IS_ENABLED(logger, level)
+     *  \brief  Level check of a statement.
+     */
+    #define _LOGF_IS_ENABLED(logger, level) lw_is_log_enabled(logger, level)
+#endif
+
+#if ! defined(_LOGF_IS_WRITTEN)
+    /**
+     *  \def    _LOGF_IS_WRITTEN(logger, level)
+     *  \brief  Checks that a statement, which passed \ref _LOGF_IS_ENABLED,
+     *      is written: outside of the deferred mode it always is.
+     */
+    #define _LOGF_IS_WRITTEN(logger, level) 1
+#endif
+
+#if defined(LOG_DISABLE_BURSTS)
+    #define _LOGF_BURST(logger, level)
+#else
+    /**
+     *  \def    _LOGF_BURST(logger, level)
+     *  \brief  Triggers the verbosity burst of the channel of an error record
+     *      (see \ref lw_enable_burst).
+     *
+     *  \details    Compares the level with `LVL_ERROR` first, so the compiler
+     *      folds the check away for less severe statements. A deferred record,
+     *      which is only captured by the flight recorder (see
+     *      \ref _LOGF_IS_WRITTEN), does not trigger a burst.
+     */
+    #define _LOGF_BURST(logger, level)                                      \
+        if (((level) <= LVL_ERROR) && _LOGF_IS_WRITTEN(logger, level)) {    \
+            lw_burst_check(logger);                                         \
+        }
+#endif
+
 /**
  *  \def    _LOGF(logger, level, fmt, ...)
  *  \brief  Base filtering and recording macro for the C-style logger.
@@ -88,16 +163,20 @@
  *      logging level permits recording. If logging is disabled, arguments are
  *      not evaluated (lazy evaluation).
  *
- *  \details    First checks the global logging level, then the level of the
- *      specific channel. If the checks pass, evaluates the arguments and forwards
- *      them to the logger implementation.
+ *  \details    Checks the effective level of the channel, which combines the
+ *      global logging level and the level of the specific channel. If the check
+ *      passes, evaluates the arguments and forwards them to the logger
+ *      implementation. In the deferred mode a record which passes the capture
+ *      level of the flight recorder is forwarded as well. An error record
+ *      triggers the verbosity burst of its channel.
  */
 #define _LOGF(logger, level, fmt, ...)                                      \
     do {                                                                    \
-        if (! lw_can_log(level) || ! lw_can_channel_log(logger, level)) {   \
+        if (! _LOGF_IS_ENABLED(logger, level)) {                            \
             break;                                                          \
         }                                                                   \
         _LOGGINGF_WRAPPER_IMPL(logger, level, fmt, __VA_ARGS__);            \
+        _LOGF_BURST(logger, level)                                          \
     }                                                                       \
     while (0)
 
@@ -24,17 +24,55 @@
 #ifndef _LIBS_LOGGINGF_WRAPPER_MANAGER_H_
 #define _LIBS_LOGGINGF_WRAPPER_MANAGER_H_
 
-#include <signal.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#if ! defined(__cplusplus)
+    #include <stdatomic.h>
+#endif
+
 #include "loggingf_wrapper/severity_level.h"
 
 #if ! defined(LOG_CHANNEL_LEN)
-    /** Maximum length of a log channel name (including the null terminator) */
+    /** Size of the inline key of a channel name (including the null terminator).
+        Longer names are interned (see \ref lw_intern_channel) */
     #define LOG_CHANNEL_LEN     16
 #endif
 
+#if ! defined(LOG_ASYNC_LINE_LEN)
+    /** Size of the per-thread formatting buffer of the asynchronous backend
+        (longer lines are formatted twice) */
+    #define LOG_ASYNC_LINE_LEN  1024
+#endif
+
+#if ! defined(LOG_ASYNC_FLUSH_MS)
+    /** Maximum delay in milliseconds before an idle writer of the asynchronous
+        backend writes the queued lines */
+    #define LOG_ASYNC_FLUSH_MS  10
+#endif
+
+#if ! defined(LOG_BURST_TICK_MS)
+    /** Resolution in milliseconds of the timers of the error-triggered
+        verbosity bursts (see \ref lw_enable_burst) */
+    #define LOG_BURST_TICK_MS   100
+#endif
+
+#if defined(__cplusplus)
+    // C++17 has no access to C11 atomic objects, and `std::atomic<int>` is a
+    // different type for the link-time optimizer. The object is declared as a
+    // plain `int` and read by the atomic builtins of GCC/Clang instead.
+    /** Atomic severity level shared by C and C++ translation units. */
+    typedef int                 lw_atomic_level_t;
+    /** Relaxed load of an atomic severity level. */
+    #define _LW_LEVEL_LOAD(var) __atomic_load_n(&(var), __ATOMIC_RELAXED)
+#else
+    /** Atomic severity level shared by C and C++ translation units. */
+    typedef atomic_int          lw_atomic_level_t;
+    /** Relaxed load of an atomic severity level. */
+    #define _LW_LEVEL_LOAD(var) atomic_load_explicit(&(var), memory_order_relaxed)
+#endif
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -66,19 +104,64 @@ typedef enum lw_severity_level      lw_severity_level_t;
 struct lw_loggerf
 {
     lw_loggerf_fn_t p_logger;      /**< Pointer to the log output function. */
-    volatile sig_atomic_t level;   /**< Current channel severity level (thread-safe/atomic). */
-    char channel[LOG_CHANNEL_LEN]; /**< Channel name. */
+    lw_atomic_level_t level;       /**< Current channel severity level. */
+    lw_atomic_level_t burst_level; /**< Level of the active burst of the channel, or -1. */
+    lw_atomic_level_t eff_level;   /**< Effective level: the minimum of the global and the channel levels, raised to the burst level. */
+    const char* channel;           /**< Channel name (full, null-terminated). */
 };
 
 /** Pointer to a constant logger structure. */
 typedef const struct lw_loggerf*    lw_loggerf_t;
 
+/**
+ *  \brief  Configuration of the error-triggered verbosity bursts.
+ */
+struct lw_burst_config
+{
+    lw_severity_level_t level;  /**< Level of a channel during a burst (e.g. debug). */
+    uint32_t window_ms;         /**< Duration of a burst in milliseconds. */
+    uint32_t cooldown_ms;       /**< Time after a burst in milliseconds, during which the channel does not burst again. */
+    uint32_t max_active;        /**< Maximum number of channels bursting at once, or 0 for no limit. */
+};
+
+/** Configuration of the error-triggered verbosity bursts. */
+typedef struct lw_burst_config      lw_burst_config_t;
+
+struct lw_channel_token;
+/** Token of an interned channel name (see \ref lw_intern_channel). */
+typedef const struct lw_channel_token*  lw_channel_t;
+
+/**
+ *  \brief  Current global severity level.
+ *
+ *  \details    Exported for the inline level checks of the logging macros,
+ *      which must not cost a function call. The value is -1 while the
+ *      manager is not initialized, so every check fails. Use
+ *      \ref lw_set_global_level to modify the level.
+ */
+extern lw_atomic_level_t lw_g_global_lvl;
+
+/**
+ *  \brief  Level of the channels during a burst, or -1 while the bursts are
+ *      disabled.
+ *
+ *  \details    Exported for the inline check of \ref lw_burst_check. Use
+ *      \ref lw_enable_burst and \ref lw_disable_burst to modify it.
+ */
+extern lw_atomic_level_t lw_g_burst_lvl;
+
 /**
  *  \brief  Checks if logging is allowed for the global level.
  *  \param  lvl - the severity level to check.
  *  \return true if a log of this level should be written, false otherwise.
  */
-bool lw_can_log(int lvl);
+static inline bool lw_can_log(int lvl)
+{
+    if (lvl < 0 || lvl > LVL_TRACE) {
+        return false;
+    }
+    return _LW_LEVEL_LOAD(lw_g_global_lvl) >= lvl;
+}
 
 /**
  *  \brief  Checks if logging is allowed for a specific channel.
@@ -86,7 +169,42 @@ bool lw_can_log(int lvl);
  *  \param  lvl - the severity level to check.
  *  \return true if the channel is active for this level, false otherwise.
  */
-bool lw_can_channel_log(lw_loggerf_t p_logger, int lvl);
+static inline bool lw_can_channel_log(lw_loggerf_t p_logger, int lvl)
+{
+    if (p_logger == NULL) {
+        return false;
+    }
+    if (lvl < 0 || lvl > LVL_TRACE) {
+        return false;
+    }
+    return _LW_LEVEL_LOAD(p_logger->level) >= lvl;
+}
+
+/**
+ *  \brief  Checks if logging is allowed for both the global and the channel
+ *      levels.
+ *  \param  p_logger - pointer to the channel logger.
+ *  \param  lvl - the severity level to check.
+ *  \return true if a log of this level should be written to the channel,
+ *      false otherwise.
+ *
+ *  \details    Equivalent to `lw_can_log(lvl) && lw_can_channel_log(p_logger, lvl)`
+ *      outside of a verbosity burst of the channel, which also permits the
+ *      levels up to the burst level (see \ref lw_enable_burst). Reads only the
+ *      effective level of the channel, which is kept up to date by every
+ *      change of the global, the channel and the burst levels. For a
+ *      constant `lvl` the check is a single relaxed load and a compare.
+ */
+static inline bool lw_is_log_enabled(lw_loggerf_t p_logger, int lvl)
+{
+    if (p_logger == NULL) {
+        return false;
+    }
+    if (lvl < 0 || lvl > LVL_TRACE) {
+        return false;
+    }
+    return _LW_LEVEL_LOAD(p_logger->eff_level) >= lvl;
+}
 
 /**
  *  \brief  Returns a logger by its channel name.
@@ -95,6 +213,10 @@ bool lw_can_channel_log(lw_loggerf_t p_logger, int lvl);
  *      be created.
  *
  *  \details If the channel does not exist and the policy allows, it will be created.
+ *      Each thread caches the loggers of the recently passed name addresses,
+ *      so a repeated call with the same string literal does not search the
+ *      channel table. Names of `LOG_CHANNEL_LEN` characters and longer are
+ *      interned (see \ref lw_intern_channel).
  */
 lw_loggerf_t lw_get_logger(const char* channel);
 
@@ -106,6 +228,36 @@ lw_loggerf_t lw_get_logger(const char* channel);
  */
 lw_loggerf_t lw_get_logger_dfl(const char* channel, lw_severity_level_t dfl_lvl);
 
+/**
+ *  \brief  Interns a channel name and returns its token.
+ *  \param  channel - channel name of any length.
+ *  \return Token of the channel, or NULL if the channel cannot be created.
+ *
+ *  \details    The name is stored and hashed once, and equal names always
+ *      yield the same token until \ref lw_deinit_logging, so tokens may be
+ *      compared by pointer. Names shorter than `LOG_CHANNEL_LEN` resolve to
+ *      the same logger as \ref lw_get_logger, longer names get a logger of
+ *      their own instead of being truncated. The names are stored in memory
+ *      allocated by the manager under either policy.
+ */
+lw_channel_t lw_intern_channel(const char* channel);
+
+/**
+ *  \brief  Returns the logger of an interned channel.
+ *  \param  token - token returned by \ref lw_intern_channel.
+ *  \return Pointer to the logger, or NULL if the token is NULL.
+ *
+ *  \details    Does not search any table: the token refers to the logger.
+ */
+lw_loggerf_t lw_get_interned_logger(lw_channel_t token);
+
+/**
+ *  \brief  Returns the full name of an interned channel.
+ *  \param  token - token returned by \ref lw_intern_channel.
+ *  \return Null-terminated channel name, or NULL if the token is NULL.
+ */
+const char* lw_channel_name(lw_channel_t token);
+
 /**
  *  \brief  Returns the current global severity level.
  *  \return Current level of type \ref lw_severity_level_t.
@@ -146,9 +298,63 @@ bool lw_init_logging(lw_loggerf_fn_t p_logger_fn, lw_logging_policy_t policy,
                      size_t channel_count, lw_severity_level_t dfl_lvl,
                      const char* p_root_ch);
 
+/**
+ *  \brief  Initializes the logging manager with the asynchronous backend.
+ *  \param  fd - file descriptor to write the log to (is not closed by the manager).
+ *  \param  policy - memory management policy (dynamic or fixed).
+ *  \param  channel_count - maximum number of channels (relevant for the \ref fixed_size policy).
+ *  \param  dfl_lvl - default global severity level.
+ *  \param  p_root_ch - name of the root (main) logging channel.
+ *  \return true if initialization is successful, false otherwise.
+ *
+ *  \details    The output function of all channels formats a record in the
+ *      calling thread into a per-thread buffer and enqueues the finished line
+ *      onto a lock-free queue. A dedicated writer thread packs the queued lines
+ *      into large `write(2)` calls. The queue node of a line is taken from a
+ *      per-thread pool and returned to it by the writer without a lock, so a
+ *      logging thread calls `malloc`, which may lock and make a system call,
+ *      only when its pool runs empty or a line does not fit a pooled node
+ *      (about 220 bytes). An idle writer writes the queued lines within
+ *      `LOG_ASYNC_FLUSH_MS` milliseconds; use \ref lw_flush_logging and
+ *      \ref lw_drain_logging to write them earlier.
+ *
+ *  \code
+ *  if (! lw_init_logging_async(STDOUT_FILENO, dynamic_size, 0, info, "Root")) {
+ *      return 1;
+ *  }
+ *  LOGF_INFO(lw_root_logger(), "Hello, %s!", "world");
+ *  lw_deinit_logging(); // Writes all queued lines before returning.
+ *  \endcode
+ */
+bool lw_init_logging_async(int fd, lw_logging_policy_t policy,
+                           size_t channel_count, lw_severity_level_t dfl_lvl,
+                           const char* p_root_ch);
+
+/**
+ *  \brief  Wakes the writer of the asynchronous backend without waiting for it.
+ *
+ *  \details    The lines queued before the call are written as soon as the
+ *      writer thread is scheduled. Does nothing for the synchronous backend.
+ */
+void lw_flush_logging(void);
+
+/**
+ *  \brief  Waits until the lines logged before the call are written.
+ *  \return true if the lines are written without errors (or the backend is
+ *      synchronous), false if a write error occurred since the previous drain.
+ *
+ *  \details    Covers the lines of all threads which were enqueued before
+ *      the call. Blocks the calling thread until the writer thread hands them
+ *      to `write(2)`.
+ */
+bool lw_drain_logging(void);
+
 /**
  *  \brief  Releases the logging manager resources and deinitializes it.
  *  \return true upon successful closure, false otherwise.
+ *
+ *  \details    For the asynchronous backend, writes all queued lines and
+ *      stops the writer thread first.
  */
 bool lw_deinit_logging(void);
 
@@ -180,6 +386,66 @@ void lw_set_immutable_global_level(lw_severity_level_t lvl);
  */
 void lw_set_logger_level(const char* channel, lw_severity_level_t lvl);
 
+/**
+ *  \brief  Enables the error-triggered verbosity bursts.
+ *  \param  p_cfg - configuration of the bursts.
+ *  \return true if the bursts are enabled, false if the configuration is
+ *      invalid or the housekeeping thread cannot be started.
+ *
+ *  \details    When a channel logs a record of the level `error` or more
+ *      severe, the channel writes the records up to `p_cfg->level` for
+ *      `p_cfg->window_ms` milliseconds, whatever the global and the channel
+ *      levels are. The burst level is kept apart from the level of the
+ *      channel, so \ref lw_set_logger_level during a burst takes effect once
+ *      it ends. A housekeeping thread ends the bursts on a timer wheel with
+ *      the resolution of `LOG_BURST_TICK_MS` milliseconds.
+ *
+ *      Later errors do not extend a burst. A channel does not burst again for
+ *      `p_cfg->cooldown_ms` milliseconds after its burst ends, and at most
+ *      `p_cfg->max_active` channels burst at once, so an error storm cannot
+ *      keep channels verbose.
+ *
+ *  \code
+ *  const lw_burst_config_t cfg = {debug, 30000, 300000, 8};
+ *  lw_enable_burst(&cfg);
+ *  \endcode
+ */
+bool lw_enable_burst(const lw_burst_config_t* p_cfg);
+
+/**
+ *  \brief  Disables the error-triggered verbosity bursts and ends the bursts
+ *      of the channels.
+ *
+ *  \details    Stops the housekeeping thread. \ref lw_deinit_logging also
+ *      disables the bursts.
+ */
+void lw_disable_burst(void);
+
+/**
+ *  \brief  Starts a burst of a channel, which has logged an error, if the
+ *      limits permit it.
+ *  \param  p_logger - pointer to the channel logger.
+ *
+ *  \details    Called by the logging macros through \ref lw_burst_check.
+ */
+void lw_burst_trigger(lw_loggerf_t p_logger);
+
+/**
+ *  \brief  Triggers a burst of a channel, which has logged an error, if the
+ *      bursts are enabled.
+ *  \param  p_logger - pointer to the channel logger.
+ *
+ *  \details    The logging macros call it only for the levels `error` and
+ *      more severe. As their level is a constant, the records of the other
+ *      levels do not contain the call at all.
+ */
+static inline void lw_burst_check(lw_loggerf_t p_logger)
+{
+    if (_LW_LEVEL_LOAD(lw_g_burst_lvl) >= 0) {
+        lw_burst_trigger(p_logger);
+    }
+}
+
 /**
  *  \brief  Writes the current high-resolution time into a raw C-string buffer.
  *  \param  buf - pointer to the character array where the date/time will be written.
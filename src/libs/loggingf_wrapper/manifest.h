@@ -0,0 +1,179 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Channel manifests with a build-time minimal perfect hash.
+ *  \ingroup loggingf_wrapper_module
+ *
+ *  \details    A manifest lists the channels of an application, which are
+ *      known at build time. The `ChannelManifest` CMake helper generates from
+ *      it a C source with the tables of a minimal perfect hash and a header
+ *      with constant channel ids. The id of a channel is its slot in the
+ *      table: the 32-bit FNV-1a hash of the name selects a displacement, and
+ *      the displaced hash selects the slot. Names of different channels never
+ *      share a slot, so a lookup is two table loads and one string compare.
+ *
+ *      After \ref lw_register_channel_manifest the loggers of the manifest
+ *      channels are found without searching or locking the channel table,
+ *      and other channels fall back to the table.
+ *
+ *  \code
+ *  # CMakeLists.txt
+ *  ChannelManifest(app_channels MANIFEST channels.manifest)
+ *  ExecTarget(app SOURCES main.c ${app_channels_SOURCES} LIBRARIES loggingf_wrapper)
+ *
+ *  // main.c
+ *  #include "app_channels.h"
+ *
+ *  lw_init_logging(printf, dynamic_size, 0, info, "Root");
+ *  lw_register_channel_manifest(&app_channels);
+ *  lw_loggerf_t net = lw_get_manifest_logger(APP_CHANNELS_NETWORK);
+ *  lw_loggerf_t db = LW_GET_LOGGER("database");
+ *  \endcode
+ */
+
+#ifndef _LIBS_LOGGINGF_WRAPPER_MANIFEST_H_
+#define _LIBS_LOGGINGF_WRAPPER_MANIFEST_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "loggingf_wrapper/manager.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/**
+ *  \brief  Tables of the minimal perfect hash of a channel manifest.
+ *
+ *  \details    Generated by the `ChannelManifest` CMake helper.
+ */
+struct lw_channel_manifest
+{
+    size_t count;                    /**< Number of channels (and slots). */
+    size_t bucket_count;             /**< Number of displacements. */
+    const uint32_t* p_displacements; /**< Displacements of the buckets of hashes. */
+    const char* const* p_names;      /**< Channel names by id. */
+};
+
+typedef struct lw_channel_manifest  lw_channel_manifest_t;
+
+/**
+ *  \brief  Returns the 32-bit FNV-1a hash of a channel name.
+ */
+static inline uint32_t lw_manifest_hash(const char* channel)
+{
+    uint32_t h = 2166136261u;
+    for (; *channel != '\0'; ++channel) {
+        h = (h ^ (unsigned char)*channel) * 16777619u;
+    }
+    return h;
+}
+
+/**
+ *  \brief  Returns the id of the only manifest channel which may have the hash.
+ *  \param  p_manifest - tables of the manifest.
+ *  \param  hash - hash of the name returned by \ref lw_manifest_hash.
+ *
+ *  \details    The displaced hash is finalized by the mixer of
+ *      `lowbias32`. The `ChannelManifest` CMake helper computes the same
+ *      function.
+ */
+static inline size_t lw_manifest_slot(const lw_channel_manifest_t* p_manifest, uint32_t hash)
+{
+    uint32_t x = hash ^ (p_manifest->p_displacements[hash % p_manifest->bucket_count] * 0x9E3779B1u);
+    x = (x ^ (x >> 16)) * 0x045D9F3Bu;
+    x = (x ^ (x >> 16)) * 0x045D9F3Bu;
+    return (x ^ (x >> 16)) % p_manifest->count;
+}
+
+/** \cond */
+#define _LW_MH_1(h, s, i)                                                   \
+    (((h) ^ (uint32_t)(unsigned char)(s)[((i) < sizeof(s) - 1) ? (i) : 0]  \
+          * ((i) < sizeof(s) - 1))                                          \
+     * (((i) < sizeof(s) - 1) ? 16777619u : 1u))
+#define _LW_MH_4(h, s, i)                                                   \
+    _LW_MH_1(_LW_MH_1(_LW_MH_1(_LW_MH_1(h, s, i), s, i + 1), s, i + 2), s, i + 3)
+#define _LW_MH_16(h, s, i)                                                  \
+    _LW_MH_4(_LW_MH_4(_LW_MH_4(_LW_MH_4(h, s, i), s, i + 4), s, i + 8), s, i + 12)
+/** \endcond */
+
+/**
+ *  \def    LW_MANIFEST_HASH(s)
+ *  \brief  Hash of a string literal, computed at compile time.
+ *
+ *  \details    Equal to `lw_manifest_hash(s)`. The hash of a literal of up to
+ *      32 characters is folded by the compiler, longer literals are hashed at
+ *      run time. Arguments other than string literals do not compile.
+ */
+#define LW_MANIFEST_HASH(s)     _LW_MANIFEST_HASH("" s)
+
+/** \cond */
+#define _LW_MANIFEST_HASH(s)                                                \
+    ((sizeof(s) - 1 <= 32) ? (uint32_t)_LW_MH_16(_LW_MH_16(2166136261u, s, 0), s, 16) \
+                           : lw_manifest_hash(s))
+/** \endcond */
+
+/**
+ *  \def    LW_GET_LOGGER(channel)
+ *  \brief  Returns the logger of a channel given by a string literal, with the
+ *      hash of the name computed at compile time.
+ */
+#define LW_GET_LOGGER(channel)  lw_get_logger_hashed(channel, LW_MANIFEST_HASH(channel))
+
+/**
+ *  \brief  Registers the channel manifest of the application.
+ *  \param  p_manifest - tables generated by the `ChannelManifest` CMake helper,
+ *      which must stay valid until \ref lw_deinit_logging.
+ *  \return true if the manifest is registered, false if a manifest is already
+ *      registered, the tables do not match the hash or a channel cannot be
+ *      created.
+ *
+ *  \details    Creates the channels of the manifest, which count against the
+ *      channel limit of the `fixed_size` policy. Loggers returned earlier for
+ *      these channels stay the same.
+ */
+bool lw_register_channel_manifest(const lw_channel_manifest_t* p_manifest);
+
+/**
+ *  \brief  Returns the logger of a manifest channel by its id.
+ *  \param  id - channel id from the generated header.
+ *  \return Pointer to the logger, or NULL if no manifest is registered or the
+ *      id is out of range.
+ */
+lw_loggerf_t lw_get_manifest_logger(size_t id);
+
+/**
+ *  \brief  Returns a logger by its channel name and the hash of the name.
+ *  \param  channel - channel name.
+ *  \param  hash - hash of the name returned by \ref lw_manifest_hash or
+ *      \ref LW_MANIFEST_HASH.
+ *  \return Pointer to the logger, or NULL if the channel cannot be created.
+ *
+ *  \details    A manifest channel is found without hashing the name, other
+ *      channels are passed to \ref lw_get_logger.
+ */
+lw_loggerf_t lw_get_logger_hashed(const char* channel, uint32_t hash);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* _LIBS_LOGGINGF_WRAPPER_MANIFEST_H_ */
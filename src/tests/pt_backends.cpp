@@ -0,0 +1,142 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Backend overhead perftest: no-op backend and the main function.
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Runs an identical workload through every backend adapter of
+ *      `src/examples` that is built (clog, printf, Boost.Log, quill) and
+ *      through a no-op backend. Each workload is measured through the wrapper
+ *      (`logger<T>`, `manager` and the macros) and through direct calls of the
+ *      native backend, so the difference is the overhead of the wrapper.
+ *
+ *  \code{.sh}
+ *  ./build_release/test/pt_backends --iterations=1000000 --repeats=5
+ *  \endcode
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+
+#include "logging_wrapper/logging.h"
+
+#include "pt_backends.h"
+
+namespace {
+
+/**
+ *  \internal
+ *  \brief  Stream which discards everything written into it.
+ */
+struct null_stream final
+{
+    template<typename T>
+    inline null_stream& operator<<(const T& val)
+    {
+        asm volatile("" : : "g"(&val) : "memory");
+        return *this;
+    }
+
+    inline null_stream& operator<<(std::ostream& (*)(std::ostream&)) { return *this; }
+};
+
+/**
+ *  \internal
+ *  \brief  No-op backend: the cost of the wrapper with the built-in layout.
+ */
+struct noop_logger final
+{
+    template<typename T>
+    inline null_stream& operator<<(const T& val) { return stream << val; }
+
+    null_stream stream;
+};
+
+} // <anonymous> namespace
+
+namespace wstux {
+namespace logging {
+
+template<> noop_logger make_logger<noop_logger>(const std::string&) { return noop_logger(); }
+
+} // namespace logging
+} // namespace wstux
+
+namespace {
+
+pt::result bench_noop(const pt::bench_options& opts)
+{
+    using logger_t = ::wstux::logging::logger<noop_logger>;
+
+    ::wstux::logging::manager::init(::wstux::logging::severity_level::info);
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::info);
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+
+    pt::result res;
+    res.backend = "noop";
+    res.wrapped = pt::run(opts, [&logger](size_t i) -> void {
+                                    LOG_INFO(logger, "request " << i << " done in " << 0.25 << " ms, status " << "OK");
+                                });
+    res.native = pt::run(opts, [](size_t i) -> void {
+                                   asm volatile("" : : "g"(i) : "memory");
+                               });
+
+    ::wstux::logging::manager::deinit();
+    return res;
+}
+
+const pt::registrar g_noop_registrar("noop", bench_noop);
+
+} // <anonymous> namespace
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    pt::bench_options opts;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--iterations=", 13) == 0) {
+            opts.iterations = std::strtoull(argv[i] + 13, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--repeats=", 10) == 0) {
+            opts.repeats = std::strtoull(argv[i] + 10, nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--iterations=N] [--repeats=N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (opts.iterations == 0 || opts.repeats == 0) {
+        return 1;
+    }
+
+    std::vector<pt::result> results;
+    for (const std::pair<const char*, pt::bench_fn_t>& backend : pt::registry()) {
+        results.push_back(backend.second(opts));
+    }
+
+    std::printf("%-10s %14s %14s %14s %10s\n", "backend", "wrapped ns", "native ns", "overhead ns", "overhead");
+    for (const pt::result& res : results) {
+        const double overhead = res.wrapped - res.native;
+        std::printf("%-10s %14.1f %14.1f %14.1f %9.1f%%\n", res.backend.c_str(), res.wrapped, res.native,
+                    overhead, (res.native > 0) ? 100.0 * overhead / res.native : 0.0);
+    }
+    return 0;
+}
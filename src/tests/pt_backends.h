@@ -0,0 +1,158 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Common part of the backend overhead perftest.
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Every backend adapter lives in its own translation unit (the
+ *      adapters define different `LOGGING_WRAPPER_IMPL` macros) and registers
+ *      itself through a static \ref pt::registrar. The adapter measures the
+ *      same workload twice: through the wrapper macros and through direct
+ *      calls of the native backend API.
+ */
+
+#ifndef _TESTS_PT_BACKENDS_H_
+#define _TESTS_PT_BACKENDS_H_
+
+#include <sys/time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace pt {
+
+/**
+ *  \internal
+ *  \brief  Workload parameters shared by all backends.
+ */
+struct bench_options final
+{
+    size_t iterations = 200000; ///< Records per measured run.
+    size_t repeats = 5;         ///< Runs per path; the fastest one is reported.
+};
+
+/**
+ *  \internal
+ *  \brief  Measured cost of one backend.
+ */
+struct result final
+{
+    std::string backend; ///< Backend name.
+    double wrapped = 0;  ///< ns per record through the wrapper macros.
+    double native = 0;   ///< ns per record through the native backend API.
+};
+
+/// \internal \brief  Signature of a backend benchmark.
+using bench_fn_t = result (*)(const bench_options&);
+
+/// \internal \brief  Registry of the backends compiled into the perftest.
+inline std::vector<std::pair<const char*, bench_fn_t>>& registry()
+{
+    static std::vector<std::pair<const char*, bench_fn_t>> backends;
+    return backends;
+}
+
+/**
+ *  \internal
+ *  \brief  Registers a backend benchmark during static initialization.
+ */
+struct registrar final
+{
+    registrar(const char* p_name, bench_fn_t fn) { registry().emplace_back(p_name, fn); }
+};
+
+/**
+ *  \internal
+ *  \brief  Runs `fn(i)` for every record and returns the best mean cost.
+ *  \return Nanoseconds per record of the fastest repeat.
+ */
+template<typename TFn>
+double run(const bench_options& opts, TFn&& fn)
+{
+    using clock = std::chrono::steady_clock;
+
+    double best = 0;
+    for (size_t r = 0; r < opts.repeats; ++r) {
+        const clock::time_point start = clock::now();
+        for (size_t i = 0; i < opts.iterations; ++i) {
+            fn(i);
+        }
+        const clock::time_point stop = clock::now();
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()
+                        / (double)opts.iterations;
+        best = (r == 0) ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+/**
+ *  \internal
+ *  \brief  Redirects the standard output into `/dev/null` for its lifetime.
+ */
+class stdout_to_null final
+{
+public:
+    stdout_to_null()
+    {
+        std::fflush(stdout);
+        m_saved_fd = dup(STDOUT_FILENO);
+        const int null_fd = open("/dev/null", O_WRONLY);
+        dup2(null_fd, STDOUT_FILENO);
+        close(null_fd);
+    }
+
+    ~stdout_to_null()
+    {
+        std::fflush(stdout);
+        dup2(m_saved_fd, STDOUT_FILENO);
+        close(m_saved_fd);
+    }
+
+    stdout_to_null(const stdout_to_null&) = delete;
+    stdout_to_null& operator=(const stdout_to_null&) = delete;
+
+private:
+    int m_saved_fd;
+};
+
+/**
+ *  \internal
+ *  \brief  Timestamp of the native paths, same format as the wrapper's one.
+ */
+inline void timestamp(char* buf, size_t size)
+{
+    struct timeval cur_tv;
+    struct tm cur_tm;
+    gettimeofday(&cur_tv, NULL);
+    localtime_r(&cur_tv.tv_sec, &cur_tm);
+    std::snprintf(buf, size, "%04d-%02d-%02d %02d:%02d:%02d.%03d",
+                  cur_tm.tm_year + 1900, cur_tm.tm_mon + 1, cur_tm.tm_mday,
+                  cur_tm.tm_hour, cur_tm.tm_min, cur_tm.tm_sec, (int)(cur_tv.tv_usec / 1000));
+}
+
+} // namespace pt
+
+#endif /* _TESTS_PT_BACKENDS_H_ */
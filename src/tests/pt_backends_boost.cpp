@@ -0,0 +1,94 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Backend overhead perftest: Boost.Log adapter (see `src/examples/logging_boost`).
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Compiled only if the `boost` external target is built.
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include <boost/log/expressions.hpp>
+#include <boost/log/sources/record_ostream.hpp>
+#include <boost/log/sources/severity_channel_logger.hpp>
+#include <boost/log/utility/setup/console.hpp>
+
+#define LOGGING_WRAPPER_IMPL(logger, level)                                    \
+    BOOST_LOG_SEV(logger.get_logger(), SEVERITY_LEVEL(level))
+
+#include "logging_wrapper/logging.h"
+
+#include "pt_backends.h"
+
+namespace wstux {
+namespace logging {
+
+using boost_logger_t = boost::log::sources::severity_channel_logger_mt<::wstux::logging::severity_level>;
+
+template<> boost_logger_t make_logger<boost_logger_t>(const std::string& ch)
+{
+    return boost_logger_t(boost::log::keywords::channel = ch);
+}
+
+BOOST_LOG_ATTRIBUTE_KEYWORD(pt_channel, "Channel", std::string)
+
+} // namespace logging
+} // namespace wstux
+
+namespace {
+
+std::ofstream g_null_sink("/dev/null"); ///< Sink of the Boost.Log console backend.
+
+pt::result bench_boost(const pt::bench_options& opts)
+{
+    namespace exprs = boost::log::expressions;
+    namespace keywords = boost::log::keywords;
+    using boost_logger_t = ::wstux::logging::boost_logger_t;
+    using logger_t = ::wstux::logging::logger<boost_logger_t>;
+
+    boost::log::add_console_log(
+        g_null_sink,
+        keywords::format = (exprs::stream << "<" << ::wstux::logging::pt_channel << "> " << exprs::message));
+
+    ::wstux::logging::manager::init(::wstux::logging::severity_level::info);
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::info);
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+    boost_logger_t native_logger(keywords::channel = "Root");
+
+    pt::result res;
+    res.backend = "boost";
+    res.wrapped = pt::run(opts, [&logger](size_t i) -> void {
+                                    LOG_INFO(logger, "request " << i << " done in " << 0.25 << " ms, status " << "OK");
+                                });
+    res.native = pt::run(opts, [&native_logger](size_t i) -> void {
+                                   BOOST_LOG_SEV(native_logger, ::wstux::logging::severity_level::info)
+                                       << "request " << i << " done in " << 0.25 << " ms, status " << "OK"
+                                       << std::endl;
+                               });
+
+    ::wstux::logging::manager::deinit();
+    boost::log::core::get()->remove_all_sinks();
+    return res;
+}
+
+const pt::registrar g_boost_registrar("boost", bench_boost);
+
+} // <anonymous> namespace
@@ -0,0 +1,85 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Backend overhead perftest: `std::clog` adapter (see `src/examples/logging_clog`).
+ *  \ingroup    logging_perftests
+ */
+
+#include <fstream>
+#include <iostream>
+
+#define LOGGING_WRAPPER_IMPL(logger, level)                                    \
+    logger.get_logger() << ::wstux::logging::manager::timestamp() << " "       \
+                        << LOG_LEVEL(level) << " " << logger.channel() << ": "
+
+#include "logging_wrapper/logging.h"
+
+#include "pt_backends.h"
+
+namespace {
+
+struct clog_logger final
+{
+    template <typename T>
+    inline std::ostream& operator<<(const T& val) { return std::clog << val; }
+};
+
+} // <anonymous> namespace
+
+namespace wstux {
+namespace logging {
+
+template<> clog_logger make_logger<clog_logger>(const std::string&) { return clog_logger(); }
+
+} // namespace logging
+} // namespace wstux
+
+namespace {
+
+pt::result bench_clog(const pt::bench_options& opts)
+{
+    using logger_t = ::wstux::logging::logger<clog_logger>;
+
+    std::ofstream null_sink("/dev/null");
+    std::streambuf* p_clog_buf = std::clog.rdbuf(null_sink.rdbuf());
+
+    ::wstux::logging::manager::init(::wstux::logging::severity_level::info);
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::info);
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+
+    pt::result res;
+    res.backend = "clog";
+    res.wrapped = pt::run(opts, [&logger](size_t i) -> void {
+                                    LOG_INFO(logger, "request " << i << " done in " << 0.25 << " ms, status " << "OK");
+                                });
+    res.native = pt::run(opts, [](size_t i) -> void {
+                                   char cur_ts[24];
+                                   pt::timestamp(cur_ts, sizeof(cur_ts));
+                                   std::clog << cur_ts << " [INFO ] Root: request " << i << " done in " << 0.25
+                                             << " ms, status " << "OK" << std::endl;
+                               });
+
+    ::wstux::logging::manager::deinit();
+    std::clog.rdbuf(p_clog_buf);
+    return res;
+}
+
+const pt::registrar g_clog_registrar("clog", bench_clog);
+
+} // <anonymous> namespace
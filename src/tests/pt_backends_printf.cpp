@@ -0,0 +1,91 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Backend overhead perftest: `printf` adapter (see `src/examples/logging_printf`).
+ *  \ingroup    logging_perftests
+ */
+
+#include <cstdarg>
+#include <cstdio>
+
+#define LOGGINGF_WRAPPER_IMPL(logger, level, fmt, ...)                         \
+    char cur_ts[24];                                                           \
+    ::wstux::logging::manager::timestamp(cur_ts, 24);                          \
+    logger.get_logger()("%s " LOGF_LEVEL(level) " %s: " fmt "\n",              \
+                        cur_ts, logger.channel().c_str() __VA_OPT__(,) __VA_ARGS__)
+
+#include "logging_wrapper/logging.h"
+
+#include "pt_backends.h"
+
+namespace {
+
+struct printf_logger final
+{
+    int operator()(const char* p_fmt, ...)
+    {
+        va_list args;
+        va_start(args, p_fmt);
+        const int rc = vprintf(p_fmt, args);
+        va_end(args);
+        return rc;
+    }
+};
+
+} // <anonymous> namespace
+
+namespace wstux {
+namespace logging {
+
+template<> printf_logger make_logger<printf_logger>(const std::string&) { return printf_logger(); }
+
+} // namespace logging
+} // namespace wstux
+
+namespace {
+
+pt::result bench_printf(const pt::bench_options& opts)
+{
+    using logger_t = ::wstux::logging::logger<printf_logger>;
+
+    pt::stdout_to_null redirect;
+
+    ::wstux::logging::manager::init(::wstux::logging::severity_level::info);
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::info);
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+
+    pt::result res;
+    res.backend = "printf";
+    res.wrapped = pt::run(opts, [&logger](size_t i) -> void {
+                                    LOGF_INFO(logger, "request %zu done in %g ms, status %s", i, 0.25, "OK");
+                                });
+    res.native = pt::run(opts, [](size_t i) -> void {
+                                   char cur_ts[24];
+                                   pt::timestamp(cur_ts, sizeof(cur_ts));
+                                   printf("%s [INFO ] Root: request %zu done in %g ms, status %s\n",
+                                          cur_ts, i, 0.25, "OK");
+                               });
+
+    ::wstux::logging::manager::deinit();
+    return res;
+}
+
+const pt::registrar g_printf_registrar("printf", bench_printf);
+
+} // <anonymous> namespace
@@ -0,0 +1,119 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Backend overhead perftest: quill adapter (see `src/examples/logging_quill`).
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Compiled only if the `quill` external target is built. Quill
+ *      formats on its backend thread, so both paths measure the cost of the
+ *      frontend (caller) thread only.
+ */
+
+#include <memory>
+#include <vector>
+
+#define QUILL_DISABLE_NON_PREFIXED_MACROS
+
+#include <quill/Backend.h>
+#include <quill/Frontend.h>
+#include <quill/LogFunctions.h>
+#include <quill/LogMacros.h>
+#include <quill/Logger.h>
+#include <quill/sinks/FileSink.h>
+
+#define LOGGINGF_WRAPPER_IMPL(logger, level, fmt, ...)                         \
+    quill::log((logger).get_logger(),                                          \
+               "",                                                             \
+               ::wstux::logging::to_qlevel(SEVERITY_LEVEL(level)),             \
+               fmt,                                                            \
+               quill::SourceLocation::current()                                \
+               __VA_OPT__(,) __VA_ARGS__)
+
+#include "logging_wrapper/logging.h"
+
+#include "pt_backends.h"
+
+namespace wstux {
+namespace logging {
+
+using quill_logger_t = quill::Logger*;
+
+constexpr quill::LogLevel to_qlevel(severity_level lvl)
+{
+    switch (lvl)
+    {
+        case severity_level::emerg:     return quill::LogLevel::Critical;
+        case severity_level::fatal:     return quill::LogLevel::Critical;
+        case severity_level::crit:      return quill::LogLevel::Critical;
+        case severity_level::error:     return quill::LogLevel::Error;
+        case severity_level::warning:   return quill::LogLevel::Warning;
+        case severity_level::notice:    return quill::LogLevel::Notice;
+        case severity_level::info:      return quill::LogLevel::Info;
+        case severity_level::debug:     return quill::LogLevel::Debug;
+        case severity_level::trace:     return quill::LogLevel::TraceL1;
+        default:                        return quill::LogLevel::Info;
+    }
+}
+
+std::shared_ptr<quill::Sink> g_pt_quill_sink; ///< `/dev/null` file sink shared by all channels.
+
+template<> quill_logger_t make_logger<quill_logger_t>(const std::string& ch)
+{
+    return quill::Frontend::create_or_get_logger(ch, {g_pt_quill_sink});
+}
+
+} // namespace logging
+} // namespace wstux
+
+namespace {
+
+pt::result bench_quill(const pt::bench_options& opts)
+{
+    using logger_t = ::wstux::logging::logger<::wstux::logging::quill_logger_t>;
+
+    quill::Backend::start(quill::BackendOptions());
+    quill::FileSinkConfig sink_config;
+    sink_config.set_open_mode('w');
+    ::wstux::logging::g_pt_quill_sink =
+        quill::Frontend::create_or_get_sink<quill::FileSink>("/dev/null", sink_config, quill::FileEventNotifier{});
+
+    ::wstux::logging::manager::init(::wstux::logging::severity_level::info);
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::info);
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+    quill::Logger* p_native_logger = quill::Frontend::create_or_get_logger("Native", {::wstux::logging::g_pt_quill_sink});
+
+    pt::result res;
+    res.backend = "quill";
+    res.wrapped = pt::run(opts, [&logger](size_t i) -> void {
+                                    LOGF_INFO(logger, "request {} done in {} ms, status {}", i, 0.25, "OK");
+                                });
+    logger.get_logger()->flush_log();
+    res.native = pt::run(opts, [p_native_logger](size_t i) -> void {
+                                   QUILL_LOG_INFO(p_native_logger, "request {} done in {} ms, status {}", i, 0.25, "OK");
+                               });
+    p_native_logger->flush_log();
+
+    ::wstux::logging::manager::deinit();
+    quill::Backend::stop();
+    return res;
+}
+
+const pt::registrar g_quill_registrar("quill", bench_quill);
+
+} // <anonymous> namespace
@@ -0,0 +1,128 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  String escaping perftest of the JSON and logfmt renderers.
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Escapes strings of several lengths, without special characters
+ *      and with one special character per 64 bytes, by the selected vectorized
+ *      implementation and by the byte-by-byte reference, and prints the
+ *      throughput of both. The logfmt quoting check is measured on the clean
+ *      strings.
+ *
+ *  \code{.sh}
+ *  ./build_release/test/pt_escape --bytes=268435456
+ *  \endcode
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "logging_wrapper/details/escape.h"
+
+namespace {
+
+namespace details = ::wstux::logging::details;
+
+/**
+ *  \internal
+ *  \brief  Runs a function over the string until `bytes` bytes are processed.
+ *  \return Throughput in MB/s.
+ */
+template<typename TFn>
+double run(const std::string& str, size_t bytes, TFn fn)
+{
+    const size_t iterations = (bytes + str.size() - 1) / str.size();
+    size_t total = 0;
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        total += fn(str);
+    }
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    if (total == 0) {
+        std::fprintf(stderr, "no output\n");
+    }
+    const double sec = std::chrono::duration<double>(end - begin).count();
+    return (double)(iterations * str.size()) / sec / 1e6;
+}
+
+void run_string(const char* p_kind, const std::string& str, size_t bytes)
+{
+    static char buf[16 * 1024];
+    const double simd = run(str, bytes, [](const std::string& s) -> size_t {
+                                wstux::logging::text_buffer out(buf);
+                                details::put_escaped(out, s);
+                                return out.size();
+                            });
+    const double scalar = run(str, bytes, [](const std::string& s) -> size_t {
+                                  wstux::logging::text_buffer out(buf);
+                                  details::put_escaped_scalar(out, s);
+                                  return out.size();
+                              });
+    const double quotes = run(str, bytes, [](const std::string& s) -> size_t {
+                                  return details::needs_logfmt_quotes(s) ? 1 : s.size();
+                              });
+    const double quotes_scalar = run(str, bytes, [](const std::string& s) -> size_t {
+                                         return details::needs_logfmt_quotes_scalar(s) ? 1 : s.size();
+                                     });
+    std::printf("%-8s %6zu %12.0f %12.0f %12.0f %12.0f\n", p_kind, str.size(), simd, scalar, quotes, quotes_scalar);
+}
+
+} // <anonymous> namespace
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    size_t bytes = 64 * 1024 * 1024;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--bytes=", 8) == 0) {
+            bytes = std::strtoull(argv[i] + 8, nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--bytes=N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (bytes == 0) {
+        return 1;
+    }
+
+    std::printf("implementation: %s\n", details::escape_impl_name());
+    std::printf("%-8s %6s %12s %12s %12s %12s\n", "string", "length", "escape MB/s", "scalar MB/s",
+                "quote MB/s", "scalar MB/s");
+    for (size_t len : {16, 64, 256, 1024, 4096}) {
+        std::string clean(len, 'a');
+        for (size_t i = 0; i < len; ++i) {
+            clean[i] = (char)('a' + i % 26);
+        }
+        std::string sparse = clean;
+        for (size_t i = 63; i < len; i += 64) {
+            sparse[i] = '"';
+        }
+        run_string("clean", clean, bytes);
+        run_string("sparse", sparse, bytes);
+    }
+    return 0;
+}
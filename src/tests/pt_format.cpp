@@ -0,0 +1,127 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Number formatting perftest.
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Converts the same random integers and doubles to text by the
+ *      formatter of the library, by `snprintf` and by `std::ostringstream`, and
+ *      prints the mean cost of a conversion. `snprintf` prints doubles with
+ *      `%.17g`, the shortest precision which always reads back to the same
+ *      value, so the texts are longer than the shortest ones.
+ *
+ *  \code{.sh}
+ *  ./build_release/test/pt_format --iterations=1000000
+ *  \endcode
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "logging_wrapper/format.h"
+
+namespace {
+
+/**
+ *  \internal
+ *  \brief  Runs a conversion of all values.
+ *  \return Mean wall time of a conversion in nanoseconds.
+ */
+template<typename TValue, typename TFn>
+double run(const std::vector<TValue>& values, TFn fn)
+{
+    size_t total_len = 0;
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    for (const TValue& value : values) {
+        total_len += fn(value);
+    }
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    if (total_len == 0) {
+        std::fprintf(stderr, "no text\n");
+    }
+    return std::chrono::duration<double, std::nano>(end - begin).count() / values.size();
+}
+
+template<typename TValue>
+void run_type(const char* p_type, const std::vector<TValue>& values, const char* p_fmt)
+{
+    char buf[64];
+    std::ostringstream stream;
+    stream.precision(17);
+
+    const double lw_ns = run(values, [&](TValue value) -> size_t {
+                                 wstux::logging::text_buffer text(buf);
+                                 text << value;
+                                 return text.size();
+                             });
+    const double printf_ns = run(values, [&](TValue value) -> size_t {
+                                     return (size_t)std::snprintf(buf, sizeof(buf), p_fmt, value);
+                                 });
+    const double stream_ns = run(values, [&](TValue value) -> size_t {
+                                     stream.str(std::string());
+                                     stream << value;
+                                     return (size_t)stream.tellp();
+                                 });
+    std::printf("%-8s %14.1f %14.1f %14.1f\n", p_type, lw_ns, printf_ns, stream_ns);
+}
+
+} // <anonymous> namespace
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    size_t iterations = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--iterations=", 13) == 0) {
+            iterations = std::strtoull(argv[i] + 13, nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--iterations=N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        return 1;
+    }
+
+    std::mt19937_64 rng(42);
+    std::vector<long long> ints(iterations);
+    std::vector<double> doubles(iterations);
+    std::vector<double> decimals(iterations);
+    for (size_t i = 0; i < iterations; ++i) {
+        ints[i] = (long long)(rng() >> (rng() % 64));
+        doubles[i] = std::ldexp((double)(rng() >> 11), (int)(rng() % 128) - 117);
+        decimals[i] = (double)(rng() % 1000000) / 1000;
+    }
+
+    std::printf("%-8s %14s %14s %14s\n", "type", "lw ns", "snprintf ns", "ostream ns");
+    run_type("int", ints, "%lld");
+    run_type("double", doubles, "%.17g");
+    run_type("decimal", decimals, "%.17g");
+    return 0;
+}
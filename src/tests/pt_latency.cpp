@@ -0,0 +1,160 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Tail-latency perftest of the built-in backend modes.
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Measures the latency of every individual log call of the C++
+ *      (`LOG_*`, `LOGF_*`) and C (`LOGF_*` with the `fixed_size` and
+ *      `dynamic_size` policies) wrappers while background threads write to the
+ *      filesystem of the log sink. Prints the percentile distribution and the
+ *      maximum for each mode.
+ *
+ *  \code{.sh}
+ *  ./build_release/test/pt_latency --iterations=500000 --io-threads=2 --dir=/var/tmp --perf
+ *  \endcode
+ */
+
+#include <cstdarg>
+#include <cstdio>
+#include <fstream>
+
+#include "logging_wrapper/logging.h"
+
+#include "pt_latency.h"
+
+/**
+ *  \internal
+ *  \brief  Runs the modes of the C wrapper (see pt_latency_loggingf.cpp).
+ */
+void run_loggingf_modes(const pt::options& opts, double tpns);
+
+namespace {
+
+std::ofstream g_stream_sink; ///< Sink of the stream-based backend.
+FILE* g_file_sink = nullptr; ///< Sink of the printf-like backend.
+
+/**
+ *  \internal
+ *  \brief  Stream-based backend writing into a file.
+ */
+struct file_logger final
+{
+    template <typename T>
+    inline std::ostream& operator<<(const T& val) { return g_stream_sink << val; }
+};
+
+/**
+ *  \internal
+ *  \brief  Printf-like backend writing into a file.
+ */
+struct file_loggerf final
+{
+    int operator()(const char* p_fmt, ...)
+    {
+        va_list args;
+        va_start(args, p_fmt);
+        const int rc = vfprintf(g_file_sink, p_fmt, args);
+        va_end(args);
+        return rc;
+    }
+};
+
+} // <anonymous> namespace
+
+namespace wstux {
+namespace logging {
+
+template<> file_logger make_logger<file_logger>(const std::string&) { return file_logger(); }
+template<> file_loggerf make_logger<file_loggerf>(const std::string&) { return file_loggerf(); }
+
+} // namespace logging
+} // namespace wstux
+
+namespace {
+
+void run_logging_modes(const pt::options& opts, double tpns)
+{
+    using logger_t = ::wstux::logging::logger<file_logger>;
+    using loggerf_t = ::wstux::logging::logger<file_loggerf>;
+
+    const std::string path = opts.dir + "/pt_latency.log";
+    g_stream_sink.open(path, std::ios::out | std::ios::trunc);
+    g_file_sink = fopen(path.c_str(), "a");
+    if (! g_stream_sink.is_open() || g_file_sink == nullptr) {
+        std::perror(path.c_str());
+        return;
+    }
+
+    ::wstux::logging::manager::init(::wstux::logging::severity_level::info);
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::info);
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Stream");
+    loggerf_t loggerf = ::wstux::logging::manager::get_logger<loggerf_t>("Format");
+
+    pt::samples s = pt::measure(opts, [&logger](size_t i) -> void {
+                                          LOG_INFO(logger, "request " << i << " done in " << 0.25 << " ms");
+                                      });
+    pt::report("cpp LOG_INFO", s, tpns);
+
+    s = pt::measure(opts, [&loggerf](size_t i) -> void {
+                              LOGF_INFO(loggerf, "request %zu done in %f ms", i, 0.25);
+                          });
+    pt::report("cpp LOGF_INFO", s, tpns);
+
+    s = pt::measure(opts, [&logger](size_t i) -> void {
+                              LOG_DEBUG(logger, "request " << i << " done in " << 0.25 << " ms");
+                          });
+    pt::report("cpp LOG_DEBUG (off)", s, tpns);
+
+    ::wstux::logging::manager::deinit();
+    fclose(g_file_sink);
+    g_file_sink = nullptr;
+    g_stream_sink.close();
+    std::remove(path.c_str());
+}
+
+} // <anonymous> namespace
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    pt::options opts;
+    if (! opts.parse(argc, argv)) {
+        pt::options::usage(argv[0]);
+        return 1;
+    }
+
+    const double tpns = pt::ticks_per_ns();
+    std::printf("iterations: %zu, io threads: %zu, io block: %zu bytes, dir: '%s', ticks/ns: %.3f\n",
+                opts.iterations, opts.io_threads, opts.io_block, opts.dir.c_str(), tpns);
+
+    pt::io_pressure pressure(opts);
+    pressure.start();
+
+    pt::print_header();
+    run_logging_modes(opts, tpns);
+    run_loggingf_modes(opts, tpns);
+
+    pressure.stop();
+    std::printf("background bytes written: %llu\n", (unsigned long long)pressure.bytes_written());
+    return 0;
+}
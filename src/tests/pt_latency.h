@@ -0,0 +1,405 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Tail-latency measurement harness shared by the latency perftests.
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Every individual log call is timestamped with the time stamp
+ *      counter (`rdtsc` on x86, `steady_clock` elsewhere). Optionally, the
+ *      cycle and instruction counters of the calling thread are sampled around
+ *      each call via `perf_event_open`. While the measurement runs, a
+ *      configurable number of background writer threads put the filesystem of
+ *      the log sink under pressure.
+ */
+
+#ifndef _TESTS_PT_LATENCY_H_
+#define _TESTS_PT_LATENCY_H_
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+namespace pt {
+
+/**
+ *  \internal
+ *  \brief  Command line options of the latency harness.
+ */
+struct options final
+{
+    size_t iterations = 200000;     ///< Number of measured log calls per mode.
+    size_t warmup = 10000;          ///< Number of unmeasured log calls per mode.
+    size_t io_threads = 1;          ///< Number of background writer threads.
+    size_t io_block = 1 << 20;      ///< Size of a single background write, in bytes.
+    size_t io_sync_every = 16;      ///< Background writer calls `fdatasync` every N blocks.
+    std::string dir = ".";          ///< Directory for the log sink and the pressure files.
+    bool perf_counters = false;     ///< Sample cycle/instruction counters per call.
+
+    /// \brief  Parses `--key=value` command line arguments.
+    /// \return false on unknown or malformed arguments.
+    bool parse(int argc, char** argv)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const size_t eq = arg.find('=');
+            const std::string key = arg.substr(0, eq);
+            const std::string val = (eq == std::string::npos) ? std::string() : arg.substr(eq + 1);
+            if (key == "--iterations") {
+                iterations = std::strtoull(val.c_str(), nullptr, 10);
+            } else if (key == "--warmup") {
+                warmup = std::strtoull(val.c_str(), nullptr, 10);
+            } else if (key == "--io-threads") {
+                io_threads = std::strtoull(val.c_str(), nullptr, 10);
+            } else if (key == "--io-block") {
+                io_block = std::strtoull(val.c_str(), nullptr, 10);
+            } else if (key == "--io-sync-every") {
+                io_sync_every = std::strtoull(val.c_str(), nullptr, 10);
+            } else if (key == "--dir") {
+                dir = val;
+            } else if (key == "--perf") {
+                perf_counters = true;
+            } else {
+                return false;
+            }
+        }
+        return iterations > 0 && io_block > 0;
+    }
+
+    /// \brief  Prints the usage string.
+    static void usage(const char* p_name)
+    {
+        std::fprintf(stderr, "Usage: %s [--iterations=N] [--warmup=N] [--io-threads=N] "
+                             "[--io-block=BYTES] [--io-sync-every=N] [--dir=PATH] [--perf]\n", p_name);
+    }
+};
+
+/**
+ *  \internal
+ *  \brief  Reads the time stamp counter.
+ *  \details    The `lfence` instructions prevent the measured code from being
+ *      reordered around the counter read.
+ */
+inline uint64_t ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    const uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ *  \internal
+ *  \brief  Calibrates the number of ticks per nanosecond.
+ */
+inline double ticks_per_ns()
+{
+    using clock = std::chrono::steady_clock;
+
+    const clock::time_point c0 = clock::now();
+    const uint64_t t0 = ticks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    const uint64_t t1 = ticks();
+    const clock::time_point c1 = clock::now();
+
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(c1 - c0).count();
+    return (ns > 0) ? (double)(t1 - t0) / ns : 1.0;
+}
+
+/**
+ *  \internal
+ *  \brief  Per-thread cycle and instruction counters (`perf_event_open`).
+ *
+ *  \details    The counters are opened as one group, so both values are read
+ *      with a single `read` call. If the kernel denies access (for example,
+ *      because of `perf_event_paranoid`), the counters stay disabled.
+ */
+class perf_counters final
+{
+public:
+    perf_counters() = default;
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    ~perf_counters()
+    {
+        if (m_instr_fd >= 0) { close(m_instr_fd); }
+        if (m_cycles_fd >= 0) { close(m_cycles_fd); }
+    }
+
+    bool open()
+    {
+        m_cycles_fd = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (m_cycles_fd < 0) {
+            return false;
+        }
+        m_instr_fd = open_counter(PERF_COUNT_HW_INSTRUCTIONS, m_cycles_fd);
+        if (m_instr_fd < 0) {
+            close(m_cycles_fd);
+            m_cycles_fd = -1;
+            return false;
+        }
+        ioctl(m_cycles_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_cycles_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return true;
+    }
+
+    bool is_open() const { return m_cycles_fd >= 0; }
+
+    /// \brief  Reads the current counter values.
+    /// \param  cycles - output value of the cycle counter.
+    /// \param  instr - output value of the instruction counter.
+    void read(uint64_t& cycles, uint64_t& instr) const
+    {
+        uint64_t values[3] = {0, 0, 0}; // nr, cycles, instructions
+        if (::read(m_cycles_fd, values, sizeof(values)) == (ssize_t)sizeof(values)) {
+            cycles = values[1];
+            instr = values[2];
+        } else {
+            cycles = instr = 0;
+        }
+    }
+
+private:
+    static int open_counter(uint64_t config, int group_fd)
+    {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = (group_fd < 0) ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+    }
+
+private:
+    int m_cycles_fd = -1;
+    int m_instr_fd = -1;
+};
+
+/**
+ *  \internal
+ *  \brief  Background disk pressure generator.
+ *
+ *  \details    Each thread repeatedly writes blocks of `io_block` bytes into
+ *      its own file in the sink directory and periodically calls `fdatasync`,
+ *      which keeps the page cache writeback and the journal of the same
+ *      filesystem busy while the log calls are measured.
+ */
+class io_pressure final
+{
+public:
+    explicit io_pressure(const options& opts)
+        : m_opts(opts)
+    {}
+
+    io_pressure(const io_pressure&) = delete;
+    io_pressure& operator=(const io_pressure&) = delete;
+
+    ~io_pressure() { stop(); }
+
+    void start()
+    {
+        m_is_running = true;
+        for (size_t i = 0; i < m_opts.io_threads; ++i) {
+            m_threads.emplace_back([this, i]() -> void { run(i); });
+        }
+    }
+
+    void stop()
+    {
+        m_is_running = false;
+        for (std::thread& t : m_threads) {
+            t.join();
+        }
+        m_threads.clear();
+    }
+
+    /// \brief  Total number of bytes written by all pressure threads.
+    uint64_t bytes_written() const { return m_bytes; }
+
+private:
+    void run(size_t idx)
+    {
+        const std::string path = m_opts.dir + "/pt_latency_io." + std::to_string(idx);
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            std::perror(path.c_str());
+            return;
+        }
+        std::vector<char> block(m_opts.io_block, 'x');
+        const off_t max_size = (off_t)m_opts.io_block * 256;
+        size_t count = 0;
+        while (m_is_running) {
+            const ssize_t rc = ::write(fd, block.data(), block.size());
+            if (rc > 0) {
+                m_bytes += (uint64_t)rc;
+            }
+            if (m_opts.io_sync_every != 0 && (++count % m_opts.io_sync_every) == 0) {
+                fdatasync(fd);
+            }
+            if (lseek(fd, 0, SEEK_CUR) >= max_size) {
+                lseek(fd, 0, SEEK_SET);
+            }
+        }
+        close(fd);
+        unlink(path.c_str());
+    }
+
+private:
+    const options& m_opts;
+    std::atomic_bool m_is_running = {false};
+    std::atomic<uint64_t> m_bytes = {0};
+    std::vector<std::thread> m_threads;
+};
+
+/**
+ *  \internal
+ *  \brief  Raw samples collected for one backend mode.
+ */
+struct samples final
+{
+    std::vector<uint64_t> ticks;  ///< Duration of every call, in ticks.
+    std::vector<uint64_t> cycles; ///< Cycles per call (empty if counters are disabled).
+    std::vector<uint64_t> instr;  ///< Instructions per call (empty if counters are disabled).
+};
+
+/**
+ *  \internal
+ *  \brief  Invokes `fn(i)` for every iteration and records per-call samples.
+ *  \tparam TFn - callable performing exactly one log call.
+ */
+template<typename TFn>
+samples measure(const options& opts, TFn&& fn)
+{
+    for (size_t i = 0; i < opts.warmup; ++i) {
+        fn(i);
+    }
+
+    perf_counters counters;
+    const bool use_counters = opts.perf_counters && counters.open();
+
+    samples s;
+    s.ticks.resize(opts.iterations);
+    if (use_counters) {
+        s.cycles.resize(opts.iterations);
+        s.instr.resize(opts.iterations);
+    }
+    for (size_t i = 0; i < opts.iterations; ++i) {
+        uint64_t c0 = 0, i0 = 0, c1 = 0, i1 = 0;
+        if (use_counters) {
+            counters.read(c0, i0);
+        }
+        const uint64_t t0 = ticks();
+        fn(i);
+        const uint64_t t1 = ticks();
+        if (use_counters) {
+            counters.read(c1, i1);
+            s.cycles[i] = c1 - c0;
+            s.instr[i] = i1 - i0;
+        }
+        s.ticks[i] = t1 - t0;
+    }
+    return s;
+}
+
+/**
+ *  \internal
+ *  \brief  Returns the value at the given percentile of a sorted sample set.
+ */
+inline uint64_t percentile(const std::vector<uint64_t>& sorted, double pct)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t idx = (size_t)((pct / 100.0) * (double)(sorted.size() - 1) + 0.5);
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+/// \internal \brief  Percentiles reported for every mode.
+constexpr double report_percentiles[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+
+/// \internal \brief  Prints the report table header.
+inline void print_header()
+{
+    std::printf("%-24s %-6s %10s", "mode", "unit", "min");
+    for (double p : report_percentiles) {
+        char name[16];
+        std::snprintf(name, sizeof(name), "p%g", p);
+        std::printf(" %10s", name);
+    }
+    std::printf(" %10s\n", "max");
+}
+
+/// \internal \brief  Prints one line of the distribution.
+inline void print_row(const char* p_mode, const char* p_unit, std::vector<uint64_t>& values, double scale)
+{
+    if (values.empty()) {
+        return;
+    }
+    std::sort(values.begin(), values.end());
+    std::printf("%-24s %-6s %10.0f", p_mode, p_unit, (double)values.front() / scale);
+    for (double p : report_percentiles) {
+        std::printf(" %10.0f", (double)percentile(values, p) / scale);
+    }
+    std::printf(" %10.0f\n", (double)values.back() / scale);
+}
+
+/**
+ *  \internal
+ *  \brief  Prints the full latency distribution of a mode.
+ *  \param  p_mode - name of the backend mode.
+ *  \param  s - collected samples (sorted in place).
+ *  \param  tpns - calibrated ticks per nanosecond.
+ */
+inline void report(const char* p_mode, samples& s, double tpns)
+{
+    print_row(p_mode, "ns", s.ticks, tpns);
+    print_row(p_mode, "cycles", s.cycles, 1.0);
+    print_row(p_mode, "instr", s.instr, 1.0);
+    std::fflush(stdout);
+}
+
+} // namespace pt
+
+#endif /* _TESTS_PT_LATENCY_H_ */
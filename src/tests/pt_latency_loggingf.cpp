@@ -0,0 +1,100 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Tail-latency perftest modes of the C wrapper.
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Kept in a separate translation unit, because the C and C++
+ *      wrappers define macros with the same names. The synchronous modes write
+ *      through `stdio`, the asynchronous one through the writer thread of the
+ *      manager; all of them write to the same file.
+ */
+
+#include <cstdarg>
+#include <cstdio>
+
+#include "loggingf_wrapper/logging.h"
+
+#include "pt_latency.h"
+
+namespace {
+
+FILE* g_sink = nullptr; ///< Sink of the C backend.
+
+int file_loggerf(const char* p_fmt, ...)
+{
+    va_list args;
+    va_start(args, p_fmt);
+    const int rc = vfprintf(g_sink, p_fmt, args);
+    va_end(args);
+    return rc;
+}
+
+void run_policy(const pt::options& opts, double tpns, lw_logging_policy_t policy, const char* p_mode)
+{
+    if (! lw_init_logging(file_loggerf, policy, 16, lw_severity_level_t::info, "Root")) {
+        std::fprintf(stderr, "%s: failed to initialize logging\n", p_mode);
+        return;
+    }
+
+    lw_loggerf_t logger = lw_get_logger("Format");
+    pt::samples s = pt::measure(opts, [logger](size_t i) -> void {
+                                          LOGF_INFO(logger, "request %zu done in %f ms", i, 0.25);
+                                      });
+    pt::report(p_mode, s, tpns);
+
+    lw_deinit_logging();
+}
+
+void run_async(const pt::options& opts, double tpns, int fd)
+{
+    if (! lw_init_logging_async(fd, lw_logging_policy_t::fixed_size, 16, lw_severity_level_t::info, "Root")) {
+        std::fprintf(stderr, "c LOGF_INFO async: failed to initialize logging\n");
+        return;
+    }
+
+    lw_loggerf_t logger = lw_get_logger("Format");
+    pt::samples s = pt::measure(opts, [logger](size_t i) -> void {
+                                          LOGF_INFO(logger, "request %zu done in %f ms", i, 0.25);
+                                      });
+    pt::report("c LOGF_INFO async", s, tpns);
+
+    lw_deinit_logging();
+}
+
+} // <anonymous> namespace
+
+void run_loggingf_modes(const pt::options& opts, double tpns)
+{
+    const std::string path = opts.dir + "/pt_latency_c.log";
+    g_sink = fopen(path.c_str(), "w");
+    if (g_sink == nullptr) {
+        std::perror(path.c_str());
+        return;
+    }
+
+    run_policy(opts, tpns, lw_logging_policy_t::fixed_size, "c LOGF_INFO fixed");
+    run_policy(opts, tpns, lw_logging_policy_t::dynamic_size, "c LOGF_INFO dynamic");
+    std::fflush(g_sink);
+    run_async(opts, tpns, fileno(g_sink));
+
+    fclose(g_sink);
+    g_sink = nullptr;
+    std::remove(path.c_str());
+}
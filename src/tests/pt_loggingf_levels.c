@@ -0,0 +1,136 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Level filtering perftest of the C wrapper, written in C.
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Measures the cost of a `LOGF_*` statement which is filtered out
+ *      by the channel level and by the global level, i.e. the cost of the
+ *      check of the effective level of the channel. For comparison the same
+ *      statement is measured with the separate checks of the global and the
+ *      channel levels, and with a passing check and an empty logging function.
+ *      The test is written in C, so the inline checks are compiled as a C
+ *      caller sees them.
+ *
+ *  \code{.sh}
+ *  ./build_release/test/pt_loggingf_levels --iterations=100000000
+ *  \endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOGGINGF_WRAPPER_IMPL(logger, level, fmt, ...)                      \
+    logger->p_logger(fmt __VA_OPT__(,) __VA_ARGS__)
+
+#include "loggingf_wrapper/logging.h"
+
+/**
+ *  \internal
+ *  \brief  Logging function which writes nothing.
+ */
+static __attribute__((noinline)) int null_loggerf(const char* p_fmt, ...)
+{
+    __asm__ volatile("" : : "r"(p_fmt) : "memory");
+    return 0;
+}
+
+/**
+ *  \internal
+ *  \brief  Returns the current monotonic time in nanoseconds.
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ *  \internal
+ *  \brief  Measures a `LOGF_DEBUG` statement of the logger.
+ *  \return Mean time of a statement in nanoseconds.
+ */
+static double run_logf(lw_loggerf_t logger, size_t iterations)
+{
+    const double begin = now_ns();
+    for (size_t i = 0; i < iterations; ++i) {
+        LOGF_DEBUG(logger, "request %zu", i);
+    }
+    return (now_ns() - begin) / (double)iterations;
+}
+
+/**
+ *  \internal
+ *  \brief  Measures a `LOGF_DEBUG` statement guarded by the separate checks of
+ *      the global and the channel levels.
+ *  \return Mean time of a statement in nanoseconds.
+ */
+static double run_two_checks(lw_loggerf_t logger, size_t iterations)
+{
+    const double begin = now_ns();
+    for (size_t i = 0; i < iterations; ++i) {
+        if (lw_can_log(LVL_DEBUG) && lw_can_channel_log(logger, LVL_DEBUG)) {
+            logger->p_logger("request %zu", i);
+        }
+    }
+    return (now_ns() - begin) / (double)iterations;
+}
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    size_t iterations = 50000000;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--iterations=", 13) == 0) {
+            iterations = strtoull(argv[i] + 13, NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [--iterations=N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0) {
+        return 1;
+    }
+
+    if (! lw_init_logging(null_loggerf, fixed_size, 4, trace, NULL)) {
+        fprintf(stderr, "failed to initialize logging\n");
+        return 1;
+    }
+    lw_loggerf_t logger = lw_get_logger("Bench");
+
+    printf("%-36s %10s\n", "statement", "ns/stmt");
+    lw_set_logger_level("Bench", info);
+    printf("%-36s %10.2f\n", "LOGF_DEBUG, channel level info", run_logf(logger, iterations));
+    printf("%-36s %10.2f\n", "two checks, channel level info", run_two_checks(logger, iterations));
+    lw_set_logger_level("Bench", trace);
+    lw_set_global_level(info);
+    printf("%-36s %10.2f\n", "LOGF_DEBUG, global level info", run_logf(logger, iterations));
+    printf("%-36s %10.2f\n", "two checks, global level info", run_two_checks(logger, iterations));
+    lw_set_global_level(trace);
+    printf("%-36s %10.2f\n", "LOGF_DEBUG, enabled, empty sink", run_logf(logger, iterations));
+
+    lw_deinit_logging();
+    return 0;
+}
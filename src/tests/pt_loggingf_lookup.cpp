@@ -0,0 +1,187 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Channel lookup contention perftest of the C wrapper.
+ *  \ingroup    logging_perftests
+ *
+ *  \details    Several threads resolve already registered channels by name
+ *      via `lw_get_logger` as fast as they can. The test is run for both
+ *      allocation policies and for an increasing number of threads, and prints
+ *      the mean cost of a lookup and the total throughput. Then channels are
+ *      created one by one in the `dynamic_size` policy, which starts with a
+ *      single bucket, and the mean and the worst cost of a creation is printed:
+ *      resizes of the table are incremental, so the worst case must not grow
+ *      with the number of channels.
+ *
+ *  \code{.sh}
+ *  ./build_release/test/pt_loggingf_lookup --iterations=2000000 --threads=8 --channels=64 --created=100000
+ *  \endcode
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "loggingf_wrapper/logging.h"
+
+namespace {
+
+/**
+ *  \internal
+ *  \brief  Options of the perftest.
+ */
+struct options final
+{
+    size_t iterations = 1000000; ///< Number of lookups per thread.
+    size_t threads = 0;          ///< Maximum number of threads (0 - hardware concurrency).
+    size_t channels = 32;        ///< Number of registered channels.
+    size_t created = 65536;      ///< Number of channels created one by one.
+};
+
+int null_loggerf(const char*, ...) { return 0; }
+
+/**
+ *  \internal
+ *  \brief  Runs the lookups of the channels in `thread_count` threads.
+ *  \return Mean wall time of a single lookup of one thread in nanoseconds.
+ */
+double run(const options& opts, const std::vector<std::string>& names, size_t thread_count)
+{
+    std::atomic<size_t> ready(0);
+    std::atomic<bool> start(false);
+    std::atomic<size_t> misses(0);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&, t]() -> void {
+                                 size_t miss = 0;
+                                 ready.fetch_add(1);
+                                 while (! start.load(std::memory_order_acquire)) {}
+                                 for (size_t i = 0; i < opts.iterations; ++i) {
+                                     const std::string& name = names[(i + t) % names.size()];
+                                     if (lw_get_logger(name.c_str()) == NULL) {
+                                         ++miss;
+                                     }
+                                 }
+                                 misses.fetch_add(miss);
+                             });
+    }
+    while (ready.load() != thread_count) {}
+
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    if (misses.load() != 0) {
+        std::fprintf(stderr, "%zu lookups failed\n", misses.load());
+    }
+    return std::chrono::duration<double, std::nano>(end - begin).count() / opts.iterations;
+}
+
+void run_policy(const options& opts, lw_logging_policy_t policy, const char* p_policy)
+{
+    if (! lw_init_logging(null_loggerf, policy, opts.channels, lw_severity_level_t::info, "Root")) {
+        std::fprintf(stderr, "%s: failed to initialize logging\n", p_policy);
+        return;
+    }
+
+    std::vector<std::string> names;
+    for (size_t i = 1; i < opts.channels; ++i) {
+        names.push_back("Channel_" + std::to_string(i));
+        lw_get_logger(names.back().c_str());
+    }
+
+    for (size_t thread_count = 1; thread_count <= opts.threads; thread_count *= 2) {
+        const double ns = run(opts, names, thread_count);
+        std::printf("%-10s %8zu %14.1f %14.2f\n", p_policy, thread_count, ns, thread_count * 1e3 / ns);
+    }
+
+    lw_deinit_logging();
+}
+
+void run_creation(const options& opts)
+{
+    if (! lw_init_logging(null_loggerf, lw_logging_policy_t::dynamic_size, 1, lw_severity_level_t::info, NULL)) {
+        std::fprintf(stderr, "failed to initialize logging\n");
+        return;
+    }
+
+    double total_ns = 0;
+    double max_ns = 0;
+    char name[32];
+    for (size_t i = 0; i < opts.created; ++i) {
+        std::snprintf(name, sizeof(name), "ch%zu", i);
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        lw_get_logger(name);
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+        total_ns += ns;
+        max_ns = (ns > max_ns) ? ns : max_ns;
+    }
+    std::printf("\n%-10s %8s %14s %14s\n", "policy", "created", "mean ns", "max ns");
+    std::printf("%-10s %8zu %14.1f %14.1f\n", "dynamic", opts.created, total_ns / opts.created, max_ns);
+
+    lw_deinit_logging();
+}
+
+} // <anonymous> namespace
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--iterations=", 13) == 0) {
+            opts.iterations = std::strtoull(argv[i] + 13, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            opts.threads = std::strtoull(argv[i] + 10, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--channels=", 11) == 0) {
+            opts.channels = std::strtoull(argv[i] + 11, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--created=", 10) == 0) {
+            opts.created = std::strtoull(argv[i] + 10, nullptr, 10);
+        } else {
+            std::fprintf(stderr, "Usage: %s [--iterations=N] [--threads=N] [--channels=N] [--created=N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (opts.threads == 0) {
+        opts.threads = std::thread::hardware_concurrency();
+    }
+    if (opts.iterations == 0 || opts.threads == 0 || opts.channels < 2) {
+        return 1;
+    }
+
+    std::printf("%-10s %8s %14s %14s\n", "policy", "threads", "ns/lookup", "Mlookups/s");
+    run_policy(opts, lw_logging_policy_t::fixed_size, "fixed");
+    run_policy(opts, lw_logging_policy_t::dynamic_size, "dynamic");
+    if (opts.created != 0) {
+        run_creation(opts);
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Number formatting unit tests.
+ *  \ingroup    logging_wrapper_tests
+ *
+ *  \details    The text of the formatter is compared with `std::to_chars`,
+ *      which has the same shortest round-trip semantics.
+ */
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "logging_wrapper/format.h"
+
+namespace {
+
+/**
+ *  \internal
+ *  \brief  Returns the text of a number written by the formatter.
+ */
+std::string format_double(double value)
+{
+    char buf[LW_FORMAT_DOUBLE_LEN];
+    const size_t len = lw_format_double(buf, value);
+    EXPECT_LE(len, sizeof(buf));
+    return std::string(buf, len);
+}
+
+/**
+ *  \internal
+ *  \brief  Returns the text of a number written by `std::to_chars`.
+ */
+template<typename TValue>
+std::string to_chars(TValue value)
+{
+    char buf[64];
+    const std::to_chars_result rc = std::to_chars(buf, buf + sizeof(buf), value);
+    return std::string(buf, rc.ptr);
+}
+
+std::string format_i64(int64_t value)
+{
+    char buf[LW_FORMAT_INT_LEN];
+    return std::string(buf, lw_format_i64(buf, value));
+}
+
+std::string format_u64(uint64_t value)
+{
+    char buf[LW_FORMAT_INT_LEN];
+    return std::string(buf, lw_format_u64(buf, value));
+}
+
+double from_bits(uint64_t bits)
+{
+    double value = 0;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // <anonymous> namespace
+
+/**
+ *  \test   Verification of the conversion of integers.
+ *  \see    lw_format_i64, lw_format_u64
+ *
+ *  **Test logic description:**
+ *  The text of an integer must be the same as that of `std::to_chars` for all
+ *  numbers of digits and for the limits of the types.
+ *
+ *  **Steps to reproduce:**
+ *  -# Convert the limits, the powers of ten and their neighbours.
+ *  -# Convert random numbers of random magnitudes.
+ *
+ *  \expected_result    The texts are equal.
+ */
+TEST(format, integers)
+{
+    EXPECT_EQ(format_u64(0), "0");
+    EXPECT_EQ(format_i64(0), "0");
+    EXPECT_EQ(format_u64(UINT64_MAX), "18446744073709551615");
+    EXPECT_EQ(format_i64(INT64_MIN), "-9223372036854775808");
+    EXPECT_EQ(format_i64(INT64_MAX), "9223372036854775807");
+
+    uint64_t pow10 = 1;
+    for (int i = 0; i < 20; ++i, pow10 *= 10) {
+        for (uint64_t value : {pow10 - 1, pow10, pow10 + 1}) {
+            EXPECT_EQ(format_u64(value), to_chars(value));
+            EXPECT_EQ(format_i64(-(int64_t)value), to_chars(-(int64_t)value));
+        }
+    }
+
+    std::mt19937_64 rng(2025);
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t value = rng() >> (rng() % 64);
+        EXPECT_EQ(format_u64(value), to_chars(value));
+        EXPECT_EQ(format_i64((int64_t)value), to_chars((int64_t)value));
+    }
+}
+
+/**
+ *  \test   Verification of the shortest round-trip conversion of doubles.
+ *  \see    lw_format_double
+ *
+ *  **Test logic description:**
+ *  The text of a double must be the shortest one which reads back to the same
+ *  value, in the shorter of the fixed and the scientific notations, i.e. the
+ *  same as that of `std::to_chars`.
+ *
+ *  **Steps to reproduce:**
+ *  -# Convert the special values, the limits, the powers of ten and of two and
+ *      the boundaries of the binary exponents.
+ *  -# Convert random bit patterns, random integers and random decimals.
+ *
+ *  \expected_result    The texts are equal, and every text reads back to the
+ *      converted value.
+ */
+TEST(format, doubles)
+{
+    EXPECT_EQ(format_double(0.0), "0");
+    EXPECT_EQ(format_double(-0.0), "-0");
+    EXPECT_EQ(format_double(0.1), "0.1");
+    EXPECT_EQ(format_double(1e22), "1e+22");
+    EXPECT_EQ(format_double(5e-324), "5e-324");
+    EXPECT_EQ(format_double(std::numeric_limits<double>::infinity()), "inf");
+    EXPECT_EQ(format_double(-std::numeric_limits<double>::infinity()), "-inf");
+    EXPECT_EQ(format_double(std::numeric_limits<double>::quiet_NaN()), "nan");
+    EXPECT_EQ(format_double(-2.2250738585072014e-308), "-2.2250738585072014e-308");
+    EXPECT_EQ(format_double(std::numeric_limits<double>::max()), "1.7976931348623157e+308");
+    EXPECT_EQ(format_double(12345678901234567890.0), "12345678901234567168");
+
+    for (int e = -325; e <= 309; ++e) {
+        const double value = std::strtod(("1e" + std::to_string(e)).c_str(), nullptr);
+        EXPECT_EQ(format_double(value), to_chars(value));
+    }
+    for (uint64_t e = 0; e < 0x7FF; ++e) {
+        for (uint64_t bits : {e << 52, (e << 52) | 1, ((e + 1) << 52) - 1}) {
+            EXPECT_EQ(format_double(from_bits(bits)), to_chars(from_bits(bits))) << std::hex << bits;
+        }
+    }
+
+    std::mt19937_64 rng(2025);
+    for (int i = 0; i < 300000; ++i) {
+        const double value = from_bits(rng());
+        if (std::isnan(value)) {
+            continue;
+        }
+        const std::string text = format_double(value);
+        ASSERT_EQ(text, to_chars(value)) << std::hexfloat << value;
+        EXPECT_EQ(std::strtod(text.c_str(), nullptr), value) << text;
+    }
+    for (int i = 0; i < 100000; ++i) {
+        const double value = (double)(int64_t)(rng() >> (rng() % 64));
+        EXPECT_EQ(format_double(value), to_chars(value));
+        EXPECT_EQ(format_double(value / 1000), to_chars(value / 1000));
+    }
+}
+
+/**
+ *  \test   Verification of the text buffer.
+ *  \see    wstux::logging::text_buffer
+ *
+ *  **Test logic description:**
+ *  The buffer writes values of different types into a fixed array and keeps
+ *  the text null-terminated. Text which does not fit is truncated.
+ *
+ *  **Steps to reproduce:**
+ *  -# Write strings, characters, booleans, integers of different types,
+ *      doubles and a null pointer into a large buffer.
+ *  -# Write numbers into a small buffer.
+ *
+ *  \expected_result    The text of the large buffer is the concatenation of the
+ *      values. The small buffer is full, null-terminated and truncated.
+ */
+TEST(format, text_buffer)
+{
+    char line[128];
+    wstux::logging::text_buffer buf(line);
+    EXPECT_EQ(buf.capacity(), sizeof(line) - 1);
+    buf << "i=" << -42 << ' ' << (unsigned short)7 << ' ' << 1234567890123ull
+        << " d=" << 0.3 << ' ' << 1e100 << ' ' << true << ' ' << std::string("s")
+        << ' ' << static_cast<const void*>(nullptr);
+    EXPECT_STREQ(buf.c_str(), "i=-42 7 1234567890123 d=0.3 1e+100 true s 0x0");
+    EXPECT_EQ(buf.size(), std::strlen(line));
+    EXPECT_FALSE(buf.truncated());
+
+    buf.clear();
+    EXPECT_STREQ(buf.c_str(), "");
+
+    char small[8];
+    wstux::logging::text_buffer small_buf(small);
+    small_buf << 12345 << 0.125;
+    EXPECT_STREQ(small_buf.c_str(), "123450.");
+    EXPECT_TRUE(small_buf.truncated());
+    small_buf << 'x';
+    EXPECT_STREQ(small_buf.c_str(), "123450.");
+}
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -21,11 +21,15 @@
  *  \ingroup    logging_wrapper_tests
  */
 
+#include <chrono>
 #include <cstdarg>
 #include <cstdio>
 #include <iostream>
 #include <limits>
+#include <regex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -145,6 +149,26 @@ using logging_cpp = logging_fixture;
 using loggingf = logging_fixture;
 using logging = logging_fixture;
 
+LW_STATIC_CHANNELS(ut_static_channels, "Root", "Network", "Storage");
+
+using ut_static_channels_t = ::wstux::logging::static_channels<ut_static_channels>;
+
+static_assert(ut_static_channels_t::size == 3, "static_channels: invalid size");
+static_assert(ut_static_channels_t::index_of("Network") == 1, "static_channels: invalid index");
+static_assert(ut_static_channels_t::index_of("Unknown") == ut_static_channels_t::size, "static_channels: invalid index");
+
+using ::wstux::logging::details::check_format;
+using ::wstux::logging::details::format_error;
+
+static_assert(check_format<int, const char*>("{} and {}") == format_error::none, "check_format: valid string");
+static_assert(check_format<unsigned>("{{{:X}}}") == format_error::none, "check_format: escaped braces");
+static_assert(check_format<int>("{} {}") == format_error::missing_arg, "check_format: missing argument");
+static_assert(check_format<int, int>("{}") == format_error::unused_arg, "check_format: unused argument");
+static_assert(check_format<double>("{:x}") == format_error::not_integer, "check_format: hex double");
+static_assert(check_format<int>("{:d}") == format_error::invalid_field, "check_format: invalid field");
+static_assert(check_format<int>("{}}") == format_error::unmatched_brace, "check_format: single brace");
+static_assert(check_format<int>("{") == format_error::unmatched_brace, "check_format: unclosed field");
+
 } // <anonymous> namespace
 
 namespace wstux {
@@ -608,6 +632,146 @@ TEST_F(logging, combo_loggers)
     EXPECT_TRUE(is_equal_logs(ethalon_chan, log_chan)) << "'" << ethalon_chan << "' != '" << log_chan << "'";
 }
 
+/**
+ *  \test   Verification of loggers of different types bound to one channel.
+ *  \see    wstux::logging::manager::get_logger, wstux::logging::manager::set_logger_level
+ *
+ *  **Test logic description:**
+ *  Every logger type has its own implementation within a channel, while the
+ *  level of the channel is shared. Requesting a stream-style and a
+ *  printf-style logger for the same channel must be safe, and each of them
+ *  must keep writing to its own backend.
+ *
+ *  **Steps to reproduce:**
+ *  -# Request the `"Root"` logger as stream-style, then as printf-style, then
+ *      as stream-style again.
+ *  -# Set the `ERROR` level of `"Root"` and log `INFO` and `ERROR` messages of
+ *      both styles.
+ *
+ *  \expected_result    Both stream-style handles share one backend, both
+ *      styles filter by the shared level, and each buffer contains only the
+ *      messages of its own style.
+ */
+TEST_F(logging, mixed_loggers)
+{
+    using logger_t = ::wstux::logging::logger<test_logger>;
+    using loggerf_t = ::wstux::logging::logger<test_loggerf>;
+
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::debug);
+    logger_t root_logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+    loggerf_t root_loggerf = ::wstux::logging::manager::get_logger<loggerf_t>("Root");
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+    EXPECT_EQ(root_logger.p_logger_impl, logger.p_logger_impl);
+    EXPECT_EQ(root_loggerf.channel(), "Root");
+
+    ::wstux::logging::manager::set_logger_level("Root", ::wstux::logging::severity_level::error);
+    LOG_INFO(logger, "info log " << 42);
+    LOGF_INFO(root_loggerf, "info log %d", 42);
+    LOG_ERROR(logger, "error log " << 42);
+    LOGF_ERROR(root_loggerf, "error log %d", 43);
+
+    const std::string ethalon = "****-**-** **:**:**.*** [ERROR] Root: error log 42\n";
+    const std::string ethalonf = "****-**-** **:**:**.*** [ERROR] Root: error log 43\n";
+    const std::string log = root_logger.get_logger().str_logger.str();
+    const std::string logf = root_loggerf.get_logger().str();
+    EXPECT_TRUE(is_equal_logs(ethalon, log)) << "'" << ethalon << "' != '" << log << "'";
+    EXPECT_TRUE(is_equal_logs(ethalonf, logf)) << "'" << ethalonf << "' != '" << logf << "'";
+}
+
+/**
+ *  \test   Verification of the precomputed record prefixes.
+ *  \see    wstux::logging::logger::prefix, wstux::logging::static_logger::prefix
+ *
+ *  **Test logic description:**
+ *  The default implementations write the precomputed part of a record which
+ *  follows the timestamp. It must contain the level tag and the channel name
+ *  for every severity level, for dynamic and for static channels.
+ *
+ *  **Steps to reproduce:**
+ *  -# Request the `"Channel"` logger and the static `"Network"` logger.
+ *  -# Compare their prefixes for all levels with the reference strings.
+ *
+ *  \expected_result    All prefixes are equal to the reference strings.
+ */
+TEST_F(logging, record_prefix)
+{
+    using logger_t = ::wstux::logging::logger<test_logger>;
+
+    const char* const levels[] = {"[EMERG]", "[FATAL]", "[CRIT ]", "[ERROR]", "[WARN ]",
+                                  "[NOTIC]", "[INFO ]", "[DEBUG]", "[TRACE]"};
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Channel");
+    auto static_logger = LW_STATIC_LOGGER(test_logger, ut_static_channels, "Network");
+    for (int lvl = LVL_EMERG; lvl <= LVL_TRACE; ++lvl) {
+        EXPECT_EQ(logger.prefix(SEVERITY_LEVEL(lvl)), std::vector<std::string>{std::string(" ") + levels[lvl] + " Channel: "});
+        EXPECT_EQ(static_logger.prefix(SEVERITY_LEVEL(lvl)), std::vector<std::string>{std::string(" ") + levels[lvl] + " Network: "});
+    }
+}
+
+/**
+ *  \test   Verification of the compiled layouts of the record head.
+ *  \see    wstux::logging::manager::set_layout, wstux::logging::manager::format_head
+ *
+ *  **Test logic description:**
+ *  A layout pattern is compiled into static segments, which are precomputed
+ *  per channel and level, and per-record fields. Invalid patterns must be
+ *  rejected without changing the layout, a new layout must rebuild the
+ *  prefixes of existing channels, and the deinitialization must restore the
+ *  default layout.
+ *
+ *  **Steps to reproduce:**
+ *  -# Set invalid patterns.
+ *  -# Set a layout with all fields and write stream-style and printf-style
+ *      records to the `"Root"` channel.
+ *  -# Set a layout with a timestamp without fractional digits.
+ *  -# Deinitialize the manager.
+ *
+ *  \expected_result    Invalid patterns are rejected. The records and the
+ *      precomputed segments match the layouts, and the default layout is
+ *      restored.
+ */
+TEST_F(logging, layout)
+{
+    using logger_t = ::wstux::logging::logger<test_logger>;
+    using loggerf_t = ::wstux::logging::logger<test_loggerf>;
+
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::debug);
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+    loggerf_t loggerf = ::wstux::logging::manager::get_logger<loggerf_t>("Root");
+    EXPECT_EQ(logger.prefix(::wstux::logging::severity_level::info), std::vector<std::string>{" [INFO ] Root: "});
+
+    EXPECT_FALSE(::wstux::logging::manager::set_layout("%x"));
+    EXPECT_FALSE(::wstux::logging::manager::set_layout("%T %"));
+    EXPECT_FALSE(::wstux::logging::manager::set_layout("%T{10}"));
+    EXPECT_FALSE(::wstux::logging::manager::set_layout("%c{8"));
+    EXPECT_FALSE(::wstux::logging::manager::set_layout("%c{}"));
+    EXPECT_EQ(logger.prefix(::wstux::logging::severity_level::info), std::vector<std::string>{" [INFO ] Root: "});
+
+    ASSERT_TRUE(::wstux::logging::manager::set_layout("%T{6} %t %L %c{6}|%s %f: %% "));
+    EXPECT_EQ(logger.prefix(::wstux::logging::severity_level::error), (std::vector<std::string>{" ", " ERROR Root  |", " ", ": % "}));
+    LOG_NOTICE(logger, "stream " << 42);
+    LOGF_WARN(loggerf, "printf %d", 42);
+
+    const std::regex ethalon(R"(\d{4}-\d\d-\d\d \d\d:\d\d:\d\d\.\d{6} \d+ NOTICE Root  \|.*ut_logging_wrapper\.cpp:\d+ TestBody: % stream 42
+)");
+    const std::regex ethalonf(R"(\d{4}-\d\d-\d\d \d\d:\d\d:\d\d\.\d{6} \d+ WARN Root  \|.*ut_logging_wrapper\.cpp:\d+ TestBody: % printf 42
+)");
+    const std::string log = logger.get_logger().str_logger.str();
+    const std::string logf = loggerf.get_logger().str();
+    EXPECT_TRUE(std::regex_match(log, ethalon)) << "'" << log << "'";
+    EXPECT_TRUE(std::regex_match(logf, ethalonf)) << "'" << logf << "'";
+
+    ASSERT_TRUE(::wstux::logging::manager::set_layout("%T{0}|%l|"));
+    char head[LOG_HEAD_LEN];
+    const size_t size = logger.format_head(head, sizeof(head), ::wstux::logging::severity_level::crit, _LW_SOURCE_LOCATION);
+    EXPECT_TRUE(is_equal_logs("****-**-** **:**:**|[CRIT ]|", std::string(head, size))) << head;
+    EXPECT_EQ(logger.format_head(head, 8, ::wstux::logging::severity_level::crit, _LW_SOURCE_LOCATION), 7u);
+    EXPECT_EQ(std::string(head).size(), 7u);
+
+    ::wstux::logging::manager::deinit();
+    EXPECT_EQ(::wstux::logging::manager::layout().pattern, LOG_DEFAULT_LAYOUT);
+    EXPECT_EQ(logger.prefix(::wstux::logging::severity_level::info), std::vector<std::string>{" [INFO ] Root: "});
+}
+
 /**
  *  \test   Verification of the global logging level immutability (lock) mechanism.
  *  \see    wstux::logging::manager::set_immutable_global_level, wstux::logging::manager::set_global_level
@@ -690,6 +854,221 @@ TEST_F(loggingf, default_severity_level)
     EXPECT_TRUE(is_equal_logs(ethalon, log)) << "'" << ethalon << "' != '" << log << "'";
 }
 
+/**
+ *  \test   Verification of the error-triggered verbosity bursts.
+ *  \see    wstux::logging::manager::enable_burst, wstux::logging::manager::disable_burst
+ *
+ *  **Test logic description:**
+ *  An error record lets its channel write the records up to the burst level
+ *  for the window of the burst, although the global level is `INFO`, after
+ *  which the housekeeping thread ends the burst. The level of the channel is
+ *  not changed, and a level set during the burst applies after it. The
+ *  channels declared at compile time burst too.
+ *
+ *  **Steps to reproduce:**
+ *  -# Set the global `INFO` level, create the `"Root"` and `"Network"`
+ *      channels with the `WARNING` level, set the `WARNING` level of the
+ *      declared `"Storage"` channel and enable the bursts to `DEBUG` for
+ *      100 ms without a cooldown.
+ *  -# Log an error to `"Root"`, a debug and a trace message, wait for the end
+ *      of the burst and log a debug message again.
+ *  -# Log an error to `"Network"`, set its level to `INFO`, log a debug
+ *      message, wait for the end of the burst and log a debug message again.
+ *  -# Log an error and a debug message to `"Storage"`, disable the bursts and
+ *      log a debug message again.
+ *
+ *  \expected_result    Only the debug messages logged during the bursts are
+ *      written, the levels of the channels are not raised, and the level
+ *      `INFO` of `"Network"` applies after its burst.
+ */
+TEST_F(logging, burst)
+{
+    using logger_t = ::wstux::logging::logger<test_logger>;
+
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::info);
+    logger_t root_logger = ::wstux::logging::manager::get_logger_dfl<logger_t>("Root", ::wstux::logging::severity_level::warning);
+    logger_t net_logger = ::wstux::logging::manager::get_logger_dfl<logger_t>("Network", ::wstux::logging::severity_level::warning);
+    auto storage_logger = LW_STATIC_LOGGER(test_logger, ut_static_channels, "Storage");
+    ut_static_channels_t::set_level(ut_static_channels_t::index_of("Storage"), ::wstux::logging::severity_level::warning);
+
+    ::wstux::logging::burst_config cfg;
+    cfg.window = std::chrono::milliseconds(100);
+    cfg.cooldown = std::chrono::milliseconds(0);
+    ASSERT_TRUE(::wstux::logging::manager::enable_burst(cfg));
+
+    LOG_ERROR(root_logger, "error log " << 42);
+    EXPECT_TRUE(root_logger.is_bursting(::wstux::logging::severity_level::debug));
+    EXPECT_FALSE(root_logger.can_log(::wstux::logging::severity_level::info));
+    LOG_DEBUG(root_logger, "debug log " << 42);
+    LOG_TRACE(root_logger, "trace log " << 42);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_FALSE(root_logger.is_bursting(::wstux::logging::severity_level::debug));
+    EXPECT_TRUE(root_logger.can_log(::wstux::logging::severity_level::warning));
+    LOG_DEBUG(root_logger, "debug log " << 43);
+
+    LOG_ERROR(net_logger, "error log " << 42);
+    ::wstux::logging::manager::set_logger_level("Network", ::wstux::logging::severity_level::info);
+    LOG_DEBUG(net_logger, "debug log " << 42);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_TRUE(net_logger.can_log(::wstux::logging::severity_level::info));
+    EXPECT_FALSE(net_logger.is_bursting(::wstux::logging::severity_level::debug));
+    LOG_INFO(net_logger, "info log " << 42);
+    LOG_DEBUG(net_logger, "debug log " << 43);
+
+    LOG_ERROR(storage_logger, "error log " << 42);
+    LOG_DEBUG(storage_logger, "debug log " << 42);
+    ::wstux::logging::manager::disable_burst();
+    EXPECT_FALSE(storage_logger.is_bursting(::wstux::logging::severity_level::debug));
+    LOG_DEBUG(storage_logger, "debug log " << 43);
+
+    const std::string ethalon_root = "****-**-** **:**:**.*** [ERROR] Root: error log 42\n"
+                                     "****-**-** **:**:**.*** [DEBUG] Root: debug log 42\n";
+    const std::string ethalon_net = "****-**-** **:**:**.*** [ERROR] Network: error log 42\n"
+                                    "****-**-** **:**:**.*** [DEBUG] Network: debug log 42\n"
+                                    "****-**-** **:**:**.*** [INFO ] Network: info log 42\n";
+    const std::string ethalon_storage = "****-**-** **:**:**.*** [ERROR] Storage: error log 42\n"
+                                        "****-**-** **:**:**.*** [DEBUG] Storage: debug log 42\n";
+    const std::string log_root = root_logger.get_logger().str_logger.str();
+    const std::string log_net = net_logger.get_logger().str_logger.str();
+    const std::string log_storage = storage_logger.get_logger().str_logger.str();
+    EXPECT_TRUE(is_equal_logs(ethalon_root, log_root)) << "'" << ethalon_root << "' != '" << log_root << "'";
+    EXPECT_TRUE(is_equal_logs(ethalon_net, log_net)) << "'" << ethalon_net << "' != '" << log_net << "'";
+    EXPECT_TRUE(is_equal_logs(ethalon_storage, log_storage)) << "'" << ethalon_storage << "' != '" << log_storage << "'";
+}
+
+/**
+ *  \test   Verification of the channels declared at compile time.
+ *  \see    wstux::logging::static_channels, LW_STATIC_CHANNELS, LW_STATIC_LOGGER
+ *
+ *  **Test logic description:**
+ *  The levels of the declared channels are stored in one array indexed by the
+ *  channel ids. They are changed by id, for the whole list at once, and by
+ *  name through the manager, and the global level still applies to them. A
+ *  logger of the same name returned by the manager follows the same level. The
+ *  changes by id and for the list do not register channels in the manager.
+ *
+ *  **Steps to reproduce:**
+ *  -# Get the loggers of the `"Root"` (stream-style) and `"Storage"`
+ *      (printf-style) channels of the list.
+ *  -# Set the `INFO` level of `"Root"` by id and the `ERROR` level of
+ *      `"Storage"` by name, and log messages of several levels.
+ *  -# Set the `CRIT` level of the whole list and log `ERROR` and `CRIT`
+ *      messages, then limit the global level to `EMERG`.
+ *  -# Get the `"Root"` logger from the manager and compare its level with the
+ *      level of the declared channel after the changes by id and for the list.
+ *
+ *  \expected_result    Every message is filtered by the level of its channel
+ *      and by the global level, and the buffers of both loggers are equal to
+ *      their reference templates. The number of the registered channels grows
+ *      only by `"Storage"`, set by name, until the manager returns the
+ *      `"Root"` logger, which has the level set through the list.
+ */
+TEST_F(logging, static_channels)
+{
+    auto root_logger = LW_STATIC_LOGGER(test_logger, ut_static_channels, "Root");
+    auto storage_logger = LW_STATIC_LOGGER(test_loggerf, ut_static_channels, "Storage");
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::debug);
+    EXPECT_EQ(root_logger.channel(), "Root");
+    EXPECT_EQ(storage_logger.channel(), "Storage");
+    EXPECT_TRUE(root_logger.can_log(::wstux::logging::severity_level::debug));
+    const size_t registered = ::wstux::logging::manager::logger_count();
+
+    ut_static_channels_t::set_level(ut_static_channels_t::index_of("Root"), ::wstux::logging::severity_level::info);
+    EXPECT_EQ(::wstux::logging::manager::logger_count(), registered);
+    ::wstux::logging::manager::set_logger_level("Storage", ::wstux::logging::severity_level::error);
+    EXPECT_EQ(ut_static_channels_t::level(2), ::wstux::logging::severity_level::error);
+    LOG_DEBUG(root_logger, "debug log " << 42);
+    LOG_INFO(root_logger, "info log " << 42);
+    LOGF_INFO(storage_logger, "info log %d", 42);
+    LOGF_ERROR(storage_logger, "error log %d", 42);
+
+    ut_static_channels_t::set_levels(::wstux::logging::severity_level::crit);
+    EXPECT_EQ(ut_static_channels_t::level(1), ::wstux::logging::severity_level::crit);
+    EXPECT_EQ(::wstux::logging::manager::logger_count(), registered + 1);
+    LOG_ERROR(root_logger, "error log " << 42);
+    LOGF_ERROR(storage_logger, "error log %d", 42);
+    LOG_CRIT(root_logger, "crit log " << 42);
+    LOGF_CRIT(storage_logger, "crit log %d", 42);
+
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::emerg);
+    LOG_CRIT(root_logger, "crit log " << 42);
+
+    const std::string ethalon_root = "****-**-** **:**:**.*** [INFO ] Root: info log 42\n"
+                                     "****-**-** **:**:**.*** [CRIT ] Root: crit log 42\n";
+    const std::string ethalon_storage = "****-**-** **:**:**.*** [ERROR] Storage: error log 42\n"
+                                        "****-**-** **:**:**.*** [CRIT ] Storage: crit log 42\n";
+    const std::string log_root = root_logger.get_logger().str_logger.str();
+    const std::string log_storage = storage_logger.get_logger().str();
+    EXPECT_TRUE(is_equal_logs(ethalon_root, log_root)) << "'" << ethalon_root << "' != '" << log_root << "'";
+    EXPECT_TRUE(is_equal_logs(ethalon_storage, log_storage)) << "'" << ethalon_storage << "' != '" << log_storage << "'";
+
+    using logger_t = ::wstux::logging::logger<test_logger>;
+    logger_t map_logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+    EXPECT_EQ(::wstux::logging::manager::logger_count(), registered + 2);
+    EXPECT_FALSE(map_logger.can_log(::wstux::logging::severity_level::error));
+    EXPECT_TRUE(map_logger.can_log(::wstux::logging::severity_level::crit));
+    ut_static_channels_t::set_level(ut_static_channels_t::index_of("Root"), ::wstux::logging::severity_level::info);
+    EXPECT_TRUE(map_logger.can_log(::wstux::logging::severity_level::info));
+    EXPECT_FALSE(map_logger.can_log(::wstux::logging::severity_level::debug));
+
+    ::wstux::logging::manager::deinit();
+    EXPECT_EQ(ut_static_channels_t::level(0), ::wstux::logging::severity_level::debug);
+}
+
+/**
+ *  \test   Verification of the `{}`-style formatting macros.
+ *  \see    LOGFMT_ERROR, LOGFMT_INFO, LW_FORMAT_STRING, wstux::logging::format_to
+ *
+ *  **Test logic description:**
+ *  The macros render the head and the message into the thread-local buffer of
+ *  records and pass it to the backend at once: a `printf`-like backend and a
+ *  stream backend receive the same record. The format strings are checked at
+ *  compile time (see the `check_format` assertions above), and a record longer
+ *  than the buffer is truncated but keeps its new line.
+ *
+ *  **Steps to reproduce:**
+ *  -# Log messages with integer, hexadecimal, floating point, string, boolean
+ *      and escaped brace fields into a stream logger and a `printf`-like
+ *      static logger.
+ *  -# Log a message filtered out by the level of the channel.
+ *  -# Log a message longer than \ref LOG_RECORD_LEN.
+ *
+ *  \expected_result    The buffers of the loggers are equal to their
+ *      reference templates, and the long record has `LOG_RECORD_LEN - 1`
+ *      characters and ends with a new line.
+ */
+TEST_F(logging, fmt_macros)
+{
+    using logger_t = ::wstux::logging::logger<test_logger>;
+
+    logger_t root_logger = ::wstux::logging::manager::get_logger<logger_t>("Root");
+    auto network_logger = LW_STATIC_LOGGER(test_loggerf, ut_static_channels, "Network");
+    ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::debug);
+    ::wstux::logging::manager::set_logger_level("Root", ::wstux::logging::severity_level::info);
+
+    LOGFMT_ERROR(root_logger, "code {} status {} flags {:x}/{:X}", 404, "Not Found", 255u, -26);
+    LOGFMT_DEBUG(root_logger, "debug {}", 1);
+    LOGFMT_INFO(root_logger, "ratio {} of {{total}} {}", 0.25, true);
+    LOGFMT_NOTICE(network_logger, "no fields");
+    LOGFMT_WARN(network_logger, "{}{}", std::string("a"), 'b');
+
+    const std::string ethalon_root = "****-**-** **:**:**.*** [ERROR] Root: code 404 status Not Found flags ff/-1A\n"
+                                     "****-**-** **:**:**.*** [INFO ] Root: ratio 0.25 of {total} true\n";
+    const std::string ethalon_network = "****-**-** **:**:**.*** [NOTIC] Network: no fields\n"
+                                        "****-**-** **:**:**.*** [WARN ] Network: ab\n";
+    const std::string log_root = root_logger.get_logger().str_logger.str();
+    const std::string log_network = network_logger.get_logger().str();
+    EXPECT_TRUE(is_equal_logs(ethalon_root, log_root)) << "'" << ethalon_root << "' != '" << log_root << "'";
+    EXPECT_TRUE(is_equal_logs(ethalon_network, log_network)) << "'" << ethalon_network << "' != '" << log_network << "'";
+
+    logger_t long_logger = ::wstux::logging::manager::get_logger<logger_t>("Long");
+    const std::string long_message(LOG_RECORD_LEN, 'x');
+    LOGFMT_INFO(long_logger, "{}", long_message);
+    const std::string log_long = long_logger.get_logger().str_logger.str();
+    EXPECT_EQ(log_long.size(), (size_t)LOG_RECORD_LEN - 1);
+    EXPECT_EQ(log_long.back(), '\n');
+}
+
 /**
  *  \internal
  *  \brief  Main function.
@@ -0,0 +1,141 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  C part of the deferred mode unit tests.
+ *  \ingroup    loggingf_wrapper_tests
+ *
+ *  \details    The deferred `LOGF_*` macros capture the arguments by `_Generic`
+ *      and are available only in C, so the statements under test are compiled
+ *      here and called by `ut_loggingf_deferred.cpp`.
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOGGINGF_WRAPPER_DEFERRED
+#include "loggingf_wrapper/logging.h"
+
+/**
+ *  \internal
+ *  \brief  Compares the rendering of a deferred statement with `snprintf`,
+ *      for a large and for a small buffer.
+ */
+#define CHECK_FORMAT(fmt, ...)                                              \
+    do {                                                                    \
+        LW_DEFERRED_CAPTURE(site, args, LVL_INFO, fmt, __VA_ARGS__)         \
+        char expected[256];                                                 \
+        char actual[256];                                                   \
+        for (size_t size = 5; size <= sizeof(actual); size += sizeof(actual) - 5) { \
+            const int expected_rc = snprintf(expected, size, fmt __VA_OPT__(,) __VA_ARGS__); \
+            const int actual_rc = lw_deferred_format(actual, size, &site, args); \
+            if (expected_rc != actual_rc || strcmp(expected, actual) != 0) {   \
+                if (mismatches++ == 0) {                                    \
+                    snprintf(p_report, report_size, "\"%s\" (%zu): \"%s\" (%d) != \"%s\" (%d)", \
+                             fmt, size, actual, actual_rc, expected, expected_rc); \
+                }                                                           \
+            }                                                               \
+        }                                                                   \
+    } while (0)
+
+size_t ut_deferred_format(char* p_report, size_t report_size)
+{
+    size_t mismatches = 0;
+    char name[] = "channel";
+    const signed char sc = -5;
+    const unsigned char uc = 250;
+    const short sh = -1234;
+    const unsigned short ush = 65000;
+    const long l = LONG_MIN;
+    const unsigned long ul = ULONG_MAX;
+    const long long ll = LLONG_MIN;
+    const unsigned long long ull = ULLONG_MAX;
+    const size_t sz = SIZE_MAX;
+    const ptrdiff_t pd = -42;
+    const float f = 1.5f;
+    const long double ld = 2.25L;
+    const int big = 300;
+
+    CHECK_FORMAT("no arguments");
+    CHECK_FORMAT("%% literal %%");
+    CHECK_FORMAT("%d %i %5d %-5d| %+d % d %05d", 42, -42, 7, 7, 7, 7, -7);
+    CHECK_FORMAT("%u %o %x %X %#x %#o", 42u, 8u, 255u, 255u, 255u, 8u);
+    CHECK_FORMAT("%hhd %hhu %hd %hu", sc, uc, sh, ush);
+    CHECK_FORMAT("%hhd %hhu", big, big);
+    CHECK_FORMAT("%ld %lu %lld %llu", l, ul, ll, ull);
+    CHECK_FORMAT("%zu %td %jd", sz, pd, (intmax_t)-1);
+    CHECK_FORMAT("%c%c%c", 'a', 'b', 'c');
+    CHECK_FORMAT("%f %.3f %10.2f %-10.1f| %e %E %g %G", 3.14159, 3.14159, 2.5, 2.5, 1e10, 1e-10, 0.0001, 1e20);
+    CHECK_FORMAT("%a %f %Lf", 1.0, f, ld);
+    CHECK_FORMAT("%s %10s %-10s| %.3s", name, name, name, name);
+    CHECK_FORMAT("%*d %-*d| %.*f %.*s", 6, 1, 6, 1, 2, 3.14159, 4, "string");
+    CHECK_FORMAT("%.*f", -1, 3.14159);
+    CHECK_FORMAT("%p %p", (void*)name, (const void*)0x1234);
+    CHECK_FORMAT("%d %s %u %f %c %x %s %lld %g %hd %zu %p %o %e %s %d",
+                 1, "two", 3u, 4.0, '5', 6u, "seven", 8ll, 9.0, sh, sz, (void*)name, 8u, 1.0, "end", 16);
+    return mismatches;
+}
+
+void ut_deferred_log(lw_loggerf_t logger, int thread, int index)
+{
+    char name[16];
+    snprintf(name, sizeof(name), "Thread_%d", thread);
+    LOGF_INFO(logger, "%s: record %d, %.2f, %c, %5s|", name, index, index * 0.5, 'x', "ab");
+    // The string is copied into the record.
+    memset(name, 'X', sizeof(name) - 1);
+}
+
+void ut_deferred_log_long(lw_loggerf_t logger, size_t size)
+{
+    char* p_text = (char*)malloc(size + 1);
+    if (p_text == NULL) {
+        return;
+    }
+    memset(p_text, 'a', size);
+    p_text[size] = '\0';
+    LOGF_ERROR(logger, "long %s", p_text);
+    LOGF_DEBUG(logger, "no arguments");
+    free(p_text);
+}
+
+void ut_deferred_log_error(lw_loggerf_t logger, int index)
+{
+    LOGF_ERROR(logger, "failure %d", index);
+}
+
+const lw_log_site_t* ut_deferred_site(int index)
+{
+    if (index == 0) {
+        LW_DEFERRED_CAPTURE(site, args, LVL_WARN, "first %d %s", index, "site")
+        (void)args;
+        return lw_log_site_get(lw_log_site_id(&site));
+    }
+    LW_DEFERRED_CAPTURE(site, args, LVL_DEBUG, "second %f", 1.0)
+    (void)args;
+    return lw_log_site_get(lw_log_site_id(&site));
+}
+
+uint32_t ut_deferred_site_race(void)
+{
+    LW_DEFERRED_CAPTURE(site, args, LVL_INFO, "race %d", 1)
+    (void)args;
+    return lw_log_site_id(&site);
+}
@@ -0,0 +1,484 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Deferred mode unit tests of the loggingf wrapper.
+ *  \ingroup    loggingf_wrapper_tests
+ *
+ *  \details    The logging statements are compiled in C by
+ *      `ut_loggingf_deferred.c`.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "loggingf_wrapper/deferred.h"
+#include "loggingf_wrapper/logging.h"
+
+extern "C" {
+size_t ut_deferred_format(char* p_report, size_t report_size);
+void ut_deferred_log(lw_loggerf_t logger, int thread, int index);
+void ut_deferred_log_long(lw_loggerf_t logger, size_t size);
+void ut_deferred_log_error(lw_loggerf_t logger, int index);
+const lw_log_site_t* ut_deferred_site(int index);
+uint32_t ut_deferred_site_race(void);
+}
+
+namespace {
+
+std::string g_log; ///< Output of the synchronous logging function
+
+/**
+ *  \internal
+ *  \brief  Custom logging function (C callback), which appends the output
+ *      to `g_log`.
+ */
+int log_fn(const char* p_fmt, ...)
+{
+    char buf[8192];
+    va_list args;
+    va_start(args, p_fmt);
+    const int rc = vsnprintf(buf, sizeof(buf), p_fmt, args);
+    va_end(args);
+    if (rc >= 0) {
+        g_log.append(buf, std::min((size_t)rc, sizeof(buf) - 1));
+    }
+    return rc;
+}
+
+/**
+ *  \internal
+ *  \brief  Compares a log with a reference template, in which the '*'
+ *      character replaces dynamic data (e.g., a timestamp).
+ */
+bool is_equal_logs(const std::string& ethalon, const std::string& log)
+{
+    if (ethalon.size() != log.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < ethalon.size(); ++i) {
+        if (ethalon[i] != '*' && ethalon[i] != log[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ *  \internal
+ *  \brief  Reads the whole file.
+ */
+std::string read_file(FILE* p_file)
+{
+    std::rewind(p_file);
+    std::string log;
+    char buf[512];
+    for (size_t size = 0; (size = std::fread(buf, 1, sizeof(buf), p_file)) > 0;) {
+        log.append(buf, size);
+    }
+    return log;
+}
+
+/**
+ *  \internal
+ *  \brief  Test fixture, which deinitializes the C subsystem after each test case.
+ */
+class deferred_fixture : public ::testing::Test
+{
+public:
+    virtual void SetUp() override {}
+
+    /// \brief  Environment cleanup (Invoked after each test case).
+    virtual void TearDown() override { g_log.clear(); lw_deinit_logging(); }
+};
+
+using loggingf_deferred = deferred_fixture;
+
+} // <anonymous> namespace
+
+/**
+ *  \test   Verification of the rendering of deferred statements.
+ *  \see    lw_deferred_format, LW_DEFERRED_CAPTURE
+ *
+ *  **Test logic description:**
+ *  The arguments of a deferred statement are captured with their types, and
+ *  the message is rendered from the captured values. The result must be the
+ *  same as `snprintf` produces for the original arguments.
+ *
+ *  **Steps to reproduce:**
+ *  -# Capture statements with integers of all sizes, characters, floating
+ *      point numbers, strings, pointers, flags, widths and
+ *      precisions (including `*` fields), and length modifiers.
+ *  -# Render every statement into a large and a small buffer and compare the
+ *      text and the return value with `snprintf`.
+ *
+ *  \expected_result    All renderings are equal to `snprintf`, including the
+ *      truncated ones.
+ */
+TEST_F(loggingf_deferred, format)
+{
+    char report[512] = "";
+    EXPECT_EQ(ut_deferred_format(report, sizeof(report)), 0u) << report;
+}
+
+/**
+ *  \test   Verification of deferred logging with a synchronous output function.
+ *  \see    lw_deferred_log
+ *
+ *  **Test logic description:**
+ *  Without the asynchronous backend a deferred record is rendered in the
+ *  calling thread, in the format of the default implementation, and passed to
+ *  the output function of the channel.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system with a custom output function.
+ *  -# Log a deferred record, a record longer than the formatting buffer and a
+ *      record filtered out by the level.
+ *
+ *  \expected_result    The output contains the first two records in the
+ *      default format.
+ */
+TEST_F(loggingf_deferred, sync)
+{
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::fixed_size, 1,
+                                lw_severity_level_t::info, "Root"));
+
+    ut_deferred_log(lw_root_logger(), 1, 7);
+    ut_deferred_log_long(lw_root_logger(), LOG_ASYNC_LINE_LEN + 16);
+
+    const std::string ethalon = "****-**-** **:**:**.*** [INFO ] Root: Thread_1: record 7, 3.50, x,    ab|\n"
+                                "****-**-** **:**:**.*** [ERROR] Root: long "
+                                + std::string(LOG_ASYNC_LINE_LEN + 16, 'a') + "\n";
+    EXPECT_TRUE(is_equal_logs(ethalon, g_log)) << "'" << ethalon << "' != '" << g_log << "'";
+}
+
+/**
+ *  \test   Verification of deferred logging with the asynchronous backend.
+ *  \see    lw_deferred_log, lw_init_logging_async, lw_drain_logging
+ *
+ *  **Test logic description:**
+ *  Deferred records of several threads are rendered by the writer thread.
+ *  The records of every thread must be written in order, and the string
+ *  arguments must be copied, as the callers overwrite them after logging.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system with the asynchronous backend writing to a
+ *      temporary file.
+ *  -# Log records from several threads, then a record larger than the buffer
+ *      of the writer, and drain the backend.
+ *  -# Read the file while the system is still initialized.
+ *
+ *  \expected_result    All records are written intact and in order.
+ */
+TEST_F(loggingf_deferred, async)
+{
+    const int thread_count = 4;
+    const int record_count = 500;
+    const size_t long_size = 70 * 1024;
+
+    FILE* p_file = std::tmpfile();
+    ASSERT_TRUE(p_file != nullptr);
+    EXPECT_TRUE(lw_init_logging_async(fileno(p_file), lw_logging_policy_t::dynamic_size, 0,
+                                      lw_severity_level_t::info, "Root"));
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count; ++t) {
+        workers.emplace_back([t]() -> void {
+                                 for (int i = 0; i < record_count; ++i) {
+                                     ut_deferred_log(lw_root_logger(), t, i);
+                                 }
+                             });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    ut_deferred_log_long(lw_root_logger(), long_size);
+    EXPECT_TRUE(lw_drain_logging());
+
+    const std::string log = read_file(p_file);
+    std::vector<int> next(thread_count, 0);
+    size_t pos = 0;
+    for (int count = 0; count < thread_count * record_count; ++count) {
+        const size_t end = log.find('\n', pos);
+        ASSERT_NE(end, std::string::npos);
+        const std::string line = log.substr(pos, end + 1 - pos);
+        pos = end + 1;
+
+        int t = 0;
+        int i = 0;
+        ASSERT_EQ(std::sscanf(line.c_str(), "%*s %*s [INFO ] Root: Thread_%d: record %d", &t, &i), 2) << line;
+        ASSERT_LT(t, thread_count);
+        EXPECT_EQ(i, next[t]) << line;
+        char expected[128];
+        std::snprintf(expected, sizeof(expected), "Thread_%d: record %d, %.2f, x,    ab|\n", t, i, i * 0.5);
+        EXPECT_EQ(line.substr(line.find("Thread_")), expected);
+        next[t] = i + 1;
+    }
+    const std::string ethalon = "****-**-** **:**:**.*** [ERROR] Root: long " + std::string(long_size, 'a') + "\n";
+    EXPECT_TRUE(is_equal_logs(ethalon, log.substr(pos)));
+
+    lw_deinit_logging();
+    std::fclose(p_file);
+}
+
+/**
+ *  \test   Verification of the interning of the statements.
+ *  \see    lw_log_site_id, lw_log_site_register, lw_log_site_get
+ *
+ *  **Test logic description:**
+ *  A deferred statement is interned on its first record under a 32-bit id,
+ *  and the descriptor found by the id holds the format string, the argument
+ *  types, the source location and the level of the statement. Threads which
+ *  hit a statement for the first time concurrently get the same id.
+ *
+ *  **Steps to reproduce:**
+ *  -# Intern two statements and resolve their ids twice.
+ *  -# Check the metadata of the descriptors.
+ *  -# Intern a statement from several threads started at once.
+ *
+ *  \expected_result    The ids are nonzero, distinct, stable and resolved to
+ *      the descriptors of the statements; all threads get the same id.
+ */
+TEST_F(loggingf_deferred, sites)
+{
+    const lw_log_site_t* p_first = ut_deferred_site(0);
+    const lw_log_site_t* p_second = ut_deferred_site(1);
+    ASSERT_TRUE(p_first != nullptr);
+    ASSERT_TRUE(p_second != nullptr);
+    EXPECT_NE(p_first->id, 0u);
+    EXPECT_NE(p_first->id, p_second->id);
+    EXPECT_EQ(ut_deferred_site(0), p_first);
+    EXPECT_EQ(ut_deferred_site(1), p_second);
+    EXPECT_EQ(lw_log_site_get(p_first->id), p_first);
+    EXPECT_LE(std::max(p_first->id, p_second->id), lw_log_site_count());
+    EXPECT_TRUE(lw_log_site_get(0) == nullptr);
+    EXPECT_TRUE(lw_log_site_get(lw_log_site_count() + 1) == nullptr);
+
+    EXPECT_STREQ(p_first->fmt, "first %d %s");
+    ASSERT_EQ(p_first->nargs, 2u);
+    EXPECT_EQ(p_first->p_types[0], LW_ARG_INT);
+    EXPECT_EQ(p_first->p_types[1], LW_ARG_STR);
+    EXPECT_EQ(p_first->level, LVL_WARN);
+    EXPECT_EQ(p_second->level, LVL_DEBUG);
+    EXPECT_STREQ(p_first->func, "ut_deferred_site");
+    EXPECT_TRUE(std::strstr(p_first->file, "ut_loggingf_deferred.c") != nullptr) << p_first->file;
+    EXPECT_LT(p_first->line, p_second->line);
+
+    const int thread_count = 8;
+    std::atomic<bool> start(false);
+    std::vector<uint32_t> ids(thread_count, 0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&start, &ids, t]() -> void {
+                                 while (! start.load()) {}
+                                 ids[t] = ut_deferred_site_race();
+                             });
+    }
+    start.store(true);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    EXPECT_NE(ids[0], 0u);
+    EXPECT_EQ(std::count(ids.begin(), ids.end(), ids[0]), thread_count);
+    EXPECT_EQ(lw_log_site_get(ids[0])->id, ids[0]);
+}
+
+/**
+ *  \test   Verification of the flight recorder.
+ *  \see    lw_set_capture_level, lw_flight_dump
+ *
+ *  **Test logic description:**
+ *  Records which fail the level check, but pass the capture level, are kept
+ *  in the buffer of their thread without being written. An error record
+ *  writes the captured records of all threads, oldest first, before itself.
+ *  A manual dump writes the records captured since.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system with the `warning` level and a custom output
+ *      function, and set the capture level to `debug`.
+ *  -# Capture a record in another thread, which is kept alive, and two
+ *      records in the main thread.
+ *  -# Log an error record.
+ *  -# Log an error record followed by a debug record, and dump manually.
+ *  -# Disable the capture, log a record and dump.
+ *
+ *  \expected_result    Nothing is written before the first error; then the
+ *      captured records are written in the order of logging, followed by the
+ *      error. The debug record is written by the manual dump only. Nothing is
+ *      captured after the capture is disabled.
+ */
+TEST_F(loggingf_deferred, flight_recorder)
+{
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::fixed_size, 1,
+                                lw_severity_level_t::warning, "Root"));
+    lw_set_capture_level(LVL_DEBUG);
+
+    std::atomic<int> stage(0);
+    std::thread worker([&stage]() -> void {
+                           ut_deferred_log(lw_root_logger(), 2, 0);
+                           stage.store(1);
+                           while (stage.load() != 2) {
+                               std::this_thread::yield();
+                           }
+                       });
+    while (stage.load() != 1) {
+        std::this_thread::yield();
+    }
+    ut_deferred_log(lw_root_logger(), 1, 0);
+    ut_deferred_log(lw_root_logger(), 1, 1);
+    EXPECT_TRUE(g_log.empty()) << g_log;
+
+    ut_deferred_log_error(lw_root_logger(), 1);
+    stage.store(2);
+    worker.join();
+    std::string ethalon = "****-**-** **:**:**.*** [INFO ] Root: Thread_2: record 0, 0.00, x,    ab|\n"
+                          "****-**-** **:**:**.*** [INFO ] Root: Thread_1: record 0, 0.00, x,    ab|\n"
+                          "****-**-** **:**:**.*** [INFO ] Root: Thread_1: record 1, 0.50, x,    ab|\n"
+                          "****-**-** **:**:**.*** [ERROR] Root: failure 1\n";
+    EXPECT_TRUE(is_equal_logs(ethalon, g_log)) << "'" << ethalon << "' != '" << g_log << "'";
+
+    g_log.clear();
+    ut_deferred_log_long(lw_root_logger(), 4);
+    lw_flight_dump();
+    ethalon = "****-**-** **:**:**.*** [ERROR] Root: long aaaa\n"
+              "****-**-** **:**:**.*** [DEBUG] Root: no arguments\n";
+    EXPECT_TRUE(is_equal_logs(ethalon, g_log)) << "'" << ethalon << "' != '" << g_log << "'";
+
+    g_log.clear();
+    lw_set_capture_level(LW_CAPTURE_OFF);
+    ut_deferred_log(lw_root_logger(), 1, 2);
+    lw_flight_dump();
+    EXPECT_TRUE(g_log.empty()) << g_log;
+}
+
+/**
+ *  \test   Verification of the verbosity bursts of captured records.
+ *  \see    lw_set_capture_level, lw_enable_burst
+ *
+ *  **Test logic description:**
+ *  An error record, which fails the level check of its channel and is only
+ *  captured by the flight recorder, is not logged by the channel, so it does
+ *  not trigger the verbosity burst of the channel. A written error does, and
+ *  the channel then writes past the global level.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system with the `warning` level, set the `crit` level of
+ *      the root channel and the `debug` capture level, and enable the bursts.
+ *  -# Log an error record.
+ *  -# Set the `warning` level of the root channel and log an error record.
+ *
+ *  \expected_result    The captured error does not start a burst, so the
+ *      channel writes up to `crit` only. The written error starts it, so the
+ *      channel writes up to `debug` while the global level is `warning`.
+ */
+TEST_F(loggingf_deferred, flight_recorder_burst)
+{
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::fixed_size, 1,
+                                lw_severity_level_t::warning, "Root"));
+    lw_set_logger_level("Root", lw_severity_level_t::crit);
+    lw_set_capture_level(LVL_DEBUG);
+    const lw_burst_config_t cfg = {lw_severity_level_t::debug, 60000, 0, 0};
+    ASSERT_TRUE(lw_enable_burst(&cfg));
+
+    ut_deferred_log_error(lw_root_logger(), 1);
+    EXPECT_FALSE(lw_is_log_enabled(lw_root_logger(), LVL_ERROR));
+
+    lw_set_logger_level("Root", lw_severity_level_t::warning);
+    ut_deferred_log_error(lw_root_logger(), 2);
+    EXPECT_TRUE(lw_is_log_enabled(lw_root_logger(), LVL_DEBUG));
+    EXPECT_FALSE(lw_can_log(LVL_DEBUG));
+    lw_disable_burst();
+    lw_set_capture_level(LW_CAPTURE_OFF);
+}
+
+/**
+ *  \test   Verification of the overflow of the flight recorder buffer.
+ *  \see    lw_set_capture_level, lw_flight_dump, LOG_FLIGHT_BUF_SIZE
+ *
+ *  **Test logic description:**
+ *  When the buffer of a thread is full, the oldest records are dropped, so a
+ *  dump writes the newest records in order. With the asynchronous backend the
+ *  dumped records are enqueued before the error record.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system with the asynchronous backend writing to a
+ *      temporary file, with the `warning` level and the `info` capture level.
+ *  -# Capture many more records than the buffer holds.
+ *  -# Log an error record and drain the backend.
+ *
+ *  \expected_result    The file contains consecutive records which end with
+ *      the last captured one, fewer than were captured, and the error record.
+ */
+TEST_F(loggingf_deferred, flight_recorder_overflow)
+{
+    const int record_count = 5000;
+
+    FILE* p_file = std::tmpfile();
+    ASSERT_TRUE(p_file != nullptr);
+    EXPECT_TRUE(lw_init_logging_async(fileno(p_file), lw_logging_policy_t::dynamic_size, 0,
+                                      lw_severity_level_t::warning, "Root"));
+    lw_set_capture_level(LVL_INFO);
+    for (int i = 0; i < record_count; ++i) {
+        ut_deferred_log(lw_root_logger(), 1, i);
+    }
+    ut_deferred_log_error(lw_root_logger(), 7);
+    EXPECT_TRUE(lw_drain_logging());
+
+    const std::string log = read_file(p_file);
+    size_t pos = 0;
+    int first = -1;
+    int last = -1;
+    for (size_t end = log.find('\n'); end != std::string::npos; pos = end + 1, end = log.find('\n', pos)) {
+        const std::string line = log.substr(pos, end + 1 - pos);
+        int i = 0;
+        if (std::sscanf(line.c_str(), "%*s %*s [INFO ] Root: Thread_1: record %d", &i) != 1) {
+            break;
+        }
+        if (first < 0) {
+            first = i;
+        } else {
+            EXPECT_EQ(i, last + 1) << line;
+        }
+        last = i;
+    }
+    EXPECT_GT(first, 0);
+    EXPECT_EQ(last, record_count - 1);
+    EXPECT_TRUE(is_equal_logs("****-**-** **:**:**.*** [ERROR] Root: failure 7\n", log.substr(pos)))
+        << log.substr(pos);
+
+    lw_deinit_logging();
+    std::fclose(p_file);
+}
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
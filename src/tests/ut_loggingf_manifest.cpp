@@ -0,0 +1,206 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Channel manifest unit tests of the loggingf wrapper.
+ *  \ingroup    loggingf_wrapper_tests
+ *
+ *  \details    The tables of `ut_channels.manifest` are generated by the
+ *      `ChannelManifest` CMake helper.
+ */
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "loggingf_wrapper/logging.h"
+#include "loggingf_wrapper/manifest.h"
+
+#include "ut_channels.h"
+
+namespace {
+
+/**
+ *  \internal
+ *  \brief  Logging function, which discards the output.
+ */
+int null_fn(const char*, ...) { return 0; }
+
+/**
+ *  \internal
+ *  \brief  Test fixture, which deinitializes the C subsystem after each test case.
+ */
+class manifest_fixture : public ::testing::Test
+{
+public:
+    virtual void SetUp() override {}
+
+    /// \brief  Environment cleanup (Invoked after each test case).
+    virtual void TearDown() override { lw_deinit_logging(); }
+};
+
+using loggingf_manifest = manifest_fixture;
+
+// The hash of a string literal is an integral constant expression in C++.
+static_assert(LW_MANIFEST_HASH("") == 2166136261u, "FNV-1a offset basis");
+static_assert(LW_MANIFEST_HASH("a") == 0xE40C292Cu, "FNV-1a of 'a'");
+
+} // <anonymous> namespace
+
+/**
+ *  \test   Verification of the generated tables of the perfect hash.
+ *  \see    ChannelManifest, lw_manifest_hash, lw_manifest_slot, LW_MANIFEST_HASH
+ *
+ *  **Test logic description:**
+ *  The generator computes the hash in CMake, and the library computes it in C.
+ *  Both must agree, and the hash must be minimal and perfect: every channel
+ *  of the manifest has its own slot, which is its id.
+ *
+ *  **Steps to reproduce:**
+ *  -# Compute the slots of all channel names of the manifest.
+ *  -# Compare the compile-time and the run-time hashes of literals, including
+ *      a literal longer than `32` characters.
+ *
+ *  \expected_result    The slots are a permutation of the ids, the ids of the
+ *      generated header refer to their names, and the hashes are equal.
+ */
+TEST_F(loggingf_manifest, tables)
+{
+    ASSERT_EQ(ut_channels.count, (size_t)UT_CHANNELS_COUNT);
+    std::set<size_t> slots;
+    for (size_t id = 0; id < ut_channels.count; ++id) {
+        const char* p_name = ut_channels.p_names[id];
+        EXPECT_EQ(lw_manifest_slot(&ut_channels, lw_manifest_hash(p_name)), id) << p_name;
+        slots.insert(lw_manifest_slot(&ut_channels, lw_manifest_hash(p_name)));
+    }
+    EXPECT_EQ(slots.size(), ut_channels.count);
+    EXPECT_EQ(std::string(ut_channels.p_names[UT_CHANNELS_ROOT]), "Root");
+    EXPECT_EQ(std::string(ut_channels.p_names[UT_CHANNELS_HTTP_SERVER]), "Http/server");
+    EXPECT_EQ(std::string(ut_channels.p_names[UT_CHANNELS_STORAGE_REPLICATION_WORKER]), "Storage.replication.worker");
+
+    EXPECT_EQ(LW_MANIFEST_HASH("Network.tcp"), lw_manifest_hash("Network.tcp"));
+    EXPECT_EQ(LW_MANIFEST_HASH("Storage.replication.worker"), lw_manifest_hash("Storage.replication.worker"));
+    EXPECT_EQ(LW_MANIFEST_HASH("A channel name longer than thirty-two characters"),
+              lw_manifest_hash("A channel name longer than thirty-two characters"));
+}
+
+/**
+ *  \test   Verification of the lookup of the manifest channels.
+ *  \see    lw_register_channel_manifest, lw_get_manifest_logger, lw_get_logger_hashed,
+ *      LW_GET_LOGGER
+ *
+ *  **Test logic description:**
+ *  After the registration of the manifest its channels are resolved by the
+ *  perfect hash, and other channels fall back to the channel table. A logger
+ *  returned before the registration must stay the logger of the channel.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system in `dynamic_size` mode with the root channel
+ *      `"Root"` and request the `"Network"` logger.
+ *  -# Register the manifest, then try to register it again.
+ *  -# Request the loggers of all channels by id, by name and by the macro, and
+ *      a channel which is not in the manifest.
+ *
+ *  \expected_result    The second registration fails. Every way of a lookup
+ *      returns the same logger of a channel, the loggers of the root and the
+ *      `"Network"` channels are the ones returned before the registration, and
+ *      the long channel name is not truncated.
+ */
+TEST_F(loggingf_manifest, lookup)
+{
+    ASSERT_TRUE(lw_init_logging(null_fn, lw_logging_policy_t::dynamic_size, 0, lw_severity_level_t::info, "Root"));
+    lw_loggerf_t network_logger = lw_get_logger("Network");
+    EXPECT_TRUE(lw_get_manifest_logger(UT_CHANNELS_NETWORK) == nullptr);
+
+    ASSERT_TRUE(lw_register_channel_manifest(&ut_channels));
+    EXPECT_FALSE(lw_register_channel_manifest(&ut_channels));
+
+    EXPECT_EQ(lw_get_manifest_logger(UT_CHANNELS_ROOT), lw_root_logger());
+    EXPECT_EQ(lw_get_manifest_logger(UT_CHANNELS_NETWORK), network_logger);
+    EXPECT_TRUE(lw_get_manifest_logger(UT_CHANNELS_COUNT) == nullptr);
+    for (size_t id = 0; id < ut_channels.count; ++id) {
+        const std::string name = ut_channels.p_names[id];
+        lw_loggerf_t logger = lw_get_manifest_logger(id);
+        ASSERT_TRUE(logger != nullptr);
+        EXPECT_EQ(std::string(logger->channel), name);
+        EXPECT_EQ(lw_get_logger(name.c_str()), logger);
+        EXPECT_EQ(lw_get_logger_hashed(name.c_str(), lw_manifest_hash(name.c_str())), logger);
+    }
+    EXPECT_EQ(LW_GET_LOGGER("Storage.replication.worker"), lw_get_manifest_logger(UT_CHANNELS_STORAGE_REPLICATION_WORKER));
+    EXPECT_EQ(LW_GET_LOGGER("Ipc:pipe"), lw_get_manifest_logger(UT_CHANNELS_IPC_PIPE));
+
+    lw_loggerf_t unknown_logger = LW_GET_LOGGER("Unknown");
+    ASSERT_TRUE(unknown_logger != nullptr);
+    EXPECT_EQ(std::string(unknown_logger->channel), "Unknown");
+    EXPECT_EQ(lw_get_logger("Unknown"), unknown_logger);
+
+    lw_set_logger_level("Storage.replication.worker", lw_severity_level_t::error);
+    EXPECT_EQ(lw_get_manifest_logger(UT_CHANNELS_STORAGE_REPLICATION_WORKER)->level, lw_severity_level_t::error);
+}
+
+/**
+ *  \test   Verification of the rejection of a manifest.
+ *  \see    lw_register_channel_manifest
+ *
+ *  **Test logic description:**
+ *  A manifest is rejected if its channels exceed the channel limit of the
+ *  `fixed_size` policy or if its tables do not match the hash of the library.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system in `fixed_size` mode with fewer channels than the
+ *      manifest and register the manifest.
+ *  -# Reinitialize the system in `dynamic_size` mode and register a copy of
+ *      the manifest with other displacements.
+ *
+ *  \expected_result    Both registrations fail, and the channels are resolved
+ *      by the channel table.
+ */
+TEST_F(loggingf_manifest, rejected)
+{
+    ASSERT_TRUE(lw_init_logging(null_fn, lw_logging_policy_t::fixed_size, UT_CHANNELS_COUNT - 1,
+                                lw_severity_level_t::info, NULL));
+    EXPECT_FALSE(lw_register_channel_manifest(&ut_channels));
+    EXPECT_TRUE(lw_get_manifest_logger(0) == nullptr);
+    lw_deinit_logging();
+
+    std::vector<uint32_t> displacements(ut_channels.p_displacements,
+                                        ut_channels.p_displacements + ut_channels.bucket_count);
+    for (uint32_t& displacement : displacements) {
+        displacement += 1;
+    }
+    lw_channel_manifest_t manifest = ut_channels;
+    manifest.p_displacements = displacements.data();
+    ASSERT_TRUE(lw_init_logging(null_fn, lw_logging_policy_t::dynamic_size, 0, lw_severity_level_t::info, NULL));
+    EXPECT_FALSE(lw_register_channel_manifest(&manifest));
+    lw_loggerf_t logger = lw_get_logger("Network");
+    ASSERT_TRUE(logger != nullptr);
+    EXPECT_EQ(std::string(logger->channel), "Network");
+}
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
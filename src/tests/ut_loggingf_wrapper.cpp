@@ -21,11 +21,15 @@
  *  \ingroup    loggingf_wrapper_tests
  */
 
+#include <algorithm>
+#include <chrono>
 #include <cstdarg>
 #include <cstdio>
 #include <iostream>
 #include <limits>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -289,6 +293,38 @@ TEST_F(loggingf, invalid_severity_level)
     EXPECT_FALSE(lw_can_log(-42));
 }
 
+/**
+ *  \test   Verification of the inline global level check outside of the
+ *      lifetime of the manager.
+ *  \see    lw_can_log, lw_init_logging, lw_deinit_logging
+ *
+ *  **Test logic description:**
+ *  `lw_can_log` reads the exported global level without a function call and
+ *  without checking the manager. The level must forbid every record while the
+ *  manager is not initialized.
+ *
+ *  **Steps to reproduce:**
+ *  -# Check the `EMERG` level before the initialization.
+ *  -# Initialize the subsystem with the `CRIT` level and check the `CRIT` and
+ *      `ERROR` levels.
+ *  -# Deinitialize the subsystem and check the `EMERG` level again.
+ *
+ *  \expected_result    Records are forbidden before the initialization and
+ *      after the deinitialization, and are filtered by the initial global level
+ *      in between.
+ */
+TEST_F(loggingf, severity_level_uninitialized)
+{
+    EXPECT_FALSE(lw_can_log(lw_severity_level_t::emerg));
+
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::fixed_size, 1, lw_severity_level_t::crit, NULL));
+    EXPECT_TRUE(lw_can_log(lw_severity_level_t::crit));
+    EXPECT_FALSE(lw_can_log(lw_severity_level_t::error));
+
+    lw_deinit_logging();
+    EXPECT_FALSE(lw_can_log(lw_severity_level_t::emerg));
+}
+
 /**
  *  \test   Resilience of the C-style API to invalid channel severity levels.
  *  \see    lw_set_logger_level, lw_can_channel_log
@@ -383,22 +419,20 @@ TEST_F(loggingf, channels)
  *  \see    lw_get_logger, lw_set_logger_level
  *
  *  **Test logic description:**
- *  Verifies operations with string length constraints on channel names. The test
- *  checks the library's behavior when creating loggers with an unacceptably long
- *  channel name.
+ *  Verifies operations with channel names which do not fit the inline key of
+ *  `LOG_CHANNEL_LEN` bytes. Such names are interned in full, so channels which
+ *  share the first `LOG_CHANNEL_LEN - 1` characters must stay independent.
  *
  *  **Steps to reproduce:**
  *  -# Create the `"123456789012345"` and `"12345678901234567890"` loggers.
- *  -# Set the `INFO` level for a non-existent/truncated channel named `"1234567890123456"`.
+ *  -# Set the `INFO` level for the channel named `"1234567890123456"`, which
+ *      shares the prefix of both names, and the `ERROR` level for the long one.
  *  -# Send a batch of `INFO` and `ERROR` logs to both original loggers.
  *
- *  \expected_result    An excessively long channel name is truncated to the
- *      maximum allowed limit. As a result, two loggers with different channel
- *      names end up with an identical name and become a single logger. The
- *      filter configurations applied via `lw_set_logger_level` affected both
- *      loggers, causing them to receive the last set logging level of `ERROR`.
- *      The `INFO` level messages were filtered out, and only two `ERROR` level
- *      lines reached the buffer.
+ *  \expected_result    The loggers are different, and the long one prints its
+ *      full name. The level of `"1234567890123456"` affects neither of them, so
+ *      the short channel keeps the default `DEBUG` level and only the `INFO`
+ *      line of the long channel is filtered out.
  */
 TEST_F(loggingf, long_channel_name)
 {
@@ -414,8 +448,10 @@ TEST_F(loggingf, long_channel_name)
     LOGF_ERROR(root_logger, "error log %d", 42);
     LOGF_ERROR(chan_logger, "error log %d", 42);
 
-    const std::string ethalon = "****-**-** **:**:**.*** [ERROR] 123456789012345: error log 42\n"
-                                "****-**-** **:**:**.*** [ERROR] 123456789012345: error log 42\n";
+    EXPECT_NE(root_logger, chan_logger);
+    const std::string ethalon = "****-**-** **:**:**.*** [INFO ] 123456789012345: info log 42\n"
+                                "****-**-** **:**:**.*** [ERROR] 123456789012345: error log 42\n"
+                                "****-**-** **:**:**.*** [ERROR] 12345678901234567890: error log 42\n";
     const std::string log = g_test_loggerf.str();
     EXPECT_TRUE(is_equal_logs(ethalon, log)) << "'" << ethalon << "' != '" << log << "'";
 }
@@ -477,22 +513,20 @@ TEST_F(loggingf, channels_dynamic)
  *  \see    lw_get_logger, lw_set_logger_level
  *
  *  **Test logic description:**
- *  Verifies operations with string length constraints on channel names. The test
- *  checks the library's behavior when creating loggers with an unacceptably long
- *  channel name.
+ *  Verifies operations with channel names which do not fit the inline key of
+ *  `LOG_CHANNEL_LEN` bytes. Such names are interned in full, so channels which
+ *  share the first `LOG_CHANNEL_LEN - 1` characters must stay independent.
  *
  *  **Steps to reproduce:**
  *  -# Create the `"123456789012345"` and `"12345678901234567890"` loggers.
- *  -# Set the `INFO` level for a non-existent/truncated channel named `"1234567890123456"`.
+ *  -# Set the `INFO` level for the channel named `"1234567890123456"`, which
+ *      shares the prefix of both names, and the `ERROR` level for the long one.
  *  -# Send a batch of `INFO` and `ERROR` logs to both original loggers.
  *
- *  \expected_result    An excessively long channel name is truncated to the
- *      maximum allowed limit. As a result, two loggers with different channel
- *      names end up with an identical name and become a single logger. The
- *      filter configurations applied via `lw_set_logger_level` affected both
- *      loggers, causing them to receive the last set logging level of `ERROR`.
- *      The `INFO` level messages were filtered out, and only two `ERROR` level
- *      lines reached the buffer.
+ *  \expected_result    The loggers are different, and the long one prints its
+ *      full name. The level of `"1234567890123456"` affects neither of them, so
+ *      the short channel keeps the default `DEBUG` level and only the `INFO`
+ *      line of the long channel is filtered out.
  */
 TEST_F(loggingf, long_channel_name_dynamic)
 {
@@ -508,8 +542,10 @@ TEST_F(loggingf, long_channel_name_dynamic)
     LOGF_ERROR(root_logger, "error log %d", 42);
     LOGF_ERROR(chan_logger, "error log %d", 42);
 
-    const std::string ethalon = "****-**-** **:**:**.*** [ERROR] 123456789012345: error log 42\n"
-                                "****-**-** **:**:**.*** [ERROR] 123456789012345: error log 42\n";
+    EXPECT_NE(root_logger, chan_logger);
+    const std::string ethalon = "****-**-** **:**:**.*** [INFO ] 123456789012345: info log 42\n"
+                                "****-**-** **:**:**.*** [ERROR] 123456789012345: error log 42\n"
+                                "****-**-** **:**:**.*** [ERROR] 12345678901234567890: error log 42\n";
     const std::string log = g_test_loggerf.str();
     EXPECT_TRUE(is_equal_logs(ethalon, log)) << "'" << ethalon << "' != '" << log << "'";
 }
@@ -567,6 +603,63 @@ TEST_F(loggingf, channels_limit)
     EXPECT_TRUE(is_equal_logs(ethalon, log)) << "'" << ethalon << "' != '" << log << "'";
 }
 
+/**
+ *  \test   Concurrent creation of channels in `fixed_size` mode.
+ *  \see    lw_init_logging, lw_get_logger
+ *
+ *  **Test logic description:**
+ *  The `fixed_size` table is lock-free: new channels claim slots concurrently
+ *  with lookups. Several threads request the same set of channels, which
+ *  exceeds the channel limit, in a different order at the same time.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the subsystem with the `fixed_size` policy and a limit of
+ *      `8` channels.
+ *  -# Start `4` threads, each of which requests the channels `"Channel_0"`
+ *      through `"Channel_15"` several times, starting from a different channel.
+ *  -# Compare the loggers obtained by the threads.
+ *
+ *  \expected_result    Exactly `8` channels are created. Each of them is
+ *      resolved to the same logger in all threads, the other channels are
+ *      rejected in all threads. Every created logger keeps its channel name.
+ */
+TEST_F(loggingf, channels_fixed_concurrent)
+{
+    constexpr size_t channel_count = 16;
+    constexpr size_t thread_count = 4;
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::fixed_size, channel_count / 2,
+                                lw_severity_level_t::crit, NULL));
+
+    std::vector<std::vector<lw_loggerf_t>> loggers(thread_count, std::vector<lw_loggerf_t>(channel_count));
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&loggers, t]() -> void {
+                                 for (size_t r = 0; r < 64; ++r) {
+                                     for (size_t i = 0; i < channel_count; ++i) {
+                                         const size_t ch = (i + t * 3) % channel_count;
+                                         const std::string ch_name = "Channel_" + std::to_string(ch);
+                                         loggers[t][ch] = lw_get_logger(ch_name.c_str());
+                                     }
+                                 }
+                             });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    size_t created = 0;
+    for (size_t i = 0; i < channel_count; ++i) {
+        for (size_t t = 1; t < thread_count; ++t) {
+            EXPECT_EQ(loggers[0][i], loggers[t][i]) << "channel " << i;
+        }
+        if (loggers[0][i] != nullptr) {
+            ++created;
+            EXPECT_EQ(std::string(loggers[0][i]->channel), "Channel_" + std::to_string(i));
+        }
+    }
+    EXPECT_EQ(created, channel_count / 2);
+}
+
 /**
  *  \test   Testing of the channel hash table in dynamic mode (`dynamic_size`).
  *  \see    lw_init_logging, lw_get_logger, lw_set_logger_level
@@ -623,6 +716,355 @@ TEST_F(loggingf, channels_dynamic_rehash)
     EXPECT_TRUE(is_equal_logs(ethalon, log)) << "'" << ethalon << "' != '" << log << "'";
 }
 
+/**
+ *  \test   Concurrent creation and lookup of channels during resizes of the
+ *      dynamic hash table (`dynamic_size`).
+ *  \see    lw_init_logging, lw_get_logger
+ *
+ *  **Test logic description:**
+ *  The dynamic table is resized incrementally while lookups stay lock-free.
+ *  Several threads create channels, forcing a series of resizes, and
+ *  simultaneously look up the channels created before.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system in `dynamic_size` mode with a base size of 2.
+ *  -# Start `4` threads, each of which creates the channels `"Channel_0"`
+ *      through `"Channel_511"`, starting from a different channel, and after
+ *      each creation looks up all channels it has created so far once again.
+ *  -# Compare the loggers obtained by the threads.
+ *
+ *  \expected_result    No lookup of an existing channel fails or returns
+ *      another logger. Each channel is resolved to the same logger in all
+ *      threads, and every logger keeps its channel name.
+ */
+TEST_F(loggingf, channels_dynamic_concurrent)
+{
+    constexpr size_t channel_count = 512;
+    constexpr size_t thread_count = 4;
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::dynamic_size, 2, lw_severity_level_t::crit, NULL));
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < channel_count; ++i) {
+        names.push_back("Channel_" + std::to_string(i));
+    }
+    std::vector<std::vector<lw_loggerf_t>> loggers(thread_count, std::vector<lw_loggerf_t>(channel_count));
+    std::vector<size_t> errors(thread_count, 0);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&names, &loggers, &errors, t]() -> void {
+                                 for (size_t i = 0; i < channel_count; ++i) {
+                                     const size_t ch = (i + t * channel_count / thread_count) % channel_count;
+                                     loggers[t][ch] = lw_get_logger(names[ch].c_str());
+                                     for (size_t j = 0; j <= i; j += 7) {
+                                         const size_t prev = (j + t * channel_count / thread_count) % channel_count;
+                                         if (lw_get_logger(names[prev].c_str()) != loggers[t][prev]) {
+                                             ++errors[t];
+                                         }
+                                     }
+                                 }
+                             });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (size_t t = 0; t < thread_count; ++t) {
+        EXPECT_EQ(errors[t], 0u) << "thread " << t;
+    }
+    for (size_t i = 0; i < channel_count; ++i) {
+        ASSERT_TRUE(loggers[0][i] != nullptr) << "channel " << i;
+        for (size_t t = 1; t < thread_count; ++t) {
+            EXPECT_EQ(loggers[0][i], loggers[t][i]) << "channel " << i;
+        }
+        EXPECT_EQ(std::string(loggers[0][i]->channel), names[i].substr(0, LOG_CHANNEL_LEN - 1));
+    }
+}
+
+/**
+ *  \test   Verification of the per-thread channel lookup cache.
+ *  \see    lw_get_logger, lw_deinit_logging
+ *
+ *  **Test logic description:**
+ *  `lw_get_logger` caches loggers by the address of the channel name. The
+ *  cache must not return a stale logger when the same buffer is reused for
+ *  another name or when the manager is reinitialized.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system in `dynamic_size` mode.
+ *  -# Look up `"Channel_1"` and `"Channel_2"` through the same character
+ *      buffer, rewriting its content between the lookups, twice.
+ *  -# Reinitialize the system in `fixed_size` mode and look up
+ *      `"Channel_1"` through the same buffer again.
+ *
+ *  \expected_result    Every lookup returns the logger of the current content
+ *      of the buffer, repeated lookups return the same logger, and after the
+ *      reinitialization the logger belongs to the new manager.
+ */
+TEST_F(loggingf, channels_lookup_cache)
+{
+    char name[LOG_CHANNEL_LEN] = "Channel_1";
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::dynamic_size, 2, lw_severity_level_t::crit, NULL));
+    lw_loggerf_t first_logger = lw_get_logger(name);
+    std::snprintf(name, sizeof(name), "Channel_2");
+    lw_loggerf_t second_logger = lw_get_logger(name);
+    ASSERT_TRUE(first_logger != nullptr && second_logger != nullptr);
+    EXPECT_NE(first_logger, second_logger);
+    EXPECT_EQ(std::string(second_logger->channel), "Channel_2");
+    EXPECT_EQ(lw_get_logger(name), second_logger);
+    std::snprintf(name, sizeof(name), "Channel_1");
+    EXPECT_EQ(lw_get_logger(name), first_logger);
+    lw_deinit_logging();
+
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::fixed_size, 1, lw_severity_level_t::crit, NULL));
+    lw_set_logger_level("Channel_1", lw_severity_level_t::error);
+    lw_loggerf_t logger = lw_get_logger(name);
+    ASSERT_TRUE(logger != nullptr);
+    EXPECT_EQ(std::string(logger->channel), "Channel_1");
+    EXPECT_EQ(logger->level, lw_severity_level_t::error);
+}
+
+/**
+ *  \test   Verification of the interning of channel names.
+ *  \see    lw_intern_channel, lw_get_interned_logger, lw_channel_name, lw_get_logger
+ *
+ *  **Test logic description:**
+ *  An interned name yields a token, which is the same for equal names and
+ *  refers to the logger of the channel. Names of any length are supported,
+ *  and long names count against the channel limit of the `fixed_size` policy.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system in `dynamic_size` mode.
+ *  -# Intern `"Root"` and a long name from different buffers, then intern
+ *      `100` long names, which share a long prefix, twice.
+ *  -# Look up a long and a `LOG_CHANNEL_LEN - 1` character name through the
+ *      same buffer, rewriting its content between the lookups.
+ *  -# Change the channel and the global levels of a long channel.
+ *  -# Reinitialize the system in `fixed_size` mode with a limit of `2`
+ *      channels and intern a short and two long names.
+ *
+ *  \expected_result    Equal names yield the same token and different names
+ *      different tokens, the logger of a token is the logger returned by
+ *      `lw_get_logger`, the levels apply to the long channel, and the channel
+ *      limit rejects the third channel.
+ */
+TEST_F(loggingf, interned_channels)
+{
+    const std::string prefix = "Long_channel_name_";
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::dynamic_size, 2, lw_severity_level_t::crit, "Root"));
+    const std::string root = "Root";
+    lw_channel_t root_token = lw_intern_channel(root.c_str());
+    ASSERT_TRUE(root_token != nullptr);
+    EXPECT_EQ(lw_intern_channel("Root"), root_token);
+    EXPECT_EQ(lw_get_interned_logger(root_token), lw_root_logger());
+    EXPECT_EQ(std::string(lw_channel_name(root_token)), "Root");
+
+    std::vector<lw_channel_t> tokens;
+    for (size_t i = 0; i < 100; ++i) {
+        tokens.push_back(lw_intern_channel((prefix + std::to_string(i)).c_str()));
+        ASSERT_TRUE(tokens.back() != nullptr);
+    }
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const std::string name = prefix + std::to_string(i);
+        EXPECT_EQ(lw_intern_channel(name.c_str()), tokens[i]);
+        EXPECT_EQ(std::string(lw_channel_name(tokens[i])), name);
+        lw_loggerf_t logger = lw_get_interned_logger(tokens[i]);
+        ASSERT_TRUE(logger != nullptr);
+        EXPECT_EQ(std::string(logger->channel), name);
+        EXPECT_EQ(lw_get_logger(name.c_str()), logger);
+    }
+    EXPECT_NE(lw_get_interned_logger(tokens[1]), lw_get_interned_logger(tokens[10]));
+
+    char name[32] = "Long_channel_name_1";
+    EXPECT_EQ(lw_get_logger(name), lw_get_interned_logger(tokens[1]));
+    std::snprintf(name, sizeof(name), "Long_channel_na");
+    lw_loggerf_t short_logger = lw_get_logger(name);
+    ASSERT_TRUE(short_logger != nullptr);
+    EXPECT_EQ(std::string(short_logger->channel), "Long_channel_na");
+    std::snprintf(name, sizeof(name), "Long_channel_name_2");
+    EXPECT_EQ(lw_get_logger(name), lw_get_interned_logger(tokens[2]));
+    std::snprintf(name, sizeof(name), "Long_channel_na");
+    EXPECT_EQ(lw_get_logger(name), short_logger);
+
+    lw_set_logger_level("Long_channel_name_1", lw_severity_level_t::error);
+    lw_loggerf_t logger = lw_get_interned_logger(tokens[1]);
+    EXPECT_EQ(logger->level, lw_severity_level_t::error);
+    EXPECT_EQ(logger->eff_level, lw_severity_level_t::crit);
+    lw_set_global_level(lw_severity_level_t::debug);
+    EXPECT_EQ(logger->eff_level, lw_severity_level_t::error);
+    EXPECT_EQ(lw_get_interned_logger(tokens[10])->eff_level, lw_severity_level_t::debug);
+    lw_deinit_logging();
+
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::fixed_size, 2, lw_severity_level_t::crit, NULL));
+    EXPECT_TRUE(lw_intern_channel("Root") != nullptr);
+    EXPECT_TRUE(lw_intern_channel("Long_channel_name_1") != nullptr);
+    EXPECT_TRUE(lw_intern_channel("Long_channel_name_2") == nullptr);
+    EXPECT_TRUE(lw_get_logger("Long_channel_name_2") == nullptr);
+    EXPECT_TRUE(lw_get_interned_logger(nullptr) == nullptr);
+}
+
+/**
+ *  \test   Consistency of the effective channel levels under concurrent level
+ *      changes.
+ *  \see    lw_set_global_level, lw_set_logger_level, lw_is_log_enabled
+ *
+ *  **Test logic description:**
+ *  The logging macros check only the effective level of a channel, which the
+ *  manager recomputes on every change of the global or the channel level and
+ *  on the creation of a channel. Concurrent changes must not leave a stale
+ *  effective level behind.
+ *
+ *  **Steps to reproduce:**
+ *  -# For both allocation policies, start a thread which switches the global
+ *      level and `2` threads which create channels and switch their levels.
+ *  -# After the threads are joined, compare the effective level of every
+ *      channel with the minimum of the global and the channel levels.
+ *
+ *  \expected_result    The effective level of every channel is equal to the
+ *      minimum of the final global level and the final channel level.
+ */
+TEST_F(loggingf, effective_level_concurrent)
+{
+    constexpr size_t channel_count = 64;
+    for (lw_logging_policy_t policy : {lw_logging_policy_t::fixed_size, lw_logging_policy_t::dynamic_size}) {
+        EXPECT_TRUE(lw_init_logging(log_fn, policy, channel_count, lw_severity_level_t::crit, NULL));
+
+        std::vector<std::string> names;
+        for (size_t i = 0; i < channel_count; ++i) {
+            names.push_back("Channel_" + std::to_string(i));
+        }
+        std::vector<std::thread> workers;
+        workers.emplace_back([]() -> void {
+                                 for (size_t i = 0; i < 2000; ++i) {
+                                     lw_set_global_level(lw_severity_level_t(i % (LVL_TRACE + 1)));
+                                 }
+                             });
+        for (size_t t = 0; t < 2; ++t) {
+            workers.emplace_back([&names, t]() -> void {
+                                     for (size_t i = 0; i < 2000; ++i) {
+                                         const std::string& name = names[(i * 7 + t) % names.size()];
+                                         lw_set_logger_level(name.c_str(), lw_severity_level_t((i + t) % (LVL_TRACE + 1)));
+                                     }
+                                 });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        const int global_lvl = lw_global_level();
+        for (const std::string& name : names) {
+            lw_loggerf_t logger = lw_get_logger(name.c_str());
+            ASSERT_TRUE(logger != nullptr);
+            EXPECT_EQ(logger->eff_level, std::min<int>(global_lvl, logger->level)) << name;
+        }
+        lw_deinit_logging();
+    }
+}
+
+/**
+ *  \test   Verification of the asynchronous backend with concurrent producers.
+ *  \see    lw_init_logging_async, lw_deinit_logging
+ *
+ *  **Test logic description:**
+ *  Records are formatted by the logging threads and written to the file by the
+ *  writer thread of the backend. Deinitialization must write all queued
+ *  records, and the records of each thread must keep their order.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system with the asynchronous backend writing to a
+ *      temporary file.
+ *  -# Start `4` threads, each of which writes `1000` records with its own
+ *      channel and a sequence number.
+ *  -# Deinitialize the system and read the file.
+ *
+ *  \expected_result    The file contains all `4000` records. The sequence
+ *      numbers of the records of each channel are consecutive.
+ */
+TEST_F(loggingf, async)
+{
+    constexpr size_t record_count = 1000;
+    constexpr size_t thread_count = 4;
+    FILE* p_file = std::tmpfile();
+    ASSERT_TRUE(p_file != nullptr);
+    EXPECT_TRUE(lw_init_logging_async(fileno(p_file), lw_logging_policy_t::dynamic_size, 0,
+                                      lw_severity_level_t::info, NULL));
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back([t]() -> void {
+                                 const std::string channel = "Thread_" + std::to_string(t);
+                                 lw_loggerf_t logger = lw_get_logger(channel.c_str());
+                                 for (size_t i = 0; i < record_count; ++i) {
+                                     LOGF_INFO(logger, "record %zu", i);
+                                 }
+                             });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    EXPECT_TRUE(lw_deinit_logging());
+
+    std::rewind(p_file);
+    std::vector<size_t> next(thread_count, 0);
+    char line[128];
+    size_t count = 0;
+    while (std::fgets(line, sizeof(line), p_file) != nullptr) {
+        size_t t = 0;
+        size_t i = 0;
+        ASSERT_EQ(std::sscanf(line, "%*s %*s [INFO ] Thread_%zu: record %zu", &t, &i), 2) << line;
+        ASSERT_LT(t, thread_count);
+        EXPECT_EQ(i, next[t]) << line;
+        next[t] = i + 1;
+        ++count;
+    }
+    EXPECT_EQ(count, record_count * thread_count);
+    std::fclose(p_file);
+}
+
+/**
+ *  \test   Verification of draining of the asynchronous backend.
+ *  \see    lw_init_logging_async, lw_flush_logging, lw_drain_logging
+ *
+ *  **Test logic description:**
+ *  `lw_drain_logging` must return only after the records logged before the
+ *  call are written, without waiting for the deinitialization.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system with the asynchronous backend writing to a
+ *      temporary file.
+ *  -# Write a record longer than the formatting buffer and a short one, wake
+ *      the writer by `lw_flush_logging` and call `lw_drain_logging`.
+ *  -# Read the file while the system is still initialized.
+ *
+ *  \expected_result    The drain succeeds, and the file already contains both
+ *      records in order, the long one intact.
+ */
+TEST_F(loggingf, async_drain)
+{
+    FILE* p_file = std::tmpfile();
+    ASSERT_TRUE(p_file != nullptr);
+    EXPECT_TRUE(lw_init_logging_async(fileno(p_file), lw_logging_policy_t::fixed_size, 1,
+                                      lw_severity_level_t::info, "Root"));
+
+    const std::string payload(LOG_ASYNC_LINE_LEN + 16, 'x');
+    LOGF_INFO(lw_root_logger(), "%s", payload.c_str());
+    LOGF_ERROR(lw_root_logger(), "error log %d", 42);
+    lw_flush_logging();
+    EXPECT_TRUE(lw_drain_logging());
+
+    std::rewind(p_file);
+    std::string log;
+    char buf[512];
+    for (size_t size = 0; (size = std::fread(buf, 1, sizeof(buf), p_file)) > 0;) {
+        log.append(buf, size);
+    }
+    const std::string ethalon = "****-**-** **:**:**.*** [INFO ] Root: " + payload + "\n"
+                                "****-**-** **:**:**.*** [ERROR] Root: error log 42\n";
+    EXPECT_TRUE(is_equal_logs(ethalon, log)) << "'" << ethalon << "' != '" << log << "'";
+
+    lw_deinit_logging();
+    std::fclose(p_file);
+}
+
 /**
  *  \test   Verification of the global logging level immutability (lock) mechanism.
  *  \see    lw_set_immutable_global_level, lw_set_global_level, lw_can_channel_log
@@ -708,6 +1150,83 @@ TEST_F(loggingf, default_severity_level)
     EXPECT_TRUE(is_equal_logs(ethalon, log)) << "'" << ethalon << "' != '" << log << "'";
 }
 
+/**
+ *  \test   Verification of the error-triggered verbosity bursts.
+ *  \see    lw_enable_burst, lw_disable_burst, LOGF_ERROR
+ *
+ *  **Test logic description:**
+ *  An error record lets its channel write the debug records for the window of
+ *  the burst, although the global level is `INFO`, after which the
+ *  housekeeping thread ends the burst. The level of the channel is not
+ *  changed. The channel does not burst again during the cooldown, and the
+ *  number of bursting channels is limited.
+ *
+ *  **Steps to reproduce:**
+ *  -# Initialize the system with the global `INFO` level, create the `"Root"`
+ *      and `"Net"` channels with the `WARN` level and enable the bursts to
+ *      `DEBUG` for 100 ms with a cooldown of 1000 ms and one bursting channel
+ *      at most.
+ *  -# Log a warning and an error to `"Root"`, then an error to `"Net"`, and log
+ *      debug messages to both channels.
+ *  -# Wait for the end of the burst, log an error and a debug message to
+ *      `"Root"`, then wait for the end of the cooldown and log an error again.
+ *  -# Disable the bursts and log a debug message to `"Root"`.
+ *
+ *  \expected_result    The warning does not start a burst. The error starts
+ *      the burst of `"Root"` only, so only its debug message is written, and
+ *      the level of the channel stays `WARN`. The burst ends after the window,
+ *      the error during the cooldown does not start it, the error after the
+ *      cooldown does, and disabling the bursts ends it.
+ */
+TEST_F(loggingf, burst)
+{
+    EXPECT_TRUE(lw_init_logging(log_fn, lw_logging_policy_t::fixed_size, 4, lw_severity_level_t::info, NULL));
+    lw_loggerf_t root_logger = lw_get_logger_dfl("Root", lw_severity_level_t::warning);
+    lw_loggerf_t net_logger = lw_get_logger_dfl("Net", lw_severity_level_t::warning);
+    ASSERT_TRUE(root_logger != nullptr && net_logger != nullptr);
+
+    const lw_burst_config_t cfg = {lw_severity_level_t::debug, 100, 1000, 1};
+    EXPECT_FALSE(lw_enable_burst(NULL));
+    ASSERT_TRUE(lw_enable_burst(&cfg));
+
+    LOGF_WARN(root_logger, "warning log %d", 42);
+    EXPECT_FALSE(lw_is_log_enabled(root_logger, lw_severity_level_t::debug));
+    LOGF_ERROR(root_logger, "error log %d", 42);
+    EXPECT_TRUE(lw_is_log_enabled(root_logger, lw_severity_level_t::debug));
+    EXPECT_FALSE(lw_can_channel_log(root_logger, lw_severity_level_t::debug));
+    EXPECT_FALSE(lw_is_log_enabled(root_logger, lw_severity_level_t::trace));
+    LOGF_ERROR(net_logger, "error log %d", 42);
+    EXPECT_FALSE(lw_is_log_enabled(net_logger, lw_severity_level_t::debug));
+    LOGF_DEBUG(root_logger, "debug log %d", 42);
+    LOGF_DEBUG(net_logger, "debug log %d", 42);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_FALSE(lw_is_log_enabled(root_logger, lw_severity_level_t::debug));
+    EXPECT_TRUE(lw_is_log_enabled(root_logger, lw_severity_level_t::warning));
+    LOGF_ERROR(root_logger, "error log %d", 43);
+    EXPECT_FALSE(lw_is_log_enabled(root_logger, lw_severity_level_t::debug));
+    LOGF_DEBUG(root_logger, "debug log %d", 43);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    LOGF_ERROR(root_logger, "error log %d", 44);
+    EXPECT_TRUE(lw_is_log_enabled(root_logger, lw_severity_level_t::debug));
+    LOGF_DEBUG(root_logger, "debug log %d", 44);
+    lw_disable_burst();
+    EXPECT_FALSE(lw_is_log_enabled(root_logger, lw_severity_level_t::debug));
+    EXPECT_TRUE(lw_is_log_enabled(root_logger, lw_severity_level_t::warning));
+    LOGF_DEBUG(root_logger, "debug log %d", 45);
+
+    const std::string ethalon = "****-**-** **:**:**.*** [WARN ] Root: warning log 42\n"
+                                "****-**-** **:**:**.*** [ERROR] Root: error log 42\n"
+                                "****-**-** **:**:**.*** [ERROR] Net: error log 42\n"
+                                "****-**-** **:**:**.*** [DEBUG] Root: debug log 42\n"
+                                "****-**-** **:**:**.*** [ERROR] Root: error log 43\n"
+                                "****-**-** **:**:**.*** [ERROR] Root: error log 44\n"
+                                "****-**-** **:**:**.*** [DEBUG] Root: debug log 44\n";
+    const std::string log = g_test_loggerf.str();
+    EXPECT_TRUE(is_equal_logs(ethalon, log)) << "'" << ethalon << "' != '" << log << "'";
+}
+
 /**
  *  \internal
  *  \brief  Main function.
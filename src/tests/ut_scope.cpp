@@ -0,0 +1,401 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Unit tests of the scope buffers.
+ *  \ingroup logging_wrapper_module
+ */
+
+#include <cstdarg>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "logging_wrapper/logging.h"
+
+namespace {
+
+using ::wstux::logging::kv;
+using ::wstux::logging::kv_record;
+using ::wstux::logging::log_scope;
+using ::wstux::logging::severity_level;
+
+/**
+ *  \internal
+ *  \brief  Mock stream logger.
+ */
+struct stream_logger final
+{
+    stream_logger(const std::string&) {}
+
+    template <typename T>
+    inline std::stringstream& operator<<(const T& val)
+    {
+        str_logger << val;
+        return str_logger;
+    }
+
+    std::stringstream str_logger;
+};
+
+/**
+ *  \internal
+ *  \brief  Mock printf-like logger.
+ */
+struct printf_logger final
+{
+    printf_logger(const std::string&) {}
+
+    void operator()(const char* p_fmt, ...)
+    {
+        char buf[16384];
+        va_list args;
+        va_start(args, p_fmt);
+        const int rc = vsnprintf(buf, sizeof(buf), p_fmt, args);
+        va_end(args);
+        str.append(buf, (rc < (int)sizeof(buf)) ? (size_t)rc : sizeof(buf) - 1);
+    }
+
+    std::string str;
+};
+
+/**
+ *  \internal
+ *  \brief  Mock logger, which receives binary structured records.
+ */
+struct binary_logger final
+{
+    binary_logger(const std::string&) {}
+
+    template <typename T>
+    inline binary_logger& operator<<(const T&) { return *this; }
+
+    void write_kv(const kv_record& record)
+    {
+        messages.emplace_back(record.message());
+        EXPECT_EQ(record.field_count(), 1u);
+    }
+
+    std::vector<std::string> messages;
+};
+
+/**
+ *  \internal
+ *  \brief  Test fixture, which sets a layout without a timestamp and the
+ *      global level `info`, and resets the logging subsystem after each test.
+ */
+class scope_fixture : public ::testing::Test
+{
+public:
+    virtual void SetUp() override
+    {
+        ::wstux::logging::manager::init();
+        ::wstux::logging::manager::set_global_level(severity_level::info);
+        ::wstux::logging::manager::set_layout("%l %c: ");
+    }
+
+    virtual void TearDown() override
+    {
+        ::wstux::logging::manager::deinit();
+    }
+};
+
+using scope = scope_fixture;
+
+} // <anonymous> namespace
+
+namespace wstux {
+namespace logging {
+
+template<> stream_logger make_logger<stream_logger>(const std::string& ch) { return stream_logger(ch); }
+template<> printf_logger make_logger<printf_logger>(const std::string& ch) { return printf_logger(ch); }
+template<> binary_logger make_logger<binary_logger>(const std::string& ch) { return binary_logger(ch); }
+
+} // namespace logging
+} // namespace wstux
+
+/**
+ *  \test   Verification of the records of a scope, which succeeds or fails.
+ *  \see    wstux::logging::log_scope
+ *
+ *  **Test logic description:**
+ *  The records filtered out by the level are kept by the active scope, if the
+ *  level of the scope permits it. They are discarded when the scope succeeds,
+ *  and written in the logged order when it fails, after the records which
+ *  passed the filters.
+ *
+ *  **Steps to reproduce:**
+ *  -# Log records of all macros at the levels `info`, `debug` and `trace`
+ *      within a scope of the level `debug`, which succeeds.
+ *  -# Repeat within a scope, which fails.
+ *
+ *  \expected_result    The `info` records are written at once. The `debug`
+ *      records are written only by the failed scope, in the logged order. The
+ *      `trace` records are never written.
+ */
+TEST_F(scope, fail)
+{
+    using logger_t = ::wstux::logging::logger<stream_logger>;
+    using loggerf_t = ::wstux::logging::logger<printf_logger>;
+
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Scope");
+    loggerf_t loggerf = ::wstux::logging::manager::get_logger<loggerf_t>("Scope");
+    std::stringstream& log = logger.get_logger().str_logger;
+    std::string& logf = loggerf.get_logger().str;
+
+    EXPECT_EQ(log_scope::current(), nullptr);
+    {
+        log_scope ok(severity_level::debug);
+        EXPECT_EQ(log_scope::current(), &ok);
+        LOG_INFO(logger, "info");
+        LOG_DEBUG(logger, "debug " << 1);
+        LOGF_DEBUG(loggerf, "debug %d", 2);
+        EXPECT_GT(ok.size(), 0u);
+        EXPECT_FALSE(ok.failed());
+    }
+    EXPECT_EQ(log_scope::current(), nullptr);
+    EXPECT_EQ(log.str(), "[INFO ] Scope: info\n");
+    EXPECT_EQ(logf, "");
+
+    log.str("");
+    {
+        log_scope failed(severity_level::debug);
+        LOG_DEBUG(logger, "stream " << std::hex << 255);
+        LOGF_DEBUG(loggerf, "printf %d", 1);
+        LOGFMT_DEBUG(logger, "fmt {}", 2);
+        LOG_KV(logger, DEBUG, "kv", kv("n", 3));
+        LOG_TRACE(logger, "trace");
+        LOG_DEBUG(logger, "stream " << 255);
+        LOG_INFO(logger, "info");
+        failed.fail();
+        EXPECT_TRUE(failed.failed());
+        EXPECT_EQ(log.str(), "[INFO ] Scope: info\n");
+    }
+    EXPECT_EQ(log.str(), "[INFO ] Scope: info\n"
+                         "[DEBUG] Scope: stream ff\n"
+                         "[DEBUG] Scope: fmt 2\n"
+                         "[DEBUG] Scope: kv n=3\n"
+                         "[DEBUG] Scope: stream 255\n");
+    EXPECT_EQ(logf, "[DEBUG] Scope: printf 1\n");
+}
+
+/**
+ *  \test   Verification of the scopes unwound by an exception.
+ *  \see    wstux::logging::log_scope::failed
+ *
+ *  **Test logic description:**
+ *  A scope, which is unwound by an exception thrown after its start, fails.
+ *  A scope, which starts and ends while an exception is handled, does not.
+ *
+ *  **Steps to reproduce:**
+ *  -# Throw an exception from a scope.
+ *  -# Start and end a scope in a destructor, which runs during unwinding.
+ *
+ *  \expected_result    The records of the first scope are written, the
+ *      records of the second scope are not.
+ */
+TEST_F(scope, exception)
+{
+    using logger_t = ::wstux::logging::logger<stream_logger>;
+
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Exception");
+    struct unwinder
+    {
+        ~unwinder()
+        {
+            log_scope inner(severity_level::debug);
+            LOG_DEBUG(logger, "destructor");
+        }
+        logger_t& logger;
+    };
+
+    try {
+        log_scope outer(severity_level::debug);
+        LOG_DEBUG(logger, "before throw");
+        unwinder guard{logger};
+        throw std::runtime_error("failure");
+    } catch (const std::exception&) {
+    }
+    EXPECT_EQ(logger.get_logger().str_logger.str(), "[DEBUG] Exception: before throw\n");
+}
+
+/**
+ *  \test   Verification of the nested scopes.
+ *  \see    wstux::logging::log_scope::flush
+ *
+ *  **Test logic description:**
+ *  A failed nested scope passes its records to the enclosing scope, and they
+ *  are written only if the enclosing scope fails too. A flush writes the
+ *  records of the enclosing scopes first.
+ *
+ *  **Steps to reproduce:**
+ *  -# Fail a nested scope within a scope, which succeeds.
+ *  -# Fail a nested scope within a scope, which fails.
+ *  -# Flush a nested scope and log more records.
+ *
+ *  \expected_result    Only the records of the second and the third steps are
+ *      written, in the logged order.
+ */
+TEST_F(scope, nested)
+{
+    using logger_t = ::wstux::logging::logger<stream_logger>;
+
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Nested");
+    const std::stringstream& log = logger.get_logger().str_logger;
+    {
+        log_scope outer;
+        LOG_DEBUG(logger, "outer 1");
+        {
+            log_scope inner;
+            LOG_DEBUG(logger, "inner 1");
+            inner.fail();
+        }
+        EXPECT_EQ(log_scope::current(), &outer);
+    }
+    EXPECT_EQ(log.str(), "");
+
+    {
+        log_scope outer;
+        LOG_DEBUG(logger, "outer 2");
+        {
+            log_scope inner;
+            LOG_DEBUG(logger, "inner 2");
+            inner.fail();
+        }
+        LOG_DEBUG(logger, "outer 3");
+        outer.fail();
+    }
+    EXPECT_EQ(log.str(), "[DEBUG] Nested: outer 2\n"
+                         "[DEBUG] Nested: inner 2\n"
+                         "[DEBUG] Nested: outer 3\n");
+
+    {
+        log_scope outer;
+        LOG_DEBUG(logger, "outer 4");
+        {
+            log_scope inner;
+            LOG_DEBUG(logger, "inner 4");
+            inner.flush();
+            EXPECT_EQ(outer.size(), 0u);
+            EXPECT_EQ(inner.size(), 0u);
+            LOG_DEBUG(logger, "inner 5");
+            inner.discard();
+            LOG_DEBUG(logger, "inner 6");
+        }
+    }
+    EXPECT_EQ(log.str(), "[DEBUG] Nested: outer 2\n"
+                         "[DEBUG] Nested: inner 2\n"
+                         "[DEBUG] Nested: outer 3\n"
+                         "[DEBUG] Nested: outer 4\n"
+                         "[DEBUG] Nested: inner 4\n");
+}
+
+/**
+ *  \test   Verification of the size limit of scopes.
+ *  \see    wstux::logging::log_scope::dropped
+ *
+ *  **Test logic description:**
+ *  The records beyond the size limit of a scope are dropped and counted, also
+ *  when a failed nested scope passes its records to the enclosing scope. A
+ *  record longer than a block of the arena is kept whole.
+ *
+ *  **Steps to reproduce:**
+ *  -# Log records into a scope with a limit of `256` bytes.
+ *  -# Fail a nested scope with a larger limit within it.
+ *  -# Log a record of `10000` characters into a scope with the default limit.
+ *
+ *  \expected_result    The size never exceeds the limit, the dropped records
+ *      are counted, and the long record is written whole.
+ */
+TEST_F(scope, limit)
+{
+    using loggerf_t = ::wstux::logging::logger<printf_logger>;
+
+    loggerf_t loggerf = ::wstux::logging::manager::get_logger<loggerf_t>("Limit");
+    std::string& logf = loggerf.get_logger().str;
+    {
+        log_scope outer(severity_level::debug, 256);
+        for (int i = 0; i < 10; ++i) {
+            LOGF_DEBUG(loggerf, "record %d", i);
+        }
+        EXPECT_LE(outer.size(), 256u);
+        EXPECT_GT(outer.dropped(), 0u);
+        const size_t dropped = outer.dropped();
+        {
+            log_scope inner(severity_level::debug, 4096);
+            LOGF_DEBUG(loggerf, "nested %d", 0);
+            inner.fail();
+        }
+        EXPECT_EQ(outer.dropped(), dropped + 1);
+        outer.fail();
+    }
+    EXPECT_EQ(logf.rfind("[DEBUG] Limit: record 0\n", 0), 0u);
+    EXPECT_EQ(logf.find("nested"), std::string::npos);
+
+    logf.clear();
+    const std::string long_str(10000, 'x');
+    {
+        log_scope scope;
+        LOGF_DEBUG(loggerf, "%s", long_str.c_str());
+        scope.fail();
+    }
+    EXPECT_EQ(logf, "[DEBUG] Limit: " + long_str + "\n");
+}
+
+/**
+ *  \test   Verification of the structured records kept in binary.
+ *  \see    LOG_KV, wstux::logging::log_scope
+ *
+ *  **Test logic description:**
+ *  A backend with a `write_kv` member receives the kept structured records
+ *  in binary when the scope fails.
+ *
+ *  **Steps to reproduce:**
+ *  -# Log structured records at the level `debug` within a failed scope.
+ *
+ *  \expected_result    The backend receives the records in the logged order.
+ */
+TEST_F(scope, binary)
+{
+    using logger_t = ::wstux::logging::logger<binary_logger>;
+
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Binary");
+    {
+        log_scope scope;
+        LOG_KV(logger, DEBUG, "first", kv("n", 1));
+        LOG_KV(logger, DEBUG, "second", kv("n", 2));
+        EXPECT_TRUE(logger.get_logger().messages.empty());
+        scope.fail();
+    }
+    EXPECT_EQ(logger.get_logger().messages, (std::vector<std::string>{"first", "second"}));
+}
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
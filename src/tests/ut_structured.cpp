@@ -0,0 +1,423 @@
+/*
+ * logging_wrapper
+ * Copyright (C) 2025  Chistyakov Alexander
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/**
+ *  \file
+ *  \brief  Structured logging unit tests.
+ *  \ingroup    logging_wrapper_tests
+ */
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "logging_wrapper/logging.h"
+#include "logging_wrapper/details/escape.h"
+
+namespace {
+
+using ::wstux::logging::kv;
+using ::wstux::logging::kv_format;
+using ::wstux::logging::kv_record;
+using ::wstux::logging::kv_type;
+using ::wstux::logging::kv_value;
+
+/**
+ *  \internal
+ *  \brief  Mock stream logger, which receives rendered records.
+ */
+struct text_logger final
+{
+    text_logger(const std::string&) {}
+
+    template <typename T>
+    inline std::stringstream& operator<<(const T& val)
+    {
+        str_logger << val;
+        return str_logger;
+    }
+
+    std::stringstream str_logger;
+};
+
+/**
+ *  \internal
+ *  \brief  Mock logger, which receives binary records and keeps their copies
+ *      to render them later.
+ */
+struct binary_logger final
+{
+    binary_logger(const std::string&) {}
+
+    template <typename T>
+    inline binary_logger& operator<<(const T&) { return *this; }
+
+    void write_kv(const kv_record& record)
+    {
+        const uint8_t* p_data = static_cast<const uint8_t*>(record.data());
+        records.emplace_back(p_data, p_data + record.size());
+    }
+
+    std::vector<std::vector<uint8_t>> records;
+};
+
+/**
+ *  \internal
+ *  \brief  Renders a binary record.
+ */
+std::string render(kv_format fmt, const std::vector<uint8_t>& bytes)
+{
+    char buf[1024];
+    wstux::logging::text_buffer out(buf);
+    wstux::logging::render_kv(out, fmt, kv_record(bytes.data(), bytes.size()));
+    return std::string(out.view());
+}
+
+/**
+ *  \internal
+ *  \brief  Replaces the digits of the timestamp of a rendered record by `*`.
+ */
+std::string mask_timestamp(std::string str, size_t pos)
+{
+    for (size_t i = pos; i < pos + 26 && i < str.size(); ++i) {
+        if (str[i] >= '0' && str[i] <= '9') {
+            str[i] = '*';
+        }
+    }
+    return str;
+}
+
+bool is_equal_logs(const std::string& ethalon, const std::string& log)
+{
+    if (ethalon.size() != log.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < ethalon.size(); ++i) {
+        if (ethalon[i] != '*' && ethalon[i] != log[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ *  \internal
+ *  \brief  Test fixture, which resets the logging subsystem after each test.
+ */
+class structured_fixture : public ::testing::Test
+{
+public:
+    virtual void SetUp() override
+    {
+        ::wstux::logging::manager::init();
+        ::wstux::logging::manager::set_global_level(::wstux::logging::severity_level::debug);
+    }
+
+    virtual void TearDown() override
+    {
+        ::wstux::logging::set_kv_format(kv_format::text);
+        ::wstux::logging::manager::deinit();
+    }
+};
+
+using structured = structured_fixture;
+
+} // <anonymous> namespace
+
+namespace wstux {
+namespace logging {
+
+template<> text_logger make_logger<text_logger>(const std::string& ch) { return text_logger(ch); }
+template<> binary_logger make_logger<binary_logger>(const std::string& ch) { return binary_logger(ch); }
+
+} // namespace logging
+} // namespace wstux
+
+/**
+ *  \test   Verification of the binary encoding of structured records.
+ *  \see    LOG_KV, wstux::logging::kv, wstux::logging::kv_record
+ *
+ *  **Test logic description:**
+ *  A backend with a `write_kv` member receives the binary record, which keeps
+ *  the level, the channel, the message and the typed values of the fields.
+ *
+ *  **Steps to reproduce:**
+ *  -# Log a record with fields of all types into a binary logger.
+ *  -# Log a record filtered out by the level.
+ *  -# Decode the fields of the received record.
+ *
+ *  \expected_result    One record is received, and its fields have the types
+ *      and the values which were logged.
+ */
+TEST_F(structured, encoding)
+{
+    using logger_t = ::wstux::logging::logger<binary_logger>;
+
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Binary");
+    const std::string path = "/index";
+    LOG_KV(logger, INFO, "request done", kv("ms", 12.5), kv("code", 200), kv("size", (uint16_t)512),
+           kv("ok", true), kv("path", path), kv("min", std::numeric_limits<int64_t>::min()), kv("c", 'x'));
+    LOG_KV(logger, TRACE, "filtered", kv("n", 1));
+
+    const std::vector<std::vector<uint8_t>>& records = logger.get_logger().records;
+    ASSERT_EQ(records.size(), 1u);
+    const kv_record record(records[0].data(), records[0].size());
+    EXPECT_EQ(record.level(), ::wstux::logging::severity_level::info);
+    EXPECT_EQ(record.channel(), "Binary");
+    EXPECT_EQ(record.message(), "request done");
+    EXPECT_FALSE(record.truncated());
+    ASSERT_EQ(record.field_count(), 7u);
+
+    std::vector<std::string> keys;
+    std::vector<kv_value> values;
+    record.for_each_field([&](std::string_view key, const kv_value& value) -> void {
+                              keys.emplace_back(key);
+                              values.push_back(value);
+                          });
+    EXPECT_EQ(keys, (std::vector<std::string>{"ms", "code", "size", "ok", "path", "min", "c"}));
+    EXPECT_EQ(values[0].type, kv_type::f64);
+    EXPECT_EQ(values[0].f, 12.5);
+    EXPECT_EQ(values[1].type, kv_type::i64);
+    EXPECT_EQ(values[1].i, 200);
+    EXPECT_EQ(values[2].type, kv_type::u64);
+    EXPECT_EQ(values[2].u, 512u);
+    EXPECT_EQ(values[3].type, kv_type::boolean);
+    EXPECT_TRUE(values[3].b);
+    EXPECT_EQ(values[4].type, kv_type::str);
+    EXPECT_EQ(values[4].s, "/index");
+    EXPECT_EQ(values[5].i, std::numeric_limits<int64_t>::min());
+    EXPECT_EQ(values[6].s, "x");
+}
+
+/**
+ *  \test   Verification of the rendering of structured records.
+ *  \see    wstux::logging::render_kv, wstux::logging::set_kv_format
+ *
+ *  **Test logic description:**
+ *  A binary record is rendered as text, logfmt and JSON after it is logged.
+ *  Strings are quoted and escaped where the format requires it. Backends
+ *  without `write_kv` receive the record rendered in the format of the
+ *  manager, with the head of the layout in the text format.
+ *
+ *  **Steps to reproduce:**
+ *  -# Log a record with a string, which contains a quote, a new line and a
+ *      control character, into a binary logger and render it in every format.
+ *  -# Log records into a stream logger in the text and the JSON formats.
+ *
+ *  \expected_result    The rendered records are equal to their reference
+ *      templates, where `*` replaces the digits of the timestamps.
+ */
+TEST_F(structured, rendering)
+{
+    using binary_logger_t = ::wstux::logging::logger<binary_logger>;
+    using text_logger_t = ::wstux::logging::logger<text_logger>;
+
+    binary_logger_t binary = ::wstux::logging::manager::get_logger<binary_logger_t>("Binary");
+    LOG_KV(binary, WARN, "say \"hi\"", kv("text", "a b\n\x01"), kv("n", -3), kv("ratio", 0.1), kv("ok", false));
+    ASSERT_EQ(binary.get_logger().records.size(), 1u);
+    const std::vector<uint8_t>& bytes = binary.get_logger().records[0];
+
+    EXPECT_EQ(render(kv_format::text, bytes), "say \"hi\" text=\"a b\\n\\u0001\" n=-3 ratio=0.1 ok=false");
+    const std::string logfmt = render(kv_format::logfmt, bytes);
+    EXPECT_TRUE(is_equal_logs("ts=****-**-**T**:**:**.******Z level=warning channel=Binary msg=\"say \\\"hi\\\"\" "
+                              "text=\"a b\\n\\u0001\" n=-3 ratio=0.1 ok=false", mask_timestamp(logfmt, 3))) << logfmt;
+    const std::string json = render(kv_format::json, bytes);
+    EXPECT_TRUE(is_equal_logs("{\"ts\":\"****-**-**T**:**:**.******Z\",\"level\":\"warning\",\"channel\":\"Binary\","
+                              "\"msg\":\"say \\\"hi\\\"\",\"text\":\"a b\\n\\u0001\",\"n\":-3,\"ratio\":0.1,\"ok\":false}",
+                              mask_timestamp(json, 7))) << json;
+
+    text_logger_t text = ::wstux::logging::manager::get_logger<text_logger_t>("Text");
+    LOG_KV(text, ERROR, "failed", kv("code", 500u));
+    ::wstux::logging::set_kv_format(kv_format::json);
+    LOG_KV(text, ERROR, "failed", kv("inf", std::numeric_limits<double>::infinity()));
+    const std::string log = text.get_logger().str_logger.str();
+    EXPECT_TRUE(is_equal_logs("****-**-** **:**:**.*** [ERROR] Text: failed code=500\n"
+                              "{\"ts\":\"****-**-**T**:**:**.******Z\",\"level\":\"error\",\"channel\":\"Text\","
+                              "\"msg\":\"failed\",\"inf\":null}\n",
+                              mask_timestamp(log, log.find('\n') + 8))) << log;
+}
+
+/**
+ *  \test   Verification of the truncation of structured records.
+ *  \see    LOG_KV, LOG_RECORD_LEN
+ *
+ *  **Test logic description:**
+ *  A record longer than the buffer keeps the fields which fit, a string which
+ *  does not fit is shortened, and the record is marked as truncated.
+ *
+ *  **Steps to reproduce:**
+ *  -# Log a record with a string field longer than \ref LOG_RECORD_LEN and a
+ *      number field after it into a binary logger.
+ *
+ *  \expected_result    The record fits into the buffer, is truncated, and has
+ *      only the string field.
+ */
+TEST_F(structured, truncation)
+{
+    using logger_t = ::wstux::logging::logger<binary_logger>;
+
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Binary");
+    const std::string long_text(LOG_RECORD_LEN, 'x');
+    LOG_KV(logger, INFO, "long", kv("text", long_text), kv("n", 1));
+
+    ASSERT_EQ(logger.get_logger().records.size(), 1u);
+    const std::vector<uint8_t>& bytes = logger.get_logger().records[0];
+    const kv_record record(bytes.data(), bytes.size());
+    EXPECT_LE(bytes.size(), (size_t)LOG_RECORD_LEN);
+    EXPECT_TRUE(record.truncated());
+    EXPECT_EQ(record.field_count(), 1u);
+}
+
+/**
+ *  \test   Verification of the rendering of invalid keys and truncated records.
+ *  \see    wstux::logging::render_kv
+ *
+ *  **Test logic description:**
+ *  The keys of the `text` and `logfmt` formats cannot be quoted, so the
+ *  characters which would break the `key=value` pair are replaced. A JSON
+ *  record, which does not fit into the output buffer or whose fields were
+ *  dropped on encoding, is closed and marked as truncated.
+ *
+ *  **Steps to reproduce:**
+ *  -# Log a record with the keys `"a b"`, `"x=y"` and `""` into a binary logger
+ *      and render it as text and logfmt.
+ *  -# Render a record with two fields as JSON into buffers which cut it inside
+ *      the second field, and into a buffer which cuts it inside the head.
+ *  -# Log a record whose fields do not fit into the record buffer and render
+ *      it as JSON.
+ *
+ *  \expected_result    The keys are written as `a_b`, `x_y` and `_`. The cut
+ *      JSON records end after the first field with `"truncated":true}`, the
+ *      record cut inside the head is `{"truncated":true}`, and the record with
+ *      dropped fields is marked too.
+ */
+TEST_F(structured, keys_and_truncation)
+{
+    using logger_t = ::wstux::logging::logger<binary_logger>;
+
+    logger_t logger = ::wstux::logging::manager::get_logger<logger_t>("Binary");
+    LOG_KV(logger, INFO, "m", kv("a b", 1), kv("x=y", 2), kv("", 3));
+    LOG_KV(logger, INFO, "m", kv("first", 1), kv("second", "a long string value"));
+    LOG_KV(logger, INFO, "long", kv("text", std::string(LOG_RECORD_LEN, 'x')), kv("n", 1));
+    ASSERT_EQ(logger.get_logger().records.size(), 3u);
+    const std::vector<uint8_t>& keys = logger.get_logger().records[0];
+    const std::vector<uint8_t>& fields = logger.get_logger().records[1];
+
+    EXPECT_EQ(render(kv_format::text, keys), "m a_b=1 x_y=2 _=3");
+    const std::string logfmt = render(kv_format::logfmt, keys);
+    EXPECT_NE(logfmt.find(" msg=m a_b=1 x_y=2 _=3"), std::string::npos) << logfmt;
+
+    const std::string json = render(kv_format::json, fields);
+    const std::string head = json.substr(0, json.find(",\"first\""));
+    for (const size_t size : {json.size() - 4, head.size() + 30}) {
+        char buf[1024];
+        wstux::logging::text_buffer out(buf, size + 1);
+        wstux::logging::render_kv(out, kv_format::json, kv_record(fields.data(), fields.size()));
+        EXPECT_EQ(std::string(out.view()), head + ",\"first\":1,\"truncated\":true}") << size;
+    }
+    char small_buf[64];
+    wstux::logging::text_buffer small_out(small_buf);
+    wstux::logging::render_kv(small_out, kv_format::json, kv_record(fields.data(), fields.size()));
+    EXPECT_EQ(std::string(small_out.view()), "{\"truncated\":true}");
+
+    const std::string dropped = render(kv_format::json, logger.get_logger().records[2]);
+    EXPECT_EQ(dropped.substr(dropped.size() - 17), "\"truncated\":true}") << dropped;
+}
+
+/**
+ *  \test   Verification of the vectorized escaping of strings.
+ *  \see    wstux::logging::details::put_escaped,
+ *      wstux::logging::details::find_json_special,
+ *      wstux::logging::details::needs_logfmt_quotes
+ *
+ *  **Test logic description:**
+ *  The scans of the selected implementation (AVX2, SSE2, NEON or scalar) must
+ *  give the same results as the byte-by-byte references for special
+ *  characters at any position of a block, in the tail after the last block,
+ *  and for bytes above `0x7F`, which are not special.
+ *
+ *  **Steps to reproduce:**
+ *  -# For lengths from 0 to 100, put every special character and a byte above
+ *      `0x7F` at every position of a clean string.
+ *  -# Generate random strings of random bytes with a varying density of
+ *      special characters.
+ *  -# Compare the scans and the escaped texts with the references.
+ *
+ *  \expected_result    The results are equal.
+ */
+TEST(escaping, reference)
+{
+    namespace details = ::wstux::logging::details;
+
+    const auto check = [](const std::string& str) -> void {
+        EXPECT_EQ(details::find_json_special(str.data(), str.size()),
+                  details::find_json_special_scalar(str.data(), str.size()));
+        EXPECT_EQ(details::needs_logfmt_quotes(str), details::needs_logfmt_quotes_scalar(str));
+        static char buf[8 * 1024];
+        static char ref_buf[8 * 1024];
+        wstux::logging::text_buffer out(buf);
+        wstux::logging::text_buffer ref(ref_buf);
+        details::put_escaped(out, str);
+        details::put_escaped_scalar(ref, str);
+        EXPECT_EQ(out.view(), ref.view());
+    };
+
+    const std::string specials = std::string("\"\\\n\t= \x7F\x80\xFF", 9) + std::string(1, '\0');
+    for (size_t len = 0; len <= 100; ++len) {
+        const std::string clean(len, 'a');
+        check(clean);
+        for (size_t pos = 0; pos < len; ++pos) {
+            for (char c : specials) {
+                std::string str = clean;
+                str[pos] = c;
+                check(str);
+            }
+        }
+    }
+
+    std::mt19937 rng(2025);
+    for (int i = 0; i < 20000; ++i) {
+        const size_t len = rng() % 300;
+        const unsigned density = 1 + rng() % 64;
+        std::string str(len, 'x');
+        for (char& c : str) {
+            c = (rng() % density == 0) ? (char)(rng() % 256) : (char)('a' + rng() % 26);
+        }
+        check(str);
+    }
+
+    char buf[64];
+    wstux::logging::text_buffer out(buf);
+    details::put_escaped(out, std::string("tab\tquote\"nul", 13) + std::string(1, '\0'));
+    EXPECT_EQ(out.view(), "tab\\tquote\\\"nul\\u0000");
+    EXPECT_STRNE(details::escape_impl_name(), "");
+}
+
+/**
+ *  \internal
+ *  \brief  Main function.
+ */
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}